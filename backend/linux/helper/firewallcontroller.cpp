@@ -1,6 +1,7 @@
 #include "firewallcontroller.h"
 
 #include <algorithm>
+#include <arpa/inet.h>
 #include <fcntl.h>
 #include <fstream>
 #include <sstream>
@@ -34,6 +35,8 @@ bool FirewallController::enable(bool ipv6, const std::string &rules)
     if (ipv6) {
         Utils::executeCommand("ip6tables-restore", {"-n", "/etc/windscribe/rules.v6"});
     } else {
+        // the sets must be restored along with the rules on reboot
+        saveIpSets();
         Utils::executeCommand("iptables-restore", {"-n", "/etc/windscribe/rules.v4"});
     }
 
@@ -71,6 +74,14 @@ void FirewallController::disable()
 {
     Utils::executeCommand("rm", {"-f", "/etc/windscribe/rules.v4"});
     Utils::executeCommand("rm", {"-f", "/etc/windscribe/rules.v6"});
+    Utils::executeCommand("rm", {"-f", kIpSetsFile});
+    // the rules referencing the set are removed by the client before
+    destroyIpSet(kWhitelistSet);
+}
+
+bool FirewallController::setWhitelistIps(const std::vector<std::string> &ips)
+{
+    return updateIpSet(kWhitelistSet, ips);
 }
 
 void FirewallController::setSplitTunnelingEnabled(bool isConnected, bool isEnabled, bool isExclude, const std::string &defaultAdapter)
@@ -87,10 +98,9 @@ void FirewallController::setSplitTunnelingEnabled(bool isConnected, bool isEnabl
 
 void FirewallController::removeExclusiveIpRules()
 {
-    for (auto ip : splitTunnelIps_) {
-        Utils::executeCommand("iptables", {"-D", "windscribe_input", "-s", ip.c_str(), "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
-        Utils::executeCommand("iptables", {"-D", "windscribe_output", "-d", ip.c_str(), "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
-    }
+    Utils::executeCommand("iptables", {"-D", "windscribe_input", "-m", "set", "--match-set", kSplitTunnelSet, "src", "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
+    Utils::executeCommand("iptables", {"-D", "windscribe_output", "-m", "set", "--match-set", kSplitTunnelSet, "dst", "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
+    destroyIpSet(kSplitTunnelSet);
 }
 
 void FirewallController::removeInclusiveIpRules()
@@ -164,18 +174,10 @@ void FirewallController::setSplitTunnelIpExceptions(const std::vector<std::strin
     if (splitTunnelExclude_) {
         removeInclusiveIpRules();
 
-        // For exclusive, remove rules for addresses no longer in "ips"
-        for (auto ip : splitTunnelIps_) {
-            if (std::find(ips.begin(), ips.end(), ip) == ips.end()) {
-                Utils::executeCommand("iptables", {"-D", "windscribe_input", "-s", ip.c_str(), "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
-                Utils::executeCommand("iptables", {"-D", "windscribe_output", "-d", ip.c_str(), "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
-            }
-        }
-
-        // Add rules for new IPs
-        for (auto ip : ips) {
-            addRule({"windscribe_input", "-s", ip.c_str(), "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
-            addRule({"windscribe_output", "-d", ip.c_str(), "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
+        // For exclusive, the addresses are kept in a set, only the changed addresses are added/removed
+        if (updateIpSet(kSplitTunnelSet, ips)) {
+            addRule({"windscribe_input", "-m", "set", "--match-set", kSplitTunnelSet, "src", "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
+            addRule({"windscribe_output", "-m", "set", "--match-set", kSplitTunnelSet, "dst", "-j", "ACCEPT", "-m", "comment", "--comment", kTag});
         }
     } else {
         removeExclusiveIpRules();
@@ -188,6 +190,133 @@ void FirewallController::setSplitTunnelIpExceptions(const std::vector<std::strin
     splitTunnelIps_ = ips;
 }
 
+// The entries go verbatim into the script of "ipset restore", so they are rebuilt from the parsed address and prefix
+// instead of being copied from the input. hash:net takes both addresses and subnets.
+bool FirewallController::toIpSetEntry(const std::string &ip, std::string &outEntry)
+{
+    const size_t slash = ip.find('/');
+    struct in_addr addr;
+    if (inet_pton(AF_INET, ip.substr(0, slash).c_str(), &addr) != 1) {
+        return false;
+    }
+
+    char addrStr[INET_ADDRSTRLEN];
+    if (!inet_ntop(AF_INET, &addr, addrStr, sizeof(addrStr))) {
+        return false;
+    }
+    outEntry = addrStr;
+
+    if (slash == std::string::npos) {
+        return true;
+    }
+
+    const std::string prefixStr = ip.substr(slash + 1);
+    if (prefixStr.empty() || prefixStr.size() > 2 || !std::all_of(prefixStr.begin(), prefixStr.end(), ::isdigit)) {
+        return false;
+    }
+    // hash:net does not take a zero prefix, the whole restore would fail on it
+    const int prefix = std::stoi(prefixStr);
+    if (prefix < 1 || prefix > 32) {
+        return false;
+    }
+    outEntry += "/" + std::to_string(prefix);
+    return true;
+}
+
+bool FirewallController::updateIpSet(const std::string &name, const std::vector<std::string> &ips)
+{
+    std::set<std::string> newIps;
+    for (const auto &ip : ips) {
+        std::string entry;
+        if (toIpSetEntry(ip, entry)) {
+            newIps.insert(entry);
+        } else {
+            Logger::instance().out("Skipped invalid ipset address: %s", ip.c_str());
+        }
+    }
+
+    std::stringstream script;
+    auto it = ipSets_.find(name);
+    if (it == ipSets_.end()) {
+        // the set may be left from a previous run with unknown contents, fill a new set and swap it in atomically
+        const std::string tmpName = name + "_tmp";
+        script << "create " << name << " hash:net family inet -exist\n";
+        script << "create " << tmpName << " hash:net family inet -exist\n";
+        script << "flush " << tmpName << "\n";
+        for (const auto &ip : newIps) {
+            script << "add " << tmpName << " " << ip << "\n";
+        }
+        script << "swap " << tmpName << " " << name << "\n";
+        script << "destroy " << tmpName << "\n";
+    } else {
+        // update the set incrementally
+        for (const auto &ip : it->second) {
+            if (newIps.find(ip) == newIps.end()) {
+                script << "del " << name << " " << ip << " -exist\n";
+            }
+        }
+        for (const auto &ip : newIps) {
+            if (it->second.find(ip) == it->second.end()) {
+                script << "add " << name << " " << ip << " -exist\n";
+            }
+        }
+        if (script.tellp() == 0) {
+            return true;
+        }
+    }
+
+    const std::string filename = "/etc/windscribe/" + name + ".ipset";
+    std::ofstream file(filename, std::ios::trunc);
+    file << script.str();
+    file.close();
+    if (!file) {
+        Logger::instance().out("Could not write ipset %s", name.c_str());
+        return false;
+    }
+
+    std::string output;
+    int ret = Utils::executeCommand("ipset restore < " + filename, {}, &output);
+    Utils::executeCommand("rm", {"-f", filename});
+    if (ret != 0) {
+        Logger::instance().out("Could not update ipset %s: %s", name.c_str(), output.c_str());
+        ipSets_.erase(name);
+        return false;
+    }
+
+    ipSets_[name] = std::move(newIps);
+    saveIpSets();
+    return true;
+}
+
+void FirewallController::destroyIpSet(const std::string &name)
+{
+    if (ipSets_.erase(name)) {
+        Utils::executeCommand("ipset", {"destroy", name});
+        saveIpSets();
+    }
+}
+
+void FirewallController::saveIpSets()
+{
+    // nothing to restore on reboot if the firewall rules are not saved
+    if (!Utils::isFileExists("/etc/windscribe/rules.v4")) {
+        return;
+    }
+
+    const std::string tmpFilename = kIpSetsFile + ".tmp";
+    std::string cmd = ": > " + tmpFilename;
+    for (const auto &it : ipSets_) {
+        cmd += " && ipset save " + it.first + " >> " + tmpFilename;
+    }
+    cmd += " && mv -f " + tmpFilename + " " + kIpSetsFile;
+
+    std::string output;
+    if (Utils::executeCommand(cmd, {}, &output) != 0) {
+        Logger::instance().out("Could not save ipsets: %s", output.c_str());
+        Utils::executeCommand("rm", {"-f", tmpFilename});
+    }
+}
+
 void FirewallController::addRule(const std::vector<std::string> &args)
 {
     std::vector<std::string> checkArgs = args;
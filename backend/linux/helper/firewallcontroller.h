@@ -1,12 +1,20 @@
 #pragma once
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
+#include "../../posix_common/helper_commands.h"
 
 class FirewallController
 {
 public:
     inline static const std::string kTag = "Windscribe client rule";
+    // ipsets referenced by the rules, a lookup in a hashed set does not depend on the number of IPs
+    inline static const std::string kWhitelistSet = HELPER_FIREWALL_IPSET;
+    inline static const std::string kSplitTunnelSet = "windscribe_split_ips";
+    // the saved rules reference the ipsets, which live only in memory, so the sets are saved next to them
+    inline static const std::string kIpSetsFile = "/etc/windscribe/rules.ipset";
 
     static FirewallController & instance()
     {
@@ -18,6 +26,7 @@ public:
     void disable();
     bool enabled(const std::string &tag = kTag);
     void getRules(bool ipv6, std::string *outRules);
+    bool setWhitelistIps(const std::vector<std::string> &ips);
 
     void setSplitTunnelingEnabled(
         bool isConnected,
@@ -37,6 +46,7 @@ private:
     std::string defaultAdapter_;
     std::string prevAdapter_;
     std::string netclassid_;
+    std::map<std::string, std::set<std::string>> ipSets_;   // the contents of the ipsets created by this process
 
     void removeExclusiveIpRules();
     void removeInclusiveIpRules();
@@ -44,4 +54,8 @@ private:
     void removeInclusiveAppRules();
     void setSplitTunnelAppExceptions();
     void addRule(const std::vector<std::string> &args);
+    bool updateIpSet(const std::string &name, const std::vector<std::string> &ips);
+    static bool toIpSetEntry(const std::string &ip, std::string &outEntry);
+    void destroyIpSet(const std::string &name);
+    void saveIpSets();
 };
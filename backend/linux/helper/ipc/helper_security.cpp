@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <limits.h>
 #include <fstream>
 #include <grp.h>
@@ -9,11 +10,52 @@
 
 #include "../../../../client/common/utils/executable_signature/executable_signature.h"
 
-bool HelperSecurity::verifySignature()
+#define WINDSCRIBE_EXE_PATH "/opt/windscribe/Windscribe"
+
+bool HelperSecurity::verifySignature(const void *connection, const struct ucred &peerCred)
+{
+#if defined(USE_SIGNATURE_CHECK)
+    struct stat st;
+    if (stat(WINDSCRIBE_EXE_PATH, &st) != 0) {
+        Logger::instance().out("Could not stat %s (%d)", WINDSCRIBE_EXE_PATH, errno);
+        verifiedConnections_.erase(connection);
+        return false;
+    }
+
+    auto it = verifiedConnections_.find(connection);
+    if (it != verifiedConnections_.end()) {
+        const VerifiedConnection &v = it->second;
+        if (v.peerCred.pid == peerCred.pid && v.peerCred.uid == peerCred.uid && v.peerCred.gid == peerCred.gid &&
+            v.dev == st.st_dev && v.ino == st.st_ino &&
+            v.mtime.tv_sec == st.st_mtim.tv_sec && v.mtime.tv_nsec == st.st_mtim.tv_nsec) {
+            return true;
+        }
+        verifiedConnections_.erase(it);
+    }
+
+    if (!verifyExecutable()) {
+        return false;
+    }
+
+    verifiedConnections_[connection] = VerifiedConnection { peerCred, st.st_dev, st.st_ino, st.st_mtim };
+    return true;
+#else
+    (void)connection;
+    (void)peerCred;
+    return true;
+#endif
+}
+
+void HelperSecurity::removeConnection(const void *connection)
+{
+    verifiedConnections_.erase(connection);
+}
+
+bool HelperSecurity::verifyExecutable()
 {
 #if defined(USE_SIGNATURE_CHECK)
     ExecutableSignature sigCheck;
-    bool result = sigCheck.verify("/opt/windscribe/Windscribe");
+    bool result = sigCheck.verify(WINDSCRIBE_EXE_PATH);
 
     if (!result) {
         Logger::instance().out("Signature verification failed for Windscribe: %s", sigCheck.lastError().c_str());
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <map>
+#include <sys/socket.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 class HelperSecurity
@@ -13,5 +15,19 @@ public:
     }
 
     // Check if process has the correct signature.
-    bool verifySignature();
+    // A successful check is cached for the connection and is repeated only if the peer or the executable changes.
+    bool verifySignature(const void *connection, const struct ucred &peerCred);
+    void removeConnection(const void *connection);
+
+private:
+    struct VerifiedConnection
+    {
+        struct ucred peerCred;
+        dev_t dev;
+        ino_t ino;
+        struct timespec mtime;
+    };
+    std::map<const void *, VerifiedConnection> verifiedConnections_;
+
+    bool verifyExecutable();
 };
@@ -28,7 +28,12 @@ int main(int argc, const char *argv[])
     Logger::instance().checkLogSize();
 
     // restore firewall setting on OS reboot, if there are saved rules on /etc/windscribe dir
+    // the ipsets referenced by the rules must exist before the rules are restored
 
+    if (Utils::isFileExists("/etc/windscribe/rules.ipset"))
+    {
+        Utils::executeCommand("ipset restore -exist < /etc/windscribe/rules.ipset");
+    }
     if (Utils::isFileExists("/etc/windscribe/rules.v4"))
     {
         Utils::executeCommand("iptables-restore -n < /etc/windscribe/rules.v4");
@@ -15,21 +15,28 @@
 #include "utils/executable_signature/executable_signature.h"
 #include "wireguard/wireguardcontroller.h"
 
-CMD_ANSWER processCommand(int cmdId, const std::string packet)
+bool processCommand(int cmdId, const char *data, size_t size, CMD_ANSWER &outAnswer)
 {
     const auto command = kCommands.find(cmdId);
     if (command == kCommands.end()) {
         Logger::instance().out("Unknown command id: %d", cmdId);
-        return CMD_ANSWER();
+        outAnswer = CMD_ANSWER();
+        return true;
     }
 
-    std::istringstream stream(packet);
-    boost::archive::text_iarchive ia(stream, boost::archive::no_header);
-
-    return (command->second)(ia);
+    // a malformed body can also throw std::bad_alloc or std::length_error from a corrupted size field
+    HelperMemoryStreamBuf buf(data, size);
+    try {
+        boost::archive::binary_iarchive ia(buf, boost::archive::no_header);
+        outAnswer = (command->second)(ia);
+    } catch (const std::exception &e) {
+        Logger::instance().out("Malformed command %d: %s", cmdId, e.what());
+        return false;
+    }
+    return true;
 }
 
-CMD_ANSWER startOpenvpn(boost::archive::text_iarchive &ia)
+CMD_ANSWER startOpenvpn(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_OPENVPN cmd;
@@ -75,7 +82,7 @@ CMD_ANSWER startOpenvpn(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getCmdStatus(boost::archive::text_iarchive &ia)
+CMD_ANSWER getCmdStatus(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_GET_CMD_STATUS cmd;
@@ -94,7 +101,7 @@ CMD_ANSWER getCmdStatus(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER clearCmds(boost::archive::text_iarchive &ia)
+CMD_ANSWER clearCmds(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CLEAR_CMDS cmd;
@@ -106,7 +113,7 @@ CMD_ANSWER clearCmds(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER splitTunnelingSettings(boost::archive::text_iarchive &ia)
+CMD_ANSWER splitTunnelingSettings(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SPLIT_TUNNELING_SETTINGS cmd;
@@ -118,7 +125,7 @@ CMD_ANSWER splitTunnelingSettings(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER sendConnectStatus(boost::archive::text_iarchive &ia)
+CMD_ANSWER sendConnectStatus(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SEND_CONNECT_STATUS cmd;
@@ -133,7 +140,7 @@ CMD_ANSWER sendConnectStatus(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startWireGuard(boost::archive::text_iarchive &ia)
+CMD_ANSWER startWireGuard(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
 
@@ -143,7 +150,7 @@ CMD_ANSWER startWireGuard(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER stopWireGuard(boost::archive::text_iarchive &ia)
+CMD_ANSWER stopWireGuard(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     if (WireGuardController::instance().stop()) {
@@ -152,7 +159,7 @@ CMD_ANSWER stopWireGuard(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER configureWireGuard(boost::archive::text_iarchive &ia)
+CMD_ANSWER configureWireGuard(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CONFIGURE_WIREGUARD cmd;
@@ -201,7 +208,13 @@ CMD_ANSWER configureWireGuard(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getWireGuardStatus(boost::archive::text_iarchive &ia)
+CMD_ANSWER getWireGuardStatus(boost::archive::binary_iarchive &ia)
+{
+    UNUSED(ia);
+    return wireGuardStatus();
+}
+
+CMD_ANSWER wireGuardStatus()
 {
     CMD_ANSWER answer;
     unsigned int errorCode = 0;
@@ -222,7 +235,7 @@ CMD_ANSWER getWireGuardStatus(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER changeMtu(boost::archive::text_iarchive &ia)
+CMD_ANSWER changeMtu(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CHANGE_MTU cmd;
@@ -234,7 +247,7 @@ CMD_ANSWER changeMtu(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setDnsLeakProtectEnabled(boost::archive::text_iarchive &ia)
+CMD_ANSWER setDnsLeakProtectEnabled(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_DNS_LEAK_PROTECT_ENABLED cmd;
@@ -249,7 +262,7 @@ CMD_ANSWER setDnsLeakProtectEnabled(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER clearFirewallRules(boost::archive::text_iarchive &ia)
+CMD_ANSWER clearFirewallRules(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CLEAR_FIREWALL_RULES cmd;
@@ -260,7 +273,7 @@ CMD_ANSWER clearFirewallRules(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER checkFirewallState(boost::archive::text_iarchive &ia)
+CMD_ANSWER checkFirewallState(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CHECK_FIREWALL_STATE cmd;
@@ -271,7 +284,7 @@ CMD_ANSWER checkFirewallState(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setFirewallRules(boost::archive::text_iarchive &ia)
+CMD_ANSWER setFirewallRules(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_FIREWALL_RULES cmd;
@@ -284,7 +297,7 @@ CMD_ANSWER setFirewallRules(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getFirewallRules(boost::archive::text_iarchive &ia)
+CMD_ANSWER getFirewallRules(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_GET_FIREWALL_RULES cmd;
@@ -295,7 +308,18 @@ CMD_ANSWER getFirewallRules(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER taskKill(boost::archive::text_iarchive &ia)
+CMD_ANSWER setFirewallIps(boost::archive::binary_iarchive &ia)
+{
+    CMD_ANSWER answer;
+    CMD_SET_FIREWALL_IPS cmd;
+    ia >> cmd;
+    Logger::instance().out("Set firewall ips, count: %zu", cmd.ips.size());
+
+    answer.executed = FirewallController::instance().setWhitelistIps(cmd.ips) ? 1 : 0;
+    return answer;
+}
+
+CMD_ANSWER taskKill(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_TASK_KILL cmd;
@@ -337,7 +361,7 @@ CMD_ANSWER taskKill(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startCtrld(boost::archive::text_iarchive &ia)
+CMD_ANSWER startCtrld(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_CTRLD cmd;
@@ -403,7 +427,7 @@ CMD_ANSWER startCtrld(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startStunnel(boost::archive::text_iarchive &ia)
+CMD_ANSWER startStunnel(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_STUNNEL cmd;
@@ -443,7 +467,7 @@ CMD_ANSWER startStunnel(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startWstunnel(boost::archive::text_iarchive &ia)
+CMD_ANSWER startWstunnel(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_WSTUNNEL cmd;
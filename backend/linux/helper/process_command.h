@@ -1,7 +1,7 @@
 #pragma once
 
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <map>
 #include <string>
@@ -9,27 +9,28 @@
 #include "helper_commands.h"
 #include "helper_commands_serialize.h"
 
-CMD_ANSWER startOpenvpn(boost::archive::text_iarchive &ia);
-CMD_ANSWER getCmdStatus(boost::archive::text_iarchive &ia);
-CMD_ANSWER clearCmds(boost::archive::text_iarchive &ia);
-CMD_ANSWER splitTunnelingSettings(boost::archive::text_iarchive &ia);
-CMD_ANSWER sendConnectStatus(boost::archive::text_iarchive &ia);
-CMD_ANSWER startWireGuard(boost::archive::text_iarchive &ia);
-CMD_ANSWER stopWireGuard(boost::archive::text_iarchive &ia);
-CMD_ANSWER configureWireGuard(boost::archive::text_iarchive &ia);
-CMD_ANSWER getWireGuardStatus(boost::archive::text_iarchive &ia);
-CMD_ANSWER changeMtu(boost::archive::text_iarchive &ia);
-CMD_ANSWER setDnsLeakProtectEnabled(boost::archive::text_iarchive &ia);
-CMD_ANSWER clearFirewallRules(boost::archive::text_iarchive &ia);
-CMD_ANSWER checkFirewallState(boost::archive::text_iarchive &ia);
-CMD_ANSWER setFirewallRules(boost::archive::text_iarchive &ia);
-CMD_ANSWER getFirewallRules(boost::archive::text_iarchive &ia);
-CMD_ANSWER taskKill(boost::archive::text_iarchive &ia);
-CMD_ANSWER startCtrld(boost::archive::text_iarchive &ia);
-CMD_ANSWER startStunnel(boost::archive::text_iarchive &ia);
-CMD_ANSWER startWstunnel(boost::archive::text_iarchive &ia);
+CMD_ANSWER startOpenvpn(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getCmdStatus(boost::archive::binary_iarchive &ia);
+CMD_ANSWER clearCmds(boost::archive::binary_iarchive &ia);
+CMD_ANSWER splitTunnelingSettings(boost::archive::binary_iarchive &ia);
+CMD_ANSWER sendConnectStatus(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startWireGuard(boost::archive::binary_iarchive &ia);
+CMD_ANSWER stopWireGuard(boost::archive::binary_iarchive &ia);
+CMD_ANSWER configureWireGuard(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getWireGuardStatus(boost::archive::binary_iarchive &ia);
+CMD_ANSWER changeMtu(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setDnsLeakProtectEnabled(boost::archive::binary_iarchive &ia);
+CMD_ANSWER clearFirewallRules(boost::archive::binary_iarchive &ia);
+CMD_ANSWER checkFirewallState(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setFirewallRules(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getFirewallRules(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setFirewallIps(boost::archive::binary_iarchive &ia);
+CMD_ANSWER taskKill(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startCtrld(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startStunnel(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startWstunnel(boost::archive::binary_iarchive &ia);
 
-static const std::map<const int, std::function<CMD_ANSWER(boost::archive::text_iarchive &)>> kCommands = {
+static const std::map<const int, std::function<CMD_ANSWER(boost::archive::binary_iarchive &)>> kCommands = {
       { HELPER_CMD_START_OPENVPN, startOpenvpn },
       { HELPER_CMD_GET_CMD_STATUS, getCmdStatus },
       { HELPER_CMD_CLEAR_CMDS, clearCmds },
@@ -45,10 +46,13 @@ static const std::map<const int, std::function<CMD_ANSWER(boost::archive::text_i
       { HELPER_CMD_CHECK_FIREWALL_STATE, checkFirewallState },
       { HELPER_CMD_SET_FIREWALL_RULES, setFirewallRules },
       { HELPER_CMD_GET_FIREWALL_RULES, getFirewallRules },
+      { HELPER_CMD_SET_FIREWALL_IPS, setFirewallIps },
       { HELPER_CMD_TASK_KILL, taskKill },
       { HELPER_CMD_START_CTRLD, startCtrld },
       { HELPER_CMD_START_STUNNEL, startStunnel },
       { HELPER_CMD_START_WSTUNNEL, startWstunnel },
 };
 
-CMD_ANSWER processCommand(int cmdId, const std::string packet);
+// returns false if the command could not be deserialized, the connection must be dropped in this case
+bool processCommand(int cmdId, const char *data, size_t size, CMD_ANSWER &outAnswer);
+CMD_ANSWER wireGuardStatus();
@@ -0,0 +1,319 @@
+#include "netlink_routes.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <set>
+#include <string.h>
+#include <sys/socket.h>
+#include <tuple>
+#include <unistd.h>
+
+#include "../logger.h"
+
+namespace {
+
+// the kernel table is matched by these fields, the interface index is 0 if not specified
+struct RouteKey
+{
+    in_addr_t dst;
+    int prefixLength;
+    in_addr_t gateway;
+    int oif;
+
+    bool operator<(const RouteKey &other) const
+    {
+        return std::tie(dst, prefixLength, gateway, oif) < std::tie(other.dst, other.prefixLength, other.gateway, other.oif);
+    }
+};
+
+// keep a batch well below the default socket buffer size
+constexpr size_t kMaxBatchSize = 32 * 1024;
+
+class NetlinkSocket
+{
+public:
+    NetlinkSocket() : fd_(socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)), seq_(0)
+    {
+        if (fd_ >= 0) {
+            struct sockaddr_nl addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.nl_family = AF_NETLINK;
+            if (bind(fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+                close(fd_);
+                fd_ = -1;
+            }
+        }
+    }
+    ~NetlinkSocket()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool isValid() const { return fd_ >= 0; }
+    uint32_t nextSeq() { return ++seq_; }
+
+    bool send(const std::vector<char> &buf)
+    {
+        struct sockaddr_nl addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.nl_family = AF_NETLINK;
+        return sendto(fd_, buf.data(), buf.size(), 0, (struct sockaddr *)&addr, sizeof(addr)) == (ssize_t)buf.size();
+    }
+
+    // calls handler for every message until NLMSG_DONE or until all the acks in [firstSeq, lastSeq] are received
+    template<typename Handler>
+    bool receive(uint32_t firstSeq, uint32_t lastSeq, bool isDump, Handler handler)
+    {
+        std::vector<char> buf(32 * 1024);
+        uint32_t acksLeft = isDump ? 0 : lastSeq - firstSeq + 1;
+        while (isDump || acksLeft > 0) {
+            ssize_t len = recv(fd_, buf.data(), buf.size(), 0);
+            if (len < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            for (auto *nh = (struct nlmsghdr *)buf.data(); NLMSG_OK(nh, (size_t)len); nh = NLMSG_NEXT(nh, len)) {
+                if (nh->nlmsg_seq < firstSeq || nh->nlmsg_seq > lastSeq) {
+                    continue;
+                }
+                if (nh->nlmsg_type == NLMSG_DONE) {
+                    return true;
+                }
+                if (nh->nlmsg_type == NLMSG_ERROR) {
+                    const auto *err = (const struct nlmsgerr *)NLMSG_DATA(nh);
+                    handler(nh, -err->error);
+                    if (!isDump) {
+                        acksLeft--;
+                        continue;
+                    }
+                    return false;
+                }
+                handler(nh, 0);
+            }
+        }
+        return true;
+    }
+
+private:
+    int fd_;
+    uint32_t seq_;
+};
+
+void addAttr(struct nlmsghdr *nh, int type, const void *data, size_t size)
+{
+    auto *rta = (struct rtattr *)((char *)nh + NLMSG_ALIGN(nh->nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = RTA_LENGTH(size);
+    memcpy(RTA_DATA(rta), data, size);
+    nh->nlmsg_len = NLMSG_ALIGN(nh->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+bool toKey(const NetlinkRoutes::Route &route, RouteKey &key)
+{
+    key.prefixLength = route.prefixLength;
+    key.gateway = 0;
+    key.oif = 0;
+    if (inet_pton(AF_INET, route.ip.c_str(), &key.dst) != 1) {
+        return false;
+    }
+    if (!route.gateway.empty() && inet_pton(AF_INET, route.gateway.c_str(), &key.gateway) != 1) {
+        return false;
+    }
+    if (!route.interface.empty()) {
+        key.oif = if_nametoindex(route.interface.c_str());
+        if (key.oif == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// true if the kernel route matches the key, the unspecified gateway or interface of the key match any
+bool isMatched(const std::set<RouteKey> &kernelRoutes, const RouteKey &key)
+{
+    auto it = kernelRoutes.lower_bound(RouteKey { key.dst, key.prefixLength, 0, 0 });
+    for (; it != kernelRoutes.end() && it->dst == key.dst && it->prefixLength == key.prefixLength; ++it) {
+        if ((key.gateway == 0 || key.gateway == it->gateway) && (key.oif == 0 || key.oif == it->oif)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dumpMainTable(NetlinkSocket &sock, std::set<RouteKey> &outRoutes)
+{
+    struct {
+        struct nlmsghdr nh;
+        struct rtmsg rt;
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    req.nh.nlmsg_type = RTM_GETROUTE;
+    req.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nh.nlmsg_seq = sock.nextSeq();
+    req.rt.rtm_family = AF_INET;
+
+    std::vector<char> buf((char *)&req, (char *)&req + req.nh.nlmsg_len);
+    if (!sock.send(buf)) {
+        return false;
+    }
+
+    return sock.receive(req.nh.nlmsg_seq, req.nh.nlmsg_seq, true, [&outRoutes](const struct nlmsghdr *nh, int error) {
+        if (error || nh->nlmsg_type != RTM_NEWROUTE) {
+            return;
+        }
+        const auto *rt = (const struct rtmsg *)NLMSG_DATA(nh);
+        uint32_t table = rt->rtm_table;
+        RouteKey key { 0, rt->rtm_dst_len, 0, 0 };
+        int len = RTM_PAYLOAD(nh);
+        for (auto *rta = RTM_RTA(rt); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+            switch (rta->rta_type) {
+            case RTA_TABLE: table = *(const uint32_t *)RTA_DATA(rta); break;
+            case RTA_DST: key.dst = *(const in_addr_t *)RTA_DATA(rta); break;
+            case RTA_GATEWAY: key.gateway = *(const in_addr_t *)RTA_DATA(rta); break;
+            case RTA_OIF: key.oif = *(const int *)RTA_DATA(rta); break;
+            }
+        }
+        if (table == RT_TABLE_MAIN) {
+            outRoutes.insert(key);
+        }
+    });
+}
+
+void appendRouteMessage(std::vector<char> &buf, uint32_t seq, bool isAdd, const RouteKey &key)
+{
+    const size_t offset = buf.size();
+    buf.resize(offset + NLMSG_SPACE(sizeof(struct rtmsg) + 3 * RTA_SPACE(sizeof(uint32_t))), 0);
+
+    auto *nh = (struct nlmsghdr *)(buf.data() + offset);
+    nh->nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    nh->nlmsg_type = isAdd ? RTM_NEWROUTE : RTM_DELROUTE;
+    nh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | (isAdd ? NLM_F_CREATE | NLM_F_EXCL : 0);
+    nh->nlmsg_seq = seq;
+
+    // the same fields as "ip route add/del" fills in
+    auto *rt = (struct rtmsg *)NLMSG_DATA(nh);
+    rt->rtm_family = AF_INET;
+    rt->rtm_dst_len = key.prefixLength;
+    rt->rtm_table = RT_TABLE_MAIN;
+    if (isAdd) {
+        rt->rtm_protocol = RTPROT_BOOT;
+        rt->rtm_scope = key.gateway ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK;
+        rt->rtm_type = RTN_UNICAST;
+    } else {
+        rt->rtm_scope = RT_SCOPE_NOWHERE;
+    }
+
+    addAttr(nh, RTA_DST, &key.dst, sizeof(key.dst));
+    if (key.gateway) {
+        addAttr(nh, RTA_GATEWAY, &key.gateway, sizeof(key.gateway));
+    }
+    if (key.oif) {
+        addAttr(nh, RTA_OIF, &key.oif, sizeof(key.oif));
+    }
+    buf.resize(offset + NLMSG_ALIGN(nh->nlmsg_len));
+}
+
+std::string routeToString(const NetlinkRoutes::Route &route)
+{
+    std::string str = route.ip + "/" + std::to_string(route.prefixLength);
+    if (!route.gateway.empty()) {
+        str += " via " + route.gateway;
+    }
+    if (!route.interface.empty()) {
+        str += " dev " + route.interface;
+    }
+    return str;
+}
+
+} // namespace
+
+bool NetlinkRoutes::apply(const std::vector<Route> &routesToAdd, const std::vector<Route> &routesToDelete)
+{
+    if (routesToAdd.empty() && routesToDelete.empty()) {
+        return true;
+    }
+
+    NetlinkSocket sock;
+    if (!sock.isValid()) {
+        Logger::instance().out("Failed to open NETLINK_ROUTE socket (%d)", errno);
+        return false;
+    }
+
+    std::set<RouteKey> kernelRoutes;
+    if (!dumpMainTable(sock, kernelRoutes)) {
+        Logger::instance().out("Failed to dump the routing table (%d)", errno);
+        return false;
+    }
+
+    // build the batch, the deletions go first, so that a changed route can be re-added
+    struct Change
+    {
+        const Route *route;
+        bool isAdd;
+    };
+    std::vector<Change> changes;
+    std::vector<RouteKey> keys;
+    bool result = true;
+    auto collect = [&](const std::vector<Route> &routes, bool isAdd) {
+        for (const auto &route : routes) {
+            RouteKey key;
+            if (!toKey(route, key)) {
+                Logger::instance().out("Invalid route: %s", routeToString(route).c_str());
+                result = false;
+                continue;
+            }
+            // nothing to do if the kernel table already has the desired state
+            if (isMatched(kernelRoutes, key) == isAdd) {
+                continue;
+            }
+            changes.push_back(Change { &route, isAdd });
+            keys.push_back(key);
+        }
+    };
+    collect(routesToDelete, false);
+    collect(routesToAdd, true);
+
+    size_t ind = 0;
+    while (ind < changes.size()) {
+        std::vector<char> buf;
+        const uint32_t firstSeq = sock.nextSeq();
+        const size_t firstInd = ind;
+        uint32_t seq = firstSeq;
+        for (; ind < changes.size() && buf.size() < kMaxBatchSize; ++ind) {
+            if (ind != firstInd) {
+                seq = sock.nextSeq();
+            }
+            appendRouteMessage(buf, seq, changes[ind].isAdd, keys[ind]);
+        }
+
+        if (!sock.send(buf)) {
+            Logger::instance().out("Failed to send %zu route changes (%d)", ind - firstInd, errno);
+            return false;
+        }
+        bool isReceived = sock.receive(firstSeq, seq, false, [&](const struct nlmsghdr *nh, int error) {
+            if (error && nh->nlmsg_type == NLMSG_ERROR) {
+                const Change &change = changes[firstInd + (nh->nlmsg_seq - firstSeq)];
+                Logger::instance().out("Failed to %s route %s: %s", change.isAdd ? "add" : "delete",
+                                       routeToString(*change.route).c_str(), strerror(error));
+                result = false;
+            }
+        });
+        if (!isReceived) {
+            Logger::instance().out("Failed to receive the route change acks (%d)", errno);
+            return false;
+        }
+    }
+
+    if (!changes.empty()) {
+        Logger::instance().out("Applied %zu route changes", changes.size());
+    }
+    return result;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Programs IPv4 routes of the main table via rtnetlink, without running the "ip route" command.
+// The requests of a call are sent as one batch and are diffed against the kernel table first,
+// so that routes which already exist are not added and routes which are gone are not deleted.
+class NetlinkRoutes
+{
+public:
+    struct Route
+    {
+        std::string ip;
+        int prefixLength = 32;
+        std::string gateway;        // may be empty for a route via interface
+        std::string interface;      // may be empty for a route via gateway
+    };
+
+    // returns false if any of the changes failed
+    static bool apply(const std::vector<Route> &routesToAdd, const std::vector<Route> &routesToDelete);
+
+    static bool add(const Route &route) { return apply({ route }, {}); }
+    static bool remove(const Route &route) { return apply({}, { route }); }
+};
@@ -1,6 +1,6 @@
 #include "routes.h"
 #include "../logger.h"
-#include "../utils.h"
+#include "netlink_routes.h"
 
 void Routes::add(const std::string &ip, const std::string &gateway, const std::string &mask)
 {
@@ -10,9 +10,8 @@ void Routes::add(const std::string &ip, const std::string &gateway, const std::s
     rd.mask = mask;
     routes_.push_back(rd);
 
-    std::string cmd = "ip route add " + ip + "/" + mask + " via " + gateway;
-    Logger::instance().out("execute: %s", cmd.c_str());
-    Utils::executeCommand(cmd);
+    Logger::instance().out("add route: %s/%s via %s", ip.c_str(), mask.c_str(), gateway.c_str());
+    NetlinkRoutes::add(toNetlinkRoute(rd));
 }
 
 void Routes::addWithInterface(const std::string &ip, const std::string &interface, const std::string &mask)
@@ -23,28 +22,29 @@ void Routes::addWithInterface(const std::string &ip, const std::string &interfac
     rd.mask = mask;
     routes_.push_back(rd);
 
-    std::string cmd = "ip route add " + ip + "/" + mask + " dev " + interface;
-    Logger::instance().out("execute: %s", cmd.c_str());
-    Utils::executeCommand(cmd);
+    Logger::instance().out("add route: %s/%s dev %s", ip.c_str(), mask.c_str(), interface.c_str());
+    NetlinkRoutes::add(toNetlinkRoute(rd));
 }
 
 
 void Routes::clear()
 {
+    // delete all the routes in one batch
+    std::vector<NetlinkRoutes::Route> routesToDelete;
     for(auto const& rd: routes_)
     {
-        if (rd.interface.empty())
-        {
-            std::string cmd = "ip route delete " + rd.ip + "/" + rd.mask + " via " + rd.gateway;
-            Logger::instance().out("execute: %s", cmd.c_str());
-            Utils::executeCommand(cmd);
-        }
-        else
-        {
-            std::string cmd = "ip route delete " + rd.ip + "/" + rd.mask + " dev " + rd.interface;
-            Logger::instance().out("execute: %s", cmd.c_str());
-            Utils::executeCommand(cmd);
-        }
+        routesToDelete.push_back(toNetlinkRoute(rd));
     }
+    NetlinkRoutes::apply({}, routesToDelete);
     routes_.clear();
 }
+
+NetlinkRoutes::Route Routes::toNetlinkRoute(const RouteDescr &rd)
+{
+    NetlinkRoutes::Route route;
+    route.ip = rd.ip;
+    route.prefixLength = std::stoi(rd.mask);
+    route.gateway = rd.gateway;
+    route.interface = rd.interface;
+    return route;
+}
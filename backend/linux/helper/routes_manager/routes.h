@@ -2,9 +2,9 @@
 
 #include <string>
 #include <vector>
+#include "netlink_routes.h"
 
-
-// helper for add and clear routes via system "route" command
+// helper for add and clear routes, the routes are programmed via netlink
 class Routes
 {
 public:
@@ -22,4 +22,6 @@ private:
     };
 
     std::vector<RouteDescr> routes_;
+
+    static NetlinkRoutes::Route toNetlinkRoute(const RouteDescr &rd);
 };
@@ -1,9 +1,11 @@
 #include "server.h"
 
 #include <boost/bind.hpp>
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
+#include <algorithm>
+#include <array>
 #include <codecvt>
 #include <grp.h>
 #include <stdlib.h>
@@ -40,27 +42,26 @@ Server::~Server()
     unlink(SOCK_PATH);
 }
 
-bool Server::readAndHandleCommand(socket_ptr sock, boost::asio::streambuf *buf, CMD_ANSWER &outCmdAnswer)
+bool Server::readAndHandleCommand(socket_ptr sock, boost::asio::streambuf *buf, uint32_t &outRequestId, CMD_ANSWER &outCmdAnswer)
 {
     // not enough data for read command
-    if (buf->size() < sizeof(int)*3) {
+    if (buf->size() < sizeof(HELPER_REQUEST_HEADER)) {
         return false;
     }
 
     const char *bufPtr = boost::asio::buffer_cast<const char*>(buf->data());
-    size_t headerSize = 0;
-    int cmdId;
-    memcpy(&cmdId, bufPtr + headerSize, sizeof(cmdId));
-    headerSize += sizeof(cmdId);
-    pid_t pid;
-    memcpy(&pid, bufPtr + headerSize, sizeof(pid));
-    headerSize += sizeof(pid);
-    int length;
-    memcpy(&length, bufPtr + headerSize, sizeof(length));
-    headerSize += sizeof(length);
+    HELPER_REQUEST_HEADER header;
+    memcpy(&header, bufPtr, sizeof(header));
+
+    if (header.version != HELPER_PROTOCOL_VERSION) {
+        // the rest of the stream cannot be parsed, drop the client
+        Logger::instance().out("Unsupported protocol version: %u", header.version);
+        closeConnection(sock);
+        return false;
+    }
 
     // not enough data for read command
-    if (buf->size() < (headerSize + length)) {
+    if (buf->size() < (sizeof(header) + header.size)) {
         return false;
     }
 
@@ -73,17 +74,25 @@ bool Server::readAndHandleCommand(socket_ptr sock, boost::asio::streambuf *buf,
         return false;
     }
 
-    if (!HelperSecurity::instance().verifySignature()) {
+    if (!HelperSecurity::instance().verifySignature(sock.get(), peerCred)) {
         return false;
     }
 
-    std::vector<char> vector(length);
-    memcpy(&vector[0], bufPtr + headerSize, length);
-    std::string str(vector.begin(), vector.end());
-    std::istringstream stream(str);
-    outCmdAnswer = processCommand(cmdId, str);
+    // the body is deserialized in place, directly from the receive buffer
+    bool isParsed;
+    if (header.cmdId == HELPER_CMD_SUBSCRIBE_WIREGUARD_STATUS) {
+        isParsed = subscribeToWireGuardStatus(sock, header.requestId, bufPtr + sizeof(header), header.size, outCmdAnswer);
+    } else {
+        isParsed = processCommand(header.cmdId, bufPtr + sizeof(header), header.size, outCmdAnswer);
+    }
+    if (!isParsed) {
+        // the client sent garbage, do not trust the rest of its stream
+        closeConnection(sock);
+        return false;
+    }
 
-    buf->consume(headerSize + length);
+    outRequestId = header.requestId;
+    buf->consume(sizeof(header) + header.size);
 
     return true;
 }
@@ -93,26 +102,113 @@ void Server::receiveCmdHandle(socket_ptr sock, boost::shared_ptr<boost::asio::st
     UNUSED(bytes_transferred);
 
     if (!ec.value()) {
-        // read and handle commands
+        // read and handle the commands, the client may have written several of them, they are answered in order
         while (true) {
+            uint32_t requestId;
             CMD_ANSWER cmdAnswer;
-            if (!readAndHandleCommand(sock, buf.get(), cmdAnswer)) {
+            if (!readAndHandleCommand(sock, buf.get(), requestId, cmdAnswer)) {
                 // goto receive next commands
                 boost::asio::async_read(*sock, *buf, boost::asio::transfer_at_least(1),
                                         boost::bind(&Server::receiveCmdHandle, this, sock, buf, _1, _2));
                 break;
             } else {
-                if (!sendAnswerCmd(sock, cmdAnswer)) {
+                if (!sendAnswerCmd(sock, requestId, cmdAnswer)) {
+                    removeConnection(sock);
                     Logger::instance().out("client app disconnected");
                     return;
                 }
             }
         }
     } else {
+        removeConnection(sock);
         Logger::instance().out("client app disconnected");
     }
 }
 
+void Server::removeConnection(socket_ptr sock)
+{
+    HelperSecurity::instance().removeConnection(sock.get());
+
+    auto it = wireGuardStatusSubscriptions_.find(sock.get());
+    if (it != wireGuardStatusSubscriptions_.end()) {
+        it->second->timer.cancel();
+        wireGuardStatusSubscriptions_.erase(it);
+    }
+}
+
+void Server::closeConnection(socket_ptr sock)
+{
+    removeConnection(sock);
+    boost::system::error_code ec;
+    sock->close(ec);
+}
+
+bool Server::subscribeToWireGuardStatus(socket_ptr sock, uint32_t requestId, const char *data, size_t size, CMD_ANSWER &outCmdAnswer)
+{
+    boost::shared_ptr<WireGuardStatusSubscription> subscription(new WireGuardStatusSubscription(service_));
+    try {
+        HelperMemoryStreamBuf buf(data, size);
+        boost::archive::binary_iarchive ia(buf, boost::archive::no_header);
+        ia >> subscription->params;
+    } catch (const std::exception &e) {
+        Logger::instance().out("Malformed WireGuard status subscription: %s", e.what());
+        return false;
+    }
+
+    subscription->requestId = requestId;
+    subscription->params.checkIntervalMs = std::max(subscription->params.checkIntervalMs, 50u);
+    subscription->lastAnswer = wireGuardStatus();
+    subscription->lastSentTime = std::chrono::steady_clock::now();
+
+    auto it = wireGuardStatusSubscriptions_.find(sock.get());
+    if (it != wireGuardStatusSubscriptions_.end()) {
+        it->second->timer.cancel();
+    }
+    wireGuardStatusSubscriptions_[sock.get()] = subscription;
+    scheduleWireGuardStatusCheck(sock, subscription);
+
+    // the current status is the first answer of the feed
+    outCmdAnswer = subscription->lastAnswer;
+    return true;
+}
+
+void Server::scheduleWireGuardStatusCheck(socket_ptr sock, boost::shared_ptr<WireGuardStatusSubscription> subscription)
+{
+    subscription->timer.expires_after(std::chrono::milliseconds(subscription->params.checkIntervalMs));
+    subscription->timer.async_wait(boost::bind(&Server::onWireGuardStatusCheck, this, sock, subscription, _1));
+}
+
+void Server::onWireGuardStatusCheck(socket_ptr sock, boost::shared_ptr<WireGuardStatusSubscription> subscription, const boost::system::error_code &ec)
+{
+    if (ec) {
+        // the subscription was canceled
+        return;
+    }
+
+    // The status is checked locally. The client is woken up right away on a state change (the handshake state is part of it),
+    // the byte counters of a busy tunnel change on every check and are sent only at the stats cadence.
+    const CMD_ANSWER answer = wireGuardStatus();
+    const CMD_ANSWER &last = subscription->lastAnswer;
+    const auto now = std::chrono::steady_clock::now();
+    const auto sinceLastSent = now - subscription->lastSentTime;
+    const bool isStateChanged = answer.cmdId != last.cmdId || answer.executed != last.executed ||
+                                (answer.cmdId == kWgStateError && answer.customInfoValue[0] != last.customInfoValue[0]);
+    const bool isStatsChanged = answer.customInfoValue[0] != last.customInfoValue[0] ||
+                                answer.customInfoValue[1] != last.customInfoValue[1];
+    if (isStateChanged ||
+        (isStatsChanged && sinceLastSent >= std::chrono::milliseconds(subscription->params.statsIntervalMs)) ||
+        sinceLastSent >= std::chrono::milliseconds(subscription->params.keepAliveMs)) {
+        if (!sendAnswerCmd(sock, subscription->requestId, answer)) {
+            removeConnection(sock);
+            return;
+        }
+        subscription->lastAnswer = answer;
+        subscription->lastSentTime = now;
+    }
+
+    scheduleWireGuardStatusCheck(sock, subscription);
+}
+
 void Server::acceptHandler(const boost::system::error_code & ec, socket_ptr sock)
 {
     if (!ec.value()) {
@@ -132,25 +228,23 @@ void Server::startAccept()
     acceptor_->async_accept(*sock, boost::bind(&Server::acceptHandler, this, boost::asio::placeholders::error, sock));
 }
 
-bool Server::sendAnswerCmd(socket_ptr sock, const CMD_ANSWER &cmdAnswer)
+bool Server::sendAnswerCmd(socket_ptr sock, uint32_t requestId, const CMD_ANSWER &cmdAnswer)
 {
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmdAnswer;
     std::string str = stream.str();
-    int length = (int)str.length();
-    // send answer to client
+
+    HELPER_ANSWER_HEADER header;
+    header.version = HELPER_PROTOCOL_VERSION;
+    header.requestId = requestId;
+    header.size = (uint32_t)str.length();
+
+    // send the header and the body with a single write
+    std::array<boost::asio::const_buffer, 2> buffers = { boost::asio::buffer(&header, sizeof(header)), boost::asio::buffer(str) };
     boost::system::error_code er;
-    boost::asio::write(*sock, boost::asio::buffer(&length, sizeof(length)), boost::asio::transfer_exactly(sizeof(length)), er);
-    if (er.value()) {
-        return false;
-    } else {
-        boost::asio::write(*sock, boost::asio::buffer(str.data(), str.length()), boost::asio::transfer_exactly(str.length()), er);
-        if (er.value()) {
-            return false;
-        }
-    }
-    return true;
+    boost::asio::write(*sock, buffers, er);
+    return !er.value();
 }
 
 void Server::run()
@@ -8,6 +8,7 @@
 #include <boost/asio.hpp>
 #include <boost/thread.hpp>
 #include <list>
+#include <map>
 
 #include "../../posix_common/helper_commands.h"
 #include "routes_manager/routes_manager.h"
@@ -28,12 +29,30 @@ private:
     boost::asio::io_service service_;
     boost::asio::local::stream_protocol::acceptor *acceptor_;
 
-    bool readAndHandleCommand(socket_ptr sock, boost::asio::streambuf *buf, CMD_ANSWER &outCmdAnswer);
+    // WireGuard status feed of a connection, see CMD_SUBSCRIBE_WIREGUARD_STATUS
+    struct WireGuardStatusSubscription
+    {
+        explicit WireGuardStatusSubscription(boost::asio::io_service &service) : timer(service) {}
+        boost::asio::steady_timer timer;
+        CMD_SUBSCRIBE_WIREGUARD_STATUS params;
+        uint32_t requestId = 0;
+        CMD_ANSWER lastAnswer;
+        std::chrono::steady_clock::time_point lastSentTime;
+    };
+    std::map<const void *, boost::shared_ptr<WireGuardStatusSubscription>> wireGuardStatusSubscriptions_;
+
+    bool readAndHandleCommand(socket_ptr sock, boost::asio::streambuf *buf, uint32_t &outRequestId, CMD_ANSWER &outCmdAnswer);
+    void removeConnection(socket_ptr sock);
+    void closeConnection(socket_ptr sock);
+
+    bool subscribeToWireGuardStatus(socket_ptr sock, uint32_t requestId, const char *data, size_t size, CMD_ANSWER &outCmdAnswer);
+    void scheduleWireGuardStatusCheck(socket_ptr sock, boost::shared_ptr<WireGuardStatusSubscription> subscription);
+    void onWireGuardStatusCheck(socket_ptr sock, boost::shared_ptr<WireGuardStatusSubscription> subscription, const boost::system::error_code &ec);
 
     void receiveCmdHandle(socket_ptr sock, boost::shared_ptr<boost::asio::streambuf> buf, const boost::system::error_code& ec, std::size_t bytes_transferred);
     void acceptHandler(const boost::system::error_code & ec, socket_ptr sock);
     void startAccept();
 
-    bool sendAnswerCmd(socket_ptr sock, const CMD_ANSWER &cmdAnswer);
+    bool sendAnswerCmd(socket_ptr sock, uint32_t requestId, const CMD_ANSWER &cmdAnswer);
 };
 
@@ -3,7 +3,7 @@
 #include <set>
 
 #include "../../logger.h"
-#include "../../utils.h"
+#include "../../routes_manager/netlink_routes.h"
 
 void IpRoutes::setIps(const std::string &defaultRouteIp, const std::vector<std::string> &ips)
 {
@@ -24,15 +24,17 @@ void IpRoutes::setIps(const std::string &defaultRouteIp, const std::vector<std::
     }
 
     // delete routes
+    std::vector<NetlinkRoutes::Route> routesToDelete;
     for (auto ip = ipsDelete.begin(); ip != ipsDelete.end(); ++ip) {
         auto fr = activeRoutes_.find(*ip);
         if (fr != activeRoutes_.end()) {
-            deleteRoute(fr->second);
+            routesToDelete.push_back(toNetlinkRoute(fr->second));
             activeRoutes_.erase(fr);
         }
     }
 
     // add routes
+    std::vector<NetlinkRoutes::Route> routesToAdd;
     for (auto ip = ipsSet.begin(); ip != ipsSet.end(); ++ip) {
         auto ar = activeRoutes_.find(*ip);
         if (ar != activeRoutes_.end()) {
@@ -41,32 +43,30 @@ void IpRoutes::setIps(const std::string &defaultRouteIp, const std::vector<std::
             RouteDescr rd;
             rd.ip = *ip;
             rd.defaultRouteIp = defaultRouteIp;
-            addRoute(rd);
+            routesToAdd.push_back(toNetlinkRoute(rd));
             activeRoutes_[*ip] = rd;
         }
     }
+
+    // all the changes are applied in one batch
+    NetlinkRoutes::apply(routesToAdd, routesToDelete);
 }
 
 void IpRoutes::clear()
 {
     std::lock_guard<std::recursive_mutex> guard(mutex_);
+    std::vector<NetlinkRoutes::Route> routesToDelete;
     for (auto it = activeRoutes_.begin(); it != activeRoutes_.end(); ++it) {
-        deleteRoute(it->second);
+        routesToDelete.push_back(toNetlinkRoute(it->second));
     }
+    NetlinkRoutes::apply({}, routesToDelete);
     activeRoutes_.clear();
 }
 
-void IpRoutes::addRoute(const RouteDescr &rd)
-{
-    std::string cmd = "ip route add " + rd.ip + " via " + rd.defaultRouteIp;
-    Logger::instance().out("cmd: %s", cmd.c_str());
-
-    Utils::executeCommand(cmd);
-}
-
-void IpRoutes::deleteRoute(const RouteDescr &rd)
+NetlinkRoutes::Route IpRoutes::toNetlinkRoute(const RouteDescr &rd)
 {
-    std::string cmd = "ip route del " + rd.ip + " via " + rd.defaultRouteIp;
-    Logger::instance().out("cmd: %s", cmd.c_str());
-    Utils::executeCommand(cmd);
+    NetlinkRoutes::Route route;
+    route.ip = rd.ip;
+    route.gateway = rd.defaultRouteIp;
+    return route;
 }
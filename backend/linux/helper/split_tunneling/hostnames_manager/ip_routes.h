@@ -4,8 +4,9 @@
 #include <vector>
 #include <mutex>
 #include <map>
+#include "../../routes_manager/netlink_routes.h"
 
-// manage Ip route via "route add" and "route delete" commands
+// manage Ip routes of the resolved hostnames, the routes are programmed via netlink
 class IpRoutes
 {
 public:
@@ -23,6 +24,5 @@ private:
 
     std::map<std::string, RouteDescr> activeRoutes_;
 
-    void addRoute(const RouteDescr &rd);
-    void deleteRoute(const RouteDescr &rd);
+    static NetlinkRoutes::Route toNetlinkRoute(const RouteDescr &rd);
 };
@@ -20,7 +20,7 @@
 #include "utils/executable_signature/executable_signature.h"
 #include "wireguard/wireguardcontroller.h"
 
-CMD_ANSWER processCommand(int cmdId, const std::string &packet)
+CMD_ANSWER processCommand(int cmdId, const char *data, size_t size)
 {
     const auto command = kCommands.find(cmdId);
     if (command == kCommands.end()) {
@@ -28,13 +28,18 @@ CMD_ANSWER processCommand(int cmdId, const std::string &packet)
         return CMD_ANSWER();
     }
 
-    std::istringstream stream(packet);
-    boost::archive::text_iarchive ia(stream, boost::archive::no_header);
-
-    return (command->second)(ia);
+    HelperMemoryStreamBuf buf(data, size);
+    try {
+        boost::archive::binary_iarchive ia(buf, boost::archive::no_header);
+        return (command->second)(ia);
+    } catch (const std::exception &e) {
+        // a corrupted size field can also throw std::bad_alloc or std::length_error
+        LOG("Malformed command %d: %s", cmdId, e.what());
+        return CMD_ANSWER();
+    }
 }
 
-CMD_ANSWER startOpenvpn(boost::archive::text_iarchive &ia)
+CMD_ANSWER startOpenvpn(boost::archive::binary_iarchive &ia)
 {
     CMD_START_OPENVPN cmd;
     CMD_ANSWER answer;
@@ -74,7 +79,7 @@ CMD_ANSWER startOpenvpn(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getCmdStatus(boost::archive::text_iarchive &ia)
+CMD_ANSWER getCmdStatus(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_GET_CMD_STATUS cmd;
@@ -94,7 +99,7 @@ CMD_ANSWER getCmdStatus(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER clearCmds(boost::archive::text_iarchive &ia)
+CMD_ANSWER clearCmds(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CLEAR_CMDS cmd;
@@ -106,7 +111,7 @@ CMD_ANSWER clearCmds(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER splitTunnelingSettings(boost::archive::text_iarchive &ia)
+CMD_ANSWER splitTunnelingSettings(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SPLIT_TUNNELING_SETTINGS cmd;
@@ -118,7 +123,7 @@ CMD_ANSWER splitTunnelingSettings(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER sendConnectStatus(boost::archive::text_iarchive &ia)
+CMD_ANSWER sendConnectStatus(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SEND_CONNECT_STATUS cmd;
@@ -130,7 +135,7 @@ CMD_ANSWER sendConnectStatus(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startWireGuard(boost::archive::text_iarchive &ia)
+CMD_ANSWER startWireGuard(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
 
@@ -143,7 +148,7 @@ CMD_ANSWER startWireGuard(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER stopWireGuard(boost::archive::text_iarchive &ia)
+CMD_ANSWER stopWireGuard(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
 
@@ -154,7 +159,7 @@ CMD_ANSWER stopWireGuard(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER configureWireGuard(boost::archive::text_iarchive &ia)
+CMD_ANSWER configureWireGuard(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CONFIGURE_WIREGUARD cmd;
@@ -195,7 +200,7 @@ CMD_ANSWER configureWireGuard(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getWireGuardStatus(boost::archive::text_iarchive &ia)
+CMD_ANSWER getWireGuardStatus(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     unsigned int errorCode = 0;
@@ -217,7 +222,7 @@ CMD_ANSWER getWireGuardStatus(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER installerSetPath(boost::archive::text_iarchive &ia)
+CMD_ANSWER installerSetPath(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_INSTALLER_FILES_SET_PATH cmd;
@@ -229,7 +234,7 @@ CMD_ANSWER installerSetPath(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER installerExecuteCopyFile(boost::archive::text_iarchive &ia)
+CMD_ANSWER installerExecuteCopyFile(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     Files *files = FilesManager::instance().files();
@@ -247,7 +252,7 @@ CMD_ANSWER installerExecuteCopyFile(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER installerRemoveOldInstall(boost::archive::text_iarchive &ia)
+CMD_ANSWER installerRemoveOldInstall(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_INSTALLER_REMOVE_OLD_INSTALL cmd;
@@ -272,7 +277,7 @@ CMD_ANSWER installerRemoveOldInstall(boost::archive::text_iarchive &ia)
 }
 
 
-CMD_ANSWER applyCustomDns(boost::archive::text_iarchive &ia)
+CMD_ANSWER applyCustomDns(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_APPLY_CUSTOM_DNS cmd;
@@ -286,7 +291,7 @@ CMD_ANSWER applyCustomDns(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER changeMtu(boost::archive::text_iarchive &ia)
+CMD_ANSWER changeMtu(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CHANGE_MTU cmd;
@@ -299,7 +304,7 @@ CMD_ANSWER changeMtu(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER deleteRoute(boost::archive::text_iarchive &ia)
+CMD_ANSWER deleteRoute(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_DELETE_ROUTE cmd;
@@ -314,7 +319,7 @@ CMD_ANSWER deleteRoute(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setIpv6Enabled(boost::archive::text_iarchive &ia)
+CMD_ANSWER setIpv6Enabled(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_IPV6_ENABLED cmd;
@@ -325,7 +330,7 @@ CMD_ANSWER setIpv6Enabled(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setDnsScriptEnabled(boost::archive::text_iarchive &ia)
+CMD_ANSWER setDnsScriptEnabled(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_DNS_SCRIPT_ENABLED cmd;
@@ -344,7 +349,7 @@ CMD_ANSWER setDnsScriptEnabled(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER clearFirewallRules(boost::archive::text_iarchive &ia)
+CMD_ANSWER clearFirewallRules(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_CLEAR_FIREWALL_RULES cmd;
@@ -357,7 +362,7 @@ CMD_ANSWER clearFirewallRules(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER checkFirewallState(boost::archive::text_iarchive &ia)
+CMD_ANSWER checkFirewallState(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     answer.exitCode = FirewallController::instance().enabled();
@@ -366,7 +371,7 @@ CMD_ANSWER checkFirewallState(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setFirewallRules(boost::archive::text_iarchive &ia)
+CMD_ANSWER setFirewallRules(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     LOG("Set firewall rules");
@@ -381,7 +386,7 @@ CMD_ANSWER setFirewallRules(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getFirewallRules(boost::archive::text_iarchive &ia)
+CMD_ANSWER getFirewallRules(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_GET_FIREWALL_RULES cmd;
@@ -393,7 +398,7 @@ CMD_ANSWER getFirewallRules(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER deleteOldHelper(boost::archive::text_iarchive &ia)
+CMD_ANSWER deleteOldHelper(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     LOG("Delete old helper");
@@ -409,7 +414,7 @@ CMD_ANSWER deleteOldHelper(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setFirewallOnBoot(boost::archive::text_iarchive &ia)
+CMD_ANSWER setFirewallOnBoot(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_FIREWALL_ON_BOOT cmd;
@@ -421,7 +426,7 @@ CMD_ANSWER setFirewallOnBoot(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setMacSpoofingOnBoot(boost::archive::text_iarchive &ia)
+CMD_ANSWER setMacSpoofingOnBoot(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_MAC_SPOOFING_ON_BOOT cmd;
@@ -432,7 +437,7 @@ CMD_ANSWER setMacSpoofingOnBoot(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER setMacAddress(boost::archive::text_iarchive &ia)
+CMD_ANSWER setMacAddress(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_SET_MAC_ADDRESS cmd;
@@ -445,7 +450,7 @@ CMD_ANSWER setMacAddress(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER taskKill(boost::archive::text_iarchive &ia)
+CMD_ANSWER taskKill(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_TASK_KILL cmd;
@@ -487,7 +492,7 @@ CMD_ANSWER taskKill(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startCtrld(boost::archive::text_iarchive &ia)
+CMD_ANSWER startCtrld(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_CTRLD cmd;
@@ -554,7 +559,7 @@ CMD_ANSWER startCtrld(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startStunnel(boost::archive::text_iarchive &ia)
+CMD_ANSWER startStunnel(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_STUNNEL cmd;
@@ -595,7 +600,7 @@ CMD_ANSWER startStunnel(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER startWstunnel(boost::archive::text_iarchive &ia)
+CMD_ANSWER startWstunnel(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_START_WSTUNNEL cmd;
@@ -632,7 +637,7 @@ CMD_ANSWER startWstunnel(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER installerCreateCliSymlinkDir(boost::archive::text_iarchive &ia)
+CMD_ANSWER installerCreateCliSymlinkDir(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     CMD_INSTALLER_CREATE_CLI_SYMLINK_DIR cmd;
@@ -675,7 +680,7 @@ CMD_ANSWER installerCreateCliSymlinkDir(boost::archive::text_iarchive &ia)
     return answer;
 }
 
-CMD_ANSWER getHelperVersion(boost::archive::text_iarchive &ia)
+CMD_ANSWER getHelperVersion(boost::archive::binary_iarchive &ia)
 {
     CMD_ANSWER answer;
     answer.body = MacUtils::bundleVersionFromPlist();
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <map>
 #include <string>
@@ -9,39 +9,39 @@
 #include "../../posix_common/helper_commands.h"
 #include "../../posix_common/helper_commands_serialize.h"
 
-CMD_ANSWER startOpenvpn(boost::archive::text_iarchive &ia);
-CMD_ANSWER getCmdStatus(boost::archive::text_iarchive &ia);
-CMD_ANSWER clearCmds(boost::archive::text_iarchive &ia);
-CMD_ANSWER splitTunnelingSettings(boost::archive::text_iarchive &ia);
-CMD_ANSWER sendConnectStatus(boost::archive::text_iarchive &ia);
-CMD_ANSWER startWireGuard(boost::archive::text_iarchive &ia);
-CMD_ANSWER stopWireGuard(boost::archive::text_iarchive &ia);
-CMD_ANSWER configureWireGuard(boost::archive::text_iarchive &ia);
-CMD_ANSWER getWireGuardStatus(boost::archive::text_iarchive &ia);
-CMD_ANSWER installerSetPath(boost::archive::text_iarchive &ia);
-CMD_ANSWER installerExecuteCopyFile(boost::archive::text_iarchive &ia);
-CMD_ANSWER installerRemoveOldInstall(boost::archive::text_iarchive &ia);
-CMD_ANSWER applyCustomDns(boost::archive::text_iarchive &ia);
-CMD_ANSWER changeMtu(boost::archive::text_iarchive &ia);
-CMD_ANSWER deleteRoute(boost::archive::text_iarchive &ia);
-CMD_ANSWER setIpv6Enabled(boost::archive::text_iarchive &ia);
-CMD_ANSWER setDnsScriptEnabled(boost::archive::text_iarchive &ia);
-CMD_ANSWER clearFirewallRules(boost::archive::text_iarchive &ia);
-CMD_ANSWER checkFirewallState(boost::archive::text_iarchive &ia);
-CMD_ANSWER setFirewallRules(boost::archive::text_iarchive &ia);
-CMD_ANSWER getFirewallRules(boost::archive::text_iarchive &ia);
-CMD_ANSWER deleteOldHelper(boost::archive::text_iarchive &ia);
-CMD_ANSWER setFirewallOnBoot(boost::archive::text_iarchive &ia);
-CMD_ANSWER setMacSpoofingOnBoot(boost::archive::text_iarchive &ia);
-CMD_ANSWER setMacAddress(boost::archive::text_iarchive &ia);
-CMD_ANSWER taskKill(boost::archive::text_iarchive &ia);
-CMD_ANSWER startCtrld(boost::archive::text_iarchive &ia);
-CMD_ANSWER startStunnel(boost::archive::text_iarchive &ia);
-CMD_ANSWER startWstunnel(boost::archive::text_iarchive &ia);
-CMD_ANSWER installerCreateCliSymlinkDir(boost::archive::text_iarchive &ia);
-CMD_ANSWER getHelperVersion(boost::archive::text_iarchive &ia);
+CMD_ANSWER startOpenvpn(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getCmdStatus(boost::archive::binary_iarchive &ia);
+CMD_ANSWER clearCmds(boost::archive::binary_iarchive &ia);
+CMD_ANSWER splitTunnelingSettings(boost::archive::binary_iarchive &ia);
+CMD_ANSWER sendConnectStatus(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startWireGuard(boost::archive::binary_iarchive &ia);
+CMD_ANSWER stopWireGuard(boost::archive::binary_iarchive &ia);
+CMD_ANSWER configureWireGuard(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getWireGuardStatus(boost::archive::binary_iarchive &ia);
+CMD_ANSWER installerSetPath(boost::archive::binary_iarchive &ia);
+CMD_ANSWER installerExecuteCopyFile(boost::archive::binary_iarchive &ia);
+CMD_ANSWER installerRemoveOldInstall(boost::archive::binary_iarchive &ia);
+CMD_ANSWER applyCustomDns(boost::archive::binary_iarchive &ia);
+CMD_ANSWER changeMtu(boost::archive::binary_iarchive &ia);
+CMD_ANSWER deleteRoute(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setIpv6Enabled(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setDnsScriptEnabled(boost::archive::binary_iarchive &ia);
+CMD_ANSWER clearFirewallRules(boost::archive::binary_iarchive &ia);
+CMD_ANSWER checkFirewallState(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setFirewallRules(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getFirewallRules(boost::archive::binary_iarchive &ia);
+CMD_ANSWER deleteOldHelper(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setFirewallOnBoot(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setMacSpoofingOnBoot(boost::archive::binary_iarchive &ia);
+CMD_ANSWER setMacAddress(boost::archive::binary_iarchive &ia);
+CMD_ANSWER taskKill(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startCtrld(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startStunnel(boost::archive::binary_iarchive &ia);
+CMD_ANSWER startWstunnel(boost::archive::binary_iarchive &ia);
+CMD_ANSWER installerCreateCliSymlinkDir(boost::archive::binary_iarchive &ia);
+CMD_ANSWER getHelperVersion(boost::archive::binary_iarchive &ia);
 
-static const std::map<const int, std::function<CMD_ANSWER(boost::archive::text_iarchive &)>> kCommands = {
+static const std::map<const int, std::function<CMD_ANSWER(boost::archive::binary_iarchive &)>> kCommands = {
     { HELPER_CMD_START_OPENVPN, startOpenvpn },
     { HELPER_CMD_GET_CMD_STATUS, getCmdStatus },
     { HELPER_CMD_CLEAR_CMDS, clearCmds },
@@ -75,4 +75,4 @@ static const std::map<const int, std::function<CMD_ANSWER(boost::archive::text_i
     { HELPER_CMD_HELPER_VERSION, getHelperVersion }
 };
 
-CMD_ANSWER processCommand(int cmdId, const std::string &packet);
+CMD_ANSWER processCommand(int cmdId, const char *data, size_t size);
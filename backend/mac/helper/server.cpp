@@ -3,8 +3,8 @@
 #include <assert.h>
 #include <sstream>
 
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include "ipc/helper_security.h"
 #include "logger.h"
@@ -67,19 +67,20 @@ void Server::peer_event_handler(xpc_connection_t peer, xpc_object_t event)
         // handle the message
         xpc_retain(event);
         int64_t cmdId = xpc_dictionary_get_int64(event, "cmdId");
-        std::string data;
 
-        size_t length;
-        const void *buf = xpc_dictionary_get_data(event, "data", &length);
-        if (buf && length > 0) {
-            data = std::string((const char *)buf, length);
+        CMD_ANSWER cmdAnswer;
+        if (xpc_dictionary_get_int64(event, "version") != HELPER_PROTOCOL_VERSION) {
+            LOG("Unsupported protocol version of command %lld", cmdId);
+        } else {
+            // the data is owned by the event, deserialize it in place
+            size_t length = 0;
+            const void *buf = xpc_dictionary_get_data(event, "data", &length);
+            cmdAnswer = processCommand(cmdId, buf ? (const char *)buf : "", buf ? length : 0);
         }
 
-        CMD_ANSWER cmdAnswer = processCommand(cmdId, data);
-
         // send answer
         std::stringstream stream;
-        boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+        boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
         oa << cmdAnswer;
         std::string str = stream.str();
         xpc_object_t message = xpc_dictionary_create_reply(event);
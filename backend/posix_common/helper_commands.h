@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unistd.h>
@@ -41,6 +42,28 @@
 #define HELPER_CMD_START_WSTUNNEL                    34
 #define HELPER_CMD_INSTALLER_CREATE_CLI_SYMLINK_DIR  35
 #define HELPER_CMD_HELPER_VERSION                    36
+#define HELPER_CMD_SUBSCRIBE_WIREGUARD_STATUS        37 // Linux only
+#define HELPER_CMD_SET_FIREWALL_IPS                  38 // Linux only
+
+// Version of the wire format, must be bumped on any change of the framing or of the serialized command structs
+#define HELPER_PROTOCOL_VERSION 4
+
+// Framing of the socket protocol (Linux), the body is a boost binary archive of the command struct
+// A client may write several commands without waiting for the answers. The helper runs the commands of a connection
+// one at a time and answers them in order, every answer carries the request id of its command.
+struct HELPER_REQUEST_HEADER {
+    uint32_t version;
+    uint32_t requestId;  // chosen by the client, echoed in the answer
+    int32_t cmdId;
+    int32_t pid;
+    uint32_t size;       // size of the body following the header
+};
+
+struct HELPER_ANSWER_HEADER {
+    uint32_t version;
+    uint32_t requestId;  // request id of the answered command, of the subscription for the pushed answers
+    uint32_t size;
+};
 
 // enums
 
@@ -167,6 +190,17 @@ struct CMD_START_CTRLD {
     bool isCreateLog;
 };
 
+// Turns the connection into a WireGuard status feed: the helper answers with the current status and then
+// pushes a new answer with the same request id whenever the status changes or keepAliveMs passes.
+// The state changes are pushed at the first check that sees them, the traffic counters at most every statsIntervalMs
+struct CMD_SUBSCRIBE_WIREGUARD_STATUS {
+    unsigned int checkIntervalMs;
+    unsigned int statsIntervalMs;
+    unsigned int keepAliveMs;
+
+    CMD_SUBSCRIBE_WIREGUARD_STATUS() : checkIntervalMs(250), statsIntervalMs(500), keepAliveMs(10000) {}
+};
+
 struct CMD_KILL_PROCESS {
     pid_t processId;
 };
@@ -216,6 +250,13 @@ struct CMD_SET_FIREWALL_RULES {
     std::string rules;
 };
 
+// the IPs whitelisted by the firewall rules, kept in an ipset
+#define HELPER_FIREWALL_IPSET "windscribe_ips"
+
+struct CMD_SET_FIREWALL_IPS {
+    std::vector<std::string> ips;
+};
+
 struct CMD_CLEAR_FIREWALL_RULES {
     bool isKeepPfEnabled;
 };
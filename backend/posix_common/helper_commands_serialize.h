@@ -1,9 +1,22 @@
 #pragma once
 
+#include <streambuf>
+
 #ifndef UNUSED
 #define UNUSED(x) (void)(x)
 #endif
 
+// Read-only stream buffer over existing memory, allows to deserialize a command without copying the packet
+class HelperMemoryStreamBuf : public std::streambuf
+{
+public:
+    HelperMemoryStreamBuf(const char *data, size_t size)
+    {
+        char *p = const_cast<char *>(data);
+        setg(p, p, p + size);
+    }
+};
+
 namespace boost {
 namespace serialization {
 
@@ -142,6 +155,15 @@ void serialize(Archive &ar, CMD_CHANGE_MTU &a, const unsigned int version)
     ar & a.adapterName;
 }
 
+template<class Archive>
+void serialize(Archive &ar, CMD_SUBSCRIBE_WIREGUARD_STATUS &a, const unsigned int version)
+{
+    UNUSED(version);
+    ar & a.checkIntervalMs;
+    ar & a.statsIntervalMs;
+    ar & a.keepAliveMs;
+}
+
 template<class Archive>
 void serialize(Archive &ar, CMD_DELETE_ROUTE &a, const unsigned int version)
 {
@@ -197,6 +219,13 @@ void serialize(Archive &ar, CMD_CLEAR_FIREWALL_RULES &a, const unsigned int vers
 }
 
 
+template<class Archive>
+void serialize(Archive &ar, CMD_SET_FIREWALL_IPS &a, const unsigned int version)
+{
+    UNUSED(version);
+    ar & a.ips;
+}
+
 template<class Archive>
 void serialize(Archive &ar, CMD_GET_FIREWALL_RULES &a, const unsigned int version)
 {
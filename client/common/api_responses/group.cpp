@@ -1,78 +1,36 @@
 #include "group.h"
-#include <QJsonArray>
 #include "utils/ws_assert.h"
 
 namespace api_responses {
 
-bool Group::initFromJson(QJsonObject &obj, QStringList &forceDisconnectNodes)
+void Group::initFromRecord(const std::shared_ptr<wsnet::WSNetServerGroup> &group)
 {
-    if (!obj.contains("id") || !obj.contains("city") || !obj.contains("nick") ||
-            !obj.contains("pro") || !obj.contains("ping_ip") || !obj.contains("wg_pubkey"))
-    {
-        d->isValid_ = false;
-        return false;
-    }
-
-    d->id_ = obj["id"].toInt();
-    d->city_ = obj["city"].toString();
-    d->nick_ = obj["nick"].toString();
-    d->pro_ = obj["pro"].toInt();
-    d->pingIp_ = obj["ping_ip"].toString();
-    d->pingHost_ = obj["ping_host"].toString();
-    d->wg_pubkey_ = obj["wg_pubkey"].toString();
-    d->ovpn_x509_ = obj["ovpn_x509"].toString();
-
-    if (obj.contains("link_speed"))
-    {
-        bool bConverted;
-        d->link_speed_ = obj.value("link_speed").toString().toInt(&bConverted);
-        if (!bConverted) {
-            d->link_speed_ = 100;
-        }
-    }
+    d->id_ = group->id();
+    d->city_ = QString::fromStdString(group->city());
+    d->nick_ = QString::fromStdString(group->nick());
+    d->pro_ = group->pro();
+    d->pingIp_ = QString::fromStdString(group->pingIp());
+    d->pingHost_ = QString::fromStdString(group->pingHost());
+    d->wg_pubkey_ = QString::fromStdString(group->wgPubKey());
+    d->ovpn_x509_ = QString::fromStdString(group->ovpnX509());
+    d->link_speed_ = group->linkSpeed();
 
     // Using -1 to indicate to the UI logic that the load (health) value was invalid/missing,
     // and therefore this location should be excluded when calculating the region's average
     // load value.
     // Note: the server json does not include a health value for premium locations when the
     // user is logged into a free account.
-    if (obj.contains("health"))
-    {
-        d->health_ = obj.value("health").toInt(-1);
-        if ((d->health_ < 0) || (d->health_ > 100)) {
-            d->health_ = -1;
-        }
-    }
-    else {
-        d->health_ = -1;
-    }
-
-    if (obj.contains("nodes"))
-    {
-        const auto nodesArray = obj["nodes"].toArray();
-        for (const QJsonValue &serverNodeValue : nodesArray)
-        {
-            QJsonObject objServerNode = serverNodeValue.toObject();
-            Node node;
-            if (!node.initFromJson(objServerNode))
-            {
-                d->isValid_ = false;
-                return false;
-            }
-
-            // not add node with flag force_diconnect, but add it to another list
-            if (node.isForceDisconnect())
-            {
-                forceDisconnectNodes << node.getHostname();
-            }
-            else
-            {
-                d->nodes_ << node;
-            }
-        }
+    d->health_ = group->health();
+
+    // the nodes with flag force_disconnect are already excluded by wsnet
+    const auto nodes = group->nodes();
+    d->nodes_.reserve(nodes.size());
+    for (const auto &it : nodes) {
+        Node node;
+        node.initFromRecord(it);
+        d->nodes_ << node;
     }
     d->isValid_ = true;
-    return true;
 }
 
 bool Group::operator==(const Group &other) const
@@ -56,7 +56,7 @@ public:
     explicit Group() : d(new GroupData) {}
     Group(const Group &other) : d (other.d) {}
 
-    bool initFromJson(QJsonObject &obj, QStringList &forceDisconnectNodes);
+    void initFromRecord(const std::shared_ptr<wsnet::WSNetServerGroup> &group);
 
     int getId() const { WS_ASSERT(d->isValid_); return d->id_; }
     QString getCity() const { WS_ASSERT(d->isValid_); return d->city_; }
@@ -1,9 +1,6 @@
 #include "location.h"
 
 #include <QDataStream>
-#include <QJsonObject>
-#include <QJsonValue>
-#include <QJsonArray>
 
 const int typeIdApiLocation = qRegisterMetaType<api_responses::Location>("apiinfo::Location");
 const int typeIdApiLocationVector = qRegisterMetaType<QVector<api_responses::Location>>("QVector<apiinfo::Location>");
@@ -11,41 +8,23 @@ const int typeIdApiLocationVector = qRegisterMetaType<QVector<api_responses::Loc
 namespace api_responses {
 
 
-bool Location::initFromJson(const QJsonObject &obj, QStringList &forceDisconnectNodes)
+void Location::initFromRecord(const std::shared_ptr<wsnet::WSNetServerLocation> &location)
 {
-    if (!obj.contains("id") || !obj.contains("name") || !obj.contains("country_code") ||
-            !obj.contains("premium_only") || !obj.contains("p2p") || !obj.contains("groups"))
-    {
-        d->isValid_ = false;
-        return false;
-    }
-
-    d->id_ = obj["id"].toInt();
-    d->name_ = obj["name"].toString();
-    d->countryCode_ = obj["country_code"].toString();
-    d->premiumOnly_ = obj["premium_only"].toInt();
-    d->p2p_ = obj["p2p"].toInt();
-    if (obj.contains("dns_hostname"))
-    {
-        d->dnsHostName_ = obj["dns_hostname"].toString();
-    }
-
-    const auto groupsArray = obj["groups"].toArray();
-    for (const QJsonValue &serverGroupValue : groupsArray)
-    {
-        QJsonObject objServerGroup = serverGroupValue.toObject();
-
+    d->id_ = location->id();
+    d->name_ = QString::fromStdString(location->name());
+    d->countryCode_ = QString::fromStdString(location->countryCode());
+    d->premiumOnly_ = location->premiumOnly();
+    d->p2p_ = location->p2p();
+    d->dnsHostName_ = QString::fromStdString(location->dnsHostName());
+
+    const auto groups = location->groups();
+    d->groups_.reserve(groups.size());
+    for (const auto &it : groups) {
         Group group;
-        if (!group.initFromJson(objServerGroup, forceDisconnectNodes))
-        {
-            d->isValid_ = false;
-            return false;
-        }
+        group.initFromRecord(it);
         d->groups_ << group;
     }
-
     d->isValid_ = true;
-    return true;
 }
 
 QStringList Location::getAllPingIps() const
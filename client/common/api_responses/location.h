@@ -45,7 +45,7 @@ public:
     explicit Location() : d(new LocationData) {}
     Location(const Location &other) : d (other.d) {}
 
-    bool initFromJson(const QJsonObject &obj, QStringList &forceDisconnectNodes);
+    void initFromRecord(const std::shared_ptr<wsnet::WSNetServerLocation> &location);
 
     int getId() const { WS_ASSERT(d->isValid_); return d->id_; }
     QString getName() const { WS_ASSERT(d->isValid_); return d->name_; }
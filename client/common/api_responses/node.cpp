@@ -3,31 +3,15 @@
 
 namespace api_responses {
 
-bool Node::initFromJson(QJsonObject &obj)
+void Node::initFromRecord(const std::shared_ptr<wsnet::WSNetServerNode> &node)
 {
-    if (!obj.contains("ip") || !obj.contains("ip2") || !obj.contains("ip3") || !obj.contains("hostname") || !obj.contains("weight"))
-    {
-        d->isValid_ = false;
-        return false;
-    }
-
-    d->ips_ << obj["ip"].toString();
-    d->ips_ << obj["ip2"].toString();
-    d->ips_ << obj["ip3"].toString();
-    d->hostname_ = obj["hostname"].toString();
-    d->weight_ = obj["weight"].toInt();
-
-    if (obj.contains("force_disconnect"))
-    {
-        d->forceDisconnect_ = obj["force_disconnect"].toInt();
-    }
-    else
-    {
-        d->forceDisconnect_ = 0;
-    }
-
+    d->ips_ << QString::fromStdString(node->ip());
+    d->ips_ << QString::fromStdString(node->ip2());
+    d->ips_ << QString::fromStdString(node->ip3());
+    d->hostname_ = QString::fromStdString(node->hostname());
+    d->weight_ = node->weight();
+    d->forceDisconnect_ = 0;
     d->isValid_ = true;
-    return true;
 }
 
 QString Node::getHostname() const
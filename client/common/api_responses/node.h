@@ -3,6 +3,7 @@
 #include <QJsonObject>
 #include <QSharedDataPointer>
 #include <QStringList>
+#include <wsnet/WSNetServerLocations.h>
 
 namespace api_responses {
 
@@ -28,7 +29,8 @@ class Node
 public:
     Node() : d(new NodeData) {}
 
-    bool initFromJson(QJsonObject &obj);
+    // the records are validated by wsnet
+    void initFromRecord(const std::shared_ptr<wsnet::WSNetServerNode> &node);
 
     QString getHostname() const;
     bool isForceDisconnect() const;
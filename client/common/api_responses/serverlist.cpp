@@ -1,37 +1,22 @@
 #include "serverlist.h"
-#include <QJsonDocument>
-#include <QJsonArray>
 
 namespace api_responses {
 
-ServerList::ServerList(const std::string &json)
+ServerList::ServerList(const std::shared_ptr<wsnet::WSNetServerLocations> &serverLocations)
 {
-    QJsonParseError errCode;
-    auto doc = QJsonDocument::fromJson(QByteArray(json.c_str()), &errCode);
-    auto jsonObject = doc.object();
+    countryOverride_ = QString::fromStdString(serverLocations->countryOverride());
 
-    // get country_override parameter
-    if (jsonObject.contains("info")) {
-        auto jsonInfo = jsonObject["info"].toObject();
-        if (jsonInfo.contains("country_override")) {
-            countryOverride_ = jsonInfo["country_override"].toString();
-        }
+    // the invalid locations are already skipped by wsnet
+    const auto locations = serverLocations->locations();
+    locations_.reserve(locations.size());
+    for (const auto &it : locations) {
+        Location sl;
+        sl.initFromRecord(it);
+        locations_ << sl;
     }
 
-    // parse locations array
-    const QJsonArray jsonData = jsonObject["data"].toArray();
-    for (int i = 0; i < jsonData.size(); ++i) {
-        if (jsonData.at(i).isObject()) {
-            Location sl;
-            QJsonObject dataElement = jsonData.at(i).toObject();
-            if (sl.initFromJson(dataElement, forceDisconnectNodes_)) {
-                locations_ << sl;
-            } else {
-                QJsonDocument invalidData(dataElement);
-            }
-        }
-    }
+    for (const auto &it : serverLocations->forceDisconnectNodes())
+        forceDisconnectNodes_ << QString::fromStdString(it);
 }
 
-
 } // namespace api_responses
@@ -8,7 +8,7 @@ namespace api_responses {
 class ServerList
 {
 public:
-    ServerList(const std::string &json);
+    explicit ServerList(const std::shared_ptr<wsnet::WSNetServerLocations> &serverLocations);
 
     QVector<Location> locations() const { return locations_; }
     QStringList forceDisconnectNodes() const { return forceDisconnectNodes_; }
@@ -10,31 +10,53 @@ namespace IPC
 namespace CliCommands
 {
 
+// integer IDs of the commands, sent in the framing instead of the string IDs
+enum CommandId {
+    kConnectCmd,
+    kDisconnectCmd,
+    kShowLocationsCmd,
+    kFirewallCmd,
+    kGetStateCmd,
+    kLoginCmd,
+    kSignOutCmd,
+    kConnectToLocationAnswerCmd,
+    kConnectStateChangedCmd,
+    kFirewallStateChangedCmd,
+    kLocationsShownCmd,
+    kAlreadyDisconnectedCmd,
+    kStateCmd,
+    kLoginResultCmd,
+    kSignedOutCmd,
+    kCommandsCount
+};
+
 class Connect : public Command
 {
 public:
     Connect() {}
     explicit Connect(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> location_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << location_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::Connect debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::Connect";  }
+    static constexpr int kCommandId = kConnectCmd;
 
     QString location_;
 };
@@ -49,17 +71,19 @@ public:
         Q_UNUSED(size)
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
-        return std::vector<char>();
+        return QByteArray();
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::Disconnect debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::Disconnect";  }
+    static constexpr int kCommandId = kDisconnectCmd;
 };
 
 class ShowLocations : public Command
@@ -72,17 +96,19 @@ public:
         Q_UNUSED(size)
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
-        return std::vector<char>();
+        return QByteArray();
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::ShowLocations debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::ShowLocations";  }
+    static constexpr int kCommandId = kShowLocationsCmd;
 };
 
 class Firewall : public Command
@@ -91,25 +117,27 @@ public:
     Firewall() {}
     explicit Firewall(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> isEnable_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << isEnable_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::Firewall debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::Firewall";  }
+    static constexpr int kCommandId = kFirewallCmd;
 
     bool isEnable_ = false;
 };
@@ -124,17 +152,19 @@ public:
         Q_UNUSED(size)
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
-        return std::vector<char>();
+        return QByteArray();
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::GetState debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::GetState";  }
+    static constexpr int kCommandId = kGetStateCmd;
 };
 
 class Login : public Command
@@ -143,25 +173,27 @@ public:
     Login() {}
     explicit Login(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> username_ >> password_ >> code2fa_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << username_ << password_ << code2fa_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::Login debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::Login";  }
+    static constexpr int kCommandId = kLoginCmd;
 
     QString username_;
     QString password_;
@@ -174,25 +206,27 @@ public:
     SignOut() {}
     explicit SignOut(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> isKeepFirewallOn_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << isKeepFirewallOn_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::SignOut debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::SignOut";  }
+    static constexpr int kCommandId = kSignOutCmd;
 
     bool isKeepFirewallOn_;
 };
@@ -203,25 +237,27 @@ public:
     ConnectToLocationAnswer() {}
     explicit ConnectToLocationAnswer(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> isSuccess_ >> location_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << isSuccess_ << location_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::ConnectToLocationAnswer debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::ConnectToLocationAnswer";  }
+    static constexpr int kCommandId = kConnectToLocationAnswerCmd;
 
     bool isSuccess_;
     QString location_;
@@ -233,25 +269,27 @@ public:
     ConnectStateChanged() {}
     explicit ConnectStateChanged(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> connectState;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << connectState;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::ConnectStateChanged debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::ConnectStateChanged";  }
+    static constexpr int kCommandId = kConnectStateChangedCmd;
 
     types::ConnectState connectState;
 };
@@ -262,25 +300,27 @@ public:
     FirewallStateChanged() {}
     explicit FirewallStateChanged(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> isFirewallEnabled_ >> isFirewallAlwaysOn_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << isFirewallEnabled_ << isFirewallAlwaysOn_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::FirewallStateChanged debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::FirewallStateChanged";  }
+    static constexpr int kCommandId = kFirewallStateChangedCmd;
 
     bool isFirewallEnabled_;
     bool isFirewallAlwaysOn_;
@@ -296,17 +336,19 @@ public:
         Q_UNUSED(size)
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
-        return std::vector<char>();
+        return QByteArray();
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::LocationsShown debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::LocationsShown";  }
+    static constexpr int kCommandId = kLocationsShownCmd;
 };
 
 class AlreadyDisconnected : public Command
@@ -319,17 +361,19 @@ public:
         Q_UNUSED(size)
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
-        return std::vector<char>();
+        return QByteArray();
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::AlreadyDisconnected debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::AlreadyDisconnected";  }
+    static constexpr int kCommandId = kAlreadyDisconnectedCmd;
 };
 
 class State : public Command
@@ -338,25 +382,27 @@ public:
     State() {}
     explicit State(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> isLoggedIn_ >> waitingForLoginInfo_ >> connectState_ >> location_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << isLoggedIn_ << waitingForLoginInfo_ << connectState_ << location_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::State debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::State";  }
+    static constexpr int kCommandId = kStateCmd;
 
     bool isLoggedIn_ = false;
     bool waitingForLoginInfo_ = false;
@@ -370,25 +416,27 @@ public:
     LoginResult() {}
     explicit LoginResult(char *buf, int size)
     {
-        QByteArray arr(buf, size);
+        QByteArray arr = QByteArray::fromRawData(buf, size);
         QDataStream ds(&arr, QIODevice::ReadOnly);
         ds >> isLoggedIn_ >> loginError_;
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
         QByteArray arr;
         QDataStream ds(&arr, QIODevice::WriteOnly);
         ds << isLoggedIn_ << loginError_;
-        return std::vector<char>(arr.begin(), arr.end());
+        return arr;
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::LoginResult debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::LoginResult";  }
+    static constexpr int kCommandId = kLoginResultCmd;
 
     bool isLoggedIn_;
     QString loginError_;
@@ -404,17 +452,19 @@ public:
         Q_UNUSED(size)
     }
 
-    std::vector<char> getData() const override
+    QByteArray getData() const override
     {
-        return std::vector<char>();
+        return QByteArray();
     }
 
+    int getId() const override { return kCommandId; }
     std::string getStringId() const override { return getCommandStringId(); }
     std::string getDebugString() const override
     {
         return "CliCommands::SignedOut debug string";
     }
     static std::string getCommandStringId() { return "CliCommands::SignedOut";  }
+    static constexpr int kCommandId = kSignedOutCmd;
 };
 
 } // namespace CliCommands
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <vector>
 #include <string>
+#include <QByteArray>
 
 namespace IPC
 {
@@ -12,7 +12,10 @@ class Command
 public:
     virtual ~Command() {}
 
-    virtual std::vector<char> getData() const = 0;
+    virtual QByteArray getData() const = 0;
+
+    // return unique static integer ID for command, it is sent to the other side
+    virtual int getId() const = 0;
 
     // return unique static string ID for command
     virtual std::string getStringId() const = 0;
@@ -1,5 +1,4 @@
-#include <QObject>
-#include <QDebug>
+#include <array>
 
 #include "commandfactory.h"
 #include "clicommands.h"
@@ -8,74 +7,62 @@
 namespace IPC
 {
 
-Command *CommandFactory::makeCommand(const std::string strId, char *buf, int size)
+namespace
 {
-    qDebug() << QString::fromStdString(strId);
 
-    // CLI commands
-    if (strId == IPC::CliCommands::Connect::getCommandStringId())
-    {
-        return new IPC::CliCommands::Connect(buf, size);
-    }
-    else if (strId == IPC::CliCommands::ConnectToLocationAnswer::getCommandStringId())
-    {
-        return new IPC::CliCommands::ConnectToLocationAnswer(buf, size);
-    }
-    else if (strId == IPC::CliCommands::ConnectStateChanged::getCommandStringId())
-    {
-        return new IPC::CliCommands::ConnectStateChanged(buf, size);
-    }
-    else if (strId == IPC::CliCommands::Disconnect::getCommandStringId())
-    {
-        return new IPC::CliCommands::Disconnect(buf, size);
-    }
-    else if (strId == IPC::CliCommands::AlreadyDisconnected::getCommandStringId())
-    {
-        return new IPC::CliCommands::AlreadyDisconnected(buf, size);
-    }
-    else if (strId == IPC::CliCommands::ShowLocations::getCommandStringId())
-    {
-        return new IPC::CliCommands::ShowLocations(buf, size);
-    }
-    else if (strId == IPC::CliCommands::LocationsShown::getCommandStringId())
-    {
-        return new IPC::CliCommands::LocationsShown(buf, size);
-    }
-    else if (strId == IPC::CliCommands::GetState::getCommandStringId())
-    {
-        return new IPC::CliCommands::GetState(buf, size);
-    }
-    else if (strId == IPC::CliCommands::State::getCommandStringId())
-    {
-        return new IPC::CliCommands::State(buf, size);
-    }
-    else if (strId == IPC::CliCommands::Firewall::getCommandStringId())
-    {
-        return new IPC::CliCommands::Firewall(buf, size);
-    }
-    else if (strId == IPC::CliCommands::FirewallStateChanged::getCommandStringId())
-    {
-        return new IPC::CliCommands::FirewallStateChanged(buf, size);
-    }
-    else if (strId == IPC::CliCommands::Login::getCommandStringId())
-    {
-        return new IPC::CliCommands::Login(buf, size);
-    }
-    else if (strId == IPC::CliCommands::LoginResult::getCommandStringId())
-    {
-        return new IPC::CliCommands::LoginResult(buf, size);
-    }
-    else if (strId == IPC::CliCommands::SignOut::getCommandStringId())
-    {
-        return new IPC::CliCommands::SignOut(buf, size);
-    }
-    else if (strId == IPC::CliCommands::SignedOut::getCommandStringId())
+typedef Command *(*CommandCreator)(char *buf, int size);
+
+template<typename T>
+Command *createCommand(char *buf, int size)
+{
+    return new T(buf, size);
+}
+
+// table of the command creators indexed by the command ID
+template<typename... Commands>
+constexpr std::array<CommandCreator, CliCommands::kCommandsCount> makeDispatchTable()
+{
+    std::array<CommandCreator, CliCommands::kCommandsCount> table {};
+    ((table[Commands::kCommandId] = &createCommand<Commands>), ...);
+    return table;
+}
+
+constexpr auto kDispatchTable = makeDispatchTable<
+    CliCommands::Connect,
+    CliCommands::ConnectToLocationAnswer,
+    CliCommands::ConnectStateChanged,
+    CliCommands::Disconnect,
+    CliCommands::AlreadyDisconnected,
+    CliCommands::ShowLocations,
+    CliCommands::LocationsShown,
+    CliCommands::GetState,
+    CliCommands::State,
+    CliCommands::Firewall,
+    CliCommands::FirewallStateChanged,
+    CliCommands::Login,
+    CliCommands::LoginResult,
+    CliCommands::SignOut,
+    CliCommands::SignedOut>();
+
+constexpr bool isDispatchTableComplete()
+{
+    for (auto creator : kDispatchTable)
+        if (creator == nullptr)
+            return false;
+    return true;
+}
+static_assert(isDispatchTableComplete(), "each command ID must have a creator in the dispatch table");
+
+} // namespace
+
+Command *CommandFactory::makeCommand(int id, char *buf, int size)
+{
+    if (id < 0 || id >= CliCommands::kCommandsCount)
     {
-        return new IPC::CliCommands::SignedOut(buf, size);
+        WS_ASSERT(false);
+        return NULL;
     }
-
-    WS_ASSERT(false);
-    return NULL;
+    return kDispatchTable[id](buf, size);
 }
 
 } // namespace IPC
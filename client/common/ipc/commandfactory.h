@@ -10,7 +10,8 @@ static const int CLIENT_CMD_ClientAuth = 0;
 class CommandFactory
 {
 public:
-    static Command *makeCommand(const std::string strId, char *buf, int size);
+    // returns NULL for an unknown command ID
+    static Command *makeCommand(int id, char *buf, int size);
 };
 
 } // namespace IPC
@@ -0,0 +1,88 @@
+// Benchmark of the CLI <-> GUI IPC channel: an IPC::Server and an IPC::Connection in one process, over the real local socket.
+// Measures the command round trips (GetState answered with State) and the throughput of large pipelined commands.
+// Usage: ipc_connection_bench [round trips] [large commands] [large command size in KB]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cstdio>
+#include "clicommands.h"
+#include "connection.h"
+#include "server.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int roundTrips = argc > 1 ? atoi(argv[1]) : 20000;
+    const int largeCommands = argc > 2 ? atoi(argv[2]) : 2000;
+    const int largeCommandSize = (argc > 3 ? atoi(argv[3]) : 64) * 1024;
+
+    IPC::Server server;
+    if (!server.start()) {
+        printf("Failed to start the IPC server\n");
+        return 1;
+    }
+
+    // the server answers every command, GetState with a State and the large Connect commands with a LocationsShown
+    QObject::connect(&server, &IPC::Server::newConnection, [](IPC::Connection *connection) {
+        QObject::connect(connection, &IPC::Connection::newCommand, [](IPC::Command *cmd, IPC::Connection *connection) {
+            if (cmd->getId() == IPC::CliCommands::GetState::kCommandId) {
+                IPC::CliCommands::State state;
+                state.isLoggedIn_ = true;
+                state.connectState_ = CONNECT_STATE_CONNECTED;
+                connection->sendCommand(state);
+            } else {
+                connection->sendCommand(IPC::CliCommands::LocationsShown());
+            }
+            delete cmd;
+        });
+    });
+
+    IPC::Connection client;
+    QElapsedTimer timer;
+    int received = 0;
+
+    IPC::CliCommands::Connect largeCommand;
+    largeCommand.location_ = QString(largeCommandSize / sizeof(QChar), QLatin1Char('x'));
+    const qint64 largeCommandBytes = largeCommand.getData().size();
+
+    auto startLargeCommands = [&]() {
+        received = 0;
+        timer.start();
+        // all the commands are written at once, the socket buffers them
+        for (int i = 0; i < largeCommands; ++i)
+            client.sendCommand(largeCommand);
+    };
+
+    QObject::connect(&client, &IPC::Connection::newCommand, [&](IPC::Command *cmd, IPC::Connection *) {
+        const bool isState = cmd->getId() == IPC::CliCommands::State::kCommandId;
+        delete cmd;
+        ++received;
+        if (isState) {
+            if (received < roundTrips) {
+                client.sendCommand(IPC::CliCommands::GetState());
+                return;
+            }
+            const qint64 ns = timer.nsecsElapsed();
+            printf("%-30s %10.2f us/round trip  %10.0f round trips/s\n", "GetState -> State", ns / 1000.0 / roundTrips, roundTrips * 1e9 / ns);
+            startLargeCommands();
+        } else if (received == largeCommands) {
+            const qint64 ns = timer.nsecsElapsed();
+            const double mb = (double)largeCommandBytes * largeCommands / (1024 * 1024);
+            printf("%-30s %10.2f us/command   %10.1f MB/s\n", "pipelined Connect", ns / 1000.0 / largeCommands, mb * 1e9 / ns);
+            app.quit();
+        }
+    });
+    QObject::connect(&client, &IPC::Connection::stateChanged, [&](int state, IPC::Connection *) {
+        if (state == IPC::CONNECTION_CONNECTED) {
+            timer.start();
+            client.sendCommand(IPC::CliCommands::GetState());
+        } else {
+            printf("The connection failed\n");
+            app.exit(1);
+        }
+    });
+
+    printf("%d round trips, %d commands of %lld bytes\n", roundTrips, largeCommands, largeCommandBytes);
+    client.connect();
+    return app.exec();
+}
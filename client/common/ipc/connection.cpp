@@ -6,7 +6,7 @@
 namespace IPC
 {
 
-Connection::Connection(QLocalSocket *localSocket) : localSocket_(localSocket), bytesWrittingInProgress_(0)
+Connection::Connection(QLocalSocket *localSocket) : localSocket_(localSocket), readPos_(0), bytesWrittingInProgress_(0)
 {
     QObject::connect(localSocket_, &QLocalSocket::disconnected, this, &Connection::onSocketDisconnected);
     QObject::connect(localSocket_, &QLocalSocket::bytesWritten, this, &Connection::onSocketBytesWritten);
@@ -14,7 +14,7 @@ Connection::Connection(QLocalSocket *localSocket) : localSocket_(localSocket), b
     QObject::connect(localSocket_, &QLocalSocket::errorOccurred, this, &Connection::onSocketError);
 }
 
-Connection::Connection() : localSocket_(NULL), bytesWrittingInProgress_(0)
+Connection::Connection() : localSocket_(NULL), readPos_(0), bytesWrittingInProgress_(0)
 {
 }
 
@@ -46,39 +46,28 @@ void Connection::sendCommand(const Command &commandl)
     WS_ASSERT(localSocket_ != NULL);
 
     // command structure
-    // 1) (int) size of protobuf message in bytes
-    // 2) (int) size of message string id in bytes
-    // 3) (string) message string id
-    // 4) (byte array) body of protobuf message
+    // 1) (int) size of message body in bytes
+    // 2) (int) message id
+    // 3) (byte array) body of message
 
-    std::vector<char> buf = commandl.getData();
-    int sizeOfBuf = buf.size();
-    std::string strId = commandl.getStringId();
-    int sizeOfStringId = strId.length();
+    QByteArray buf = commandl.getData();
+    int header[2] = { (int)buf.size(), commandl.getId() };
 
-    WS_ASSERT(sizeOfStringId > 0);
-
-    bool isWriteBufIsEmpty = writeBuf_.isEmpty();
+    // no intermediate frame buffer, the header and the body are copied into the write buffer of the socket once
+    qint64 bytesWritten = localSocket_->write((const char *)header, sizeof(header));
+    if (bytesWritten != -1 && !buf.isEmpty())
+    {
+        qint64 bodyBytesWritten = localSocket_->write(buf);
+        bytesWritten = bodyBytesWritten == -1 ? -1 : bytesWritten + bodyBytesWritten;
+    }
 
-    writeBuf_.append((const char *)&sizeOfBuf, sizeof(sizeOfBuf));
-    writeBuf_.append((const char *)&sizeOfStringId, sizeof(sizeOfStringId));
-    writeBuf_.append(strId.c_str(), sizeOfStringId);
-    if (sizeOfBuf > 0)
+    if (bytesWritten == -1)
     {
-        writeBuf_.append(&buf[0], sizeOfBuf);
+        emit stateChanged(CONNECTION_DISCONNECTED, this);
     }
-    if (isWriteBufIsEmpty)
+    else
     {
-        qint64 bytesWritten = localSocket_->write(writeBuf_);
-        if (bytesWritten == -1)
-        {
-            emit stateChanged(CONNECTION_DISCONNECTED, this);
-        }
-        else
-        {
-            bytesWrittingInProgress_ += bytesWritten;
-            writeBuf_.remove(0, bytesWritten);
-        }
+        bytesWrittingInProgress_ += bytesWritten;
     }
 }
 
@@ -113,20 +102,7 @@ void Connection::onSocketBytesWritten(qint64 bytes)
 {
     bytesWrittingInProgress_ -= bytes;
 
-    if (!writeBuf_.isEmpty())
-    {
-        qint64 bytesWritten = localSocket_->write(writeBuf_);
-        if (bytesWritten == -1)
-        {
-            emit stateChanged(CONNECTION_DISCONNECTED, this);
-        }
-        else
-        {
-            bytesWrittingInProgress_ += bytesWritten;
-            writeBuf_.remove(0, bytesWritten);
-        }
-    }
-    else if (bytesWrittingInProgress_ == 0)
+    if (bytesWrittingInProgress_ == 0)
     {
         emit allWritten(this);
     }
@@ -138,7 +114,22 @@ void Connection::onReadyRead()
     while (canReadCommand())
     {
         Command *cmd = readCommand();
-        emit newCommand(cmd, this);
+        if (cmd)
+        {
+            emit newCommand(cmd, this);
+        }
+    }
+
+    // drop the consumed data at once instead of after each command
+    if (readPos_ == readBuf_.size())
+    {
+        readBuf_.clear();
+        readPos_ = 0;
+    }
+    else if (readPos_ > readBuf_.size() / 2)
+    {
+        readBuf_.remove(0, readPos_);
+        readPos_ = 0;
     }
 }
 
@@ -151,14 +142,13 @@ void Connection::onSocketError(QLocalSocket::LocalSocketError socketError)
 
 bool Connection::canReadCommand()
 {
-    if (readBuf_.size() > (int)(sizeof(int) * 2))
+    qsizetype available = readBuf_.size() - readPos_;
+    if (available >= (qsizetype)(sizeof(int) * 2))
     {
         int sizeOfCmd;
-        int sizeOfId;
-        memcpy(&sizeOfCmd, readBuf_.data(), sizeof(int));
-        memcpy(&sizeOfId, readBuf_.data() + sizeof(int), sizeof(int));
+        memcpy(&sizeOfCmd, readBuf_.constData() + readPos_, sizeof(int));
 
-        if (readBuf_.size() >= (int)(sizeof(int) * 2 + sizeOfCmd + sizeOfId))
+        if (available >= (qsizetype)(sizeof(int) * 2 + sizeOfCmd))
         {
             return true;
         }
@@ -169,14 +159,12 @@ bool Connection::canReadCommand()
 Command *Connection::readCommand()
 {
     int sizeOfCmd;
-    int sizeOfId;
-    memcpy(&sizeOfCmd, readBuf_.data(), sizeof(int));
-    memcpy(&sizeOfId, readBuf_.data() + sizeof(int), sizeof(int));
-
-    std::string strId(readBuf_.data() + sizeof(int) * 2, sizeOfId);
+    int id;
+    memcpy(&sizeOfCmd, readBuf_.constData() + readPos_, sizeof(int));
+    memcpy(&id, readBuf_.constData() + readPos_ + sizeof(int), sizeof(int));
 
-    Command *cmd = CommandFactory::makeCommand(strId, readBuf_.data() + sizeof(int) * 2 + sizeOfId, sizeOfCmd);
-    readBuf_.remove(0, sizeof(int) * 2 + sizeOfId + sizeOfCmd);
+    Command *cmd = CommandFactory::makeCommand(id, readBuf_.data() + readPos_ + sizeof(int) * 2, sizeOfCmd);
+    readPos_ += sizeof(int) * 2 + sizeOfCmd;
     return cmd;
 }
 
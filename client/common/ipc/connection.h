@@ -38,8 +38,8 @@ private slots:
 private:
     QLocalSocket *localSocket_;
 
-    QByteArray writeBuf_;
     QByteArray readBuf_;
+    qsizetype readPos_;     // start of the unread data in readBuf_, the consumed data is dropped in one go
     qint64 bytesWrittingInProgress_;
 
     bool canReadCommand();
@@ -36,6 +36,12 @@ const QString WS_USE_OPENVPN_DCO = WS_PREFIX + "use-openvpn-dco";
 
 const QString WS_LOG_CTRLD = WS_PREFIX + "log-ctrld";
 
+const QString WS_DNS_STALE_WHILE_REVALIDATE = WS_PREFIX + "dns-stale-while-revalidate";
+const QString WS_API_FAILOVER_RACING = WS_PREFIX + "api-failover-racing";
+
+const QString WS_PING_SAMPLES = WS_PREFIX + "ping-samples";
+const QString WS_BEST_LOCATION_STATISTIC = WS_PREFIX + "best-location-statistic";
+
 void ExtraConfig::writeConfig(const QString &cfg)
 {
     QMutexLocker locker(&mutex_);
@@ -265,6 +271,26 @@ bool ExtraConfig::getAPIExtraTLSPadding()
     return getFlagFromExtraConfigLines(WS_API_EXTRA_TLS_PADDING);
 }
 
+bool ExtraConfig::getDnsStaleWhileRevalidate()
+{
+    return getFlagFromExtraConfigLines(WS_DNS_STALE_WHILE_REVALIDATE);
+}
+
+bool ExtraConfig::getAPIFailoverRacing()
+{
+    return getFlagFromExtraConfigLines(WS_API_FAILOVER_RACING);
+}
+
+int ExtraConfig::getPingSamples(bool &success)
+{
+    return getIntFromExtraConfigLines(WS_PING_SAMPLES, success);
+}
+
+QString ExtraConfig::getBestLocationStatistic()
+{
+    return getValue(WS_BEST_LOCATION_STATISTIC).value_or(QString());
+}
+
 bool ExtraConfig::getWireGuardUdpStuffing()
 {
     return getFlagFromExtraConfigLines(WS_WG_UDP_STUFFING);
@@ -53,6 +53,10 @@ public:
     bool getUseICMPPings();
     bool getStealthExtraTLSPadding();
     bool getAPIExtraTLSPadding();
+    bool getDnsStaleWhileRevalidate();
+    bool getAPIFailoverRacing();
+    int getPingSamples(bool &success);
+    QString getBestLocationStatistic();
 
     bool getWireGuardVerboseLogging();
     bool getWireGuardUdpStuffing();
@@ -5,8 +5,15 @@
 #include <QScopeGuard>
 
 #include <arpa/inet.h>
+#include <errno.h>
+#include <ifaddrs.h>
 #include <linux/rtnetlink.h>
 #include <net/if.h>
+#include <netdb.h>
+#include <netinet/ip_icmp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "../logger.h"
@@ -77,7 +84,26 @@ static QList<RoutingTableEntry> getRoutingTable(bool includeZeroMetricEntries)
 
 static QString getAdapterIp(QString interface)
 {
-    return Utils::execCmd(QString("ip -br -4 addr show %1 | grep UP | awk '{print $3}' | cut -d '/' -f 1").arg(interface)).trimmed();
+    struct ifaddrs *ifaddr = nullptr;
+    if (getifaddrs(&ifaddr) != 0) {
+        return QString();
+    }
+
+    QString ret;
+    const std::string ifname = interface.toStdString();
+    for (struct ifaddrs *ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
+        if (ifa->ifa_addr == nullptr || ifa->ifa_addr->sa_family != AF_INET || ifname != ifa->ifa_name) {
+            continue;
+        }
+        // the same as the UP state in the output of ip -br
+        if ((ifa->ifa_flags & (IFF_UP | IFF_RUNNING)) != (IFF_UP | IFF_RUNNING)) {
+            continue;
+        }
+        ret = QHostAddress(ifa->ifa_addr).toString();
+        break;
+    }
+    freeifaddrs(ifaddr);
+    return ret;
 }
 
 void getDefaultRoute(QString &outGatewayIp, QString &outInterfaceName, QString &outAdapterIp, bool ignoreTun)
@@ -144,4 +170,84 @@ QString getLocalIP()
     return sLocalIP;
 }
 
+static bool pingWithMtuViaCommand(const QString &url, int mtu)
+{
+    const QString cmd = QString("ping -c 1 -W 1 -M do -s %1 %2 2> /dev/null").arg(mtu).arg(url);
+    QString result = Utils::execCmd(cmd).trimmed();
+    // the "Frag needed" replies also contain icmp_seq=, only the echo replies contain "bytes from"
+    return result.contains("bytes from");
+}
+
+bool pingWithMtu(const QString &url, int mtu)
+{
+    const int kTimeoutMs = 1000;
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    struct addrinfo *res = nullptr;
+    if (getaddrinfo(url.toStdString().c_str(), nullptr, &hints, &res) != 0 || res == nullptr) {
+        return false;
+    }
+    struct sockaddr_in addr;
+    memcpy(&addr, res->ai_addr, sizeof(addr));
+    freeaddrinfo(res);
+
+    // unprivileged ICMP sockets depend on net.ipv4.ping_group_range, the ping utility is the fallback
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_ICMP);
+    if (fd < 0) {
+        return pingWithMtuViaCommand(QString::fromLatin1(inet_ntoa(addr.sin_addr)), mtu);
+    }
+    auto exitGuard = qScopeGuard([&] {
+        close(fd);
+    });
+
+    // DF flag set, the cached path MTU is ignored so the probe measures the real path
+    int pmtuDisc = IP_PMTUDISC_PROBE;
+    setsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &pmtuDisc, sizeof(pmtuDisc));
+    // report "fragmentation needed" and other ICMP errors as recv() errors instead of waiting for the timeout
+    int recvErr = 1;
+    setsockopt(fd, IPPROTO_IP, IP_RECVERR, &recvErr, sizeof(recvErr));
+
+    QByteArray packet(sizeof(struct icmphdr) + mtu, 0);
+    struct icmphdr *icmp = reinterpret_cast<struct icmphdr *>(packet.data());
+    icmp->type = ICMP_ECHO;
+    icmp->un.echo.sequence = htons(1);
+    // the kernel fills in the identifier and the checksum
+    if (sendto(fd, packet.constData(), packet.size(), 0, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        return false;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    char buf[2048];
+    while (true) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const int elapsedMs = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        if (elapsedMs >= kTimeoutMs) {
+            return false;
+        }
+
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int ret = poll(&pfd, 1, kTimeoutMs - elapsedMs);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0 || (pfd.revents & POLLERR)) {
+            return false;
+        }
+
+        // the reply is truncated to the header, the payload is not needed
+        ssize_t len = recv(fd, buf, sizeof(buf), MSG_TRUNC);
+        if (len < 0) {
+            return false;
+        }
+        const struct icmphdr *reply = reinterpret_cast<const struct icmphdr *>(buf);
+        if (len >= (ssize_t)sizeof(struct icmphdr) && reply->type == ICMP_ECHOREPLY && reply->un.echo.sequence == htons(1)) {
+            return true;
+        }
+    }
+}
+
 } // namespace NetworkUtils_linux
@@ -20,5 +20,7 @@ public:
 
 void getDefaultRoute(QString &outGatewayIp, QString &outInterfaceName, QString &outAdapterIp, bool ignoreTun = false);
 QString getLocalIP();
+// sends a single ICMP echo with the DF flag set and the payload of mtu bytes
+bool pingWithMtu(const QString &url, int mtu);
 
 } // namespace NetworkUtils_linux
@@ -26,6 +26,7 @@ void ApiInfo::setSessionStatus(const api_responses::SessionStatus &value)
 {
     isSessionStatusInit_ = true;
     sessionStatus_ = value;
+    dirtySections_ |= kSessionStatus;
     QSettings settings;
     settings.setValue("userId", sessionStatus_.getUserId());    // need for uninstaller program for open post uninstall webpage
 }
@@ -34,14 +35,22 @@ void ApiInfo::setLocations(const QVector<api_responses::Location> &value)
 {
     isLocationsInit_ = true;
     locations_ = value;
+    locationsRecord_.clear();
     mergeWindflixLocations();
+    dirtySections_ |= kLocations;
 }
 
 QVector<api_responses::Location> ApiInfo::getLocations() const
 {
+    loadLocations();
     return locations_;
 }
 
+bool ApiInfo::hasLocations() const
+{
+    return !locationsRecord_.isEmpty() || !locations_.isEmpty();
+}
+
 QStringList ApiInfo::getForceDisconnectNodes() const
 {
     return forceDisconnectNodes_;
@@ -56,6 +65,7 @@ void ApiInfo::setForceDisconnectNodes(const QStringList &value)
 void ApiInfo::setServerCredentials(const ServerCredentials &serverCredentials)
 {
     serverCredentials_ = serverCredentials;
+    dirtySections_ |= kServerCredentials;
 }
 
 ServerCredentials ApiInfo::getServerCredentials() const
@@ -66,11 +76,13 @@ ServerCredentials ApiInfo::getServerCredentials() const
 void ApiInfo::setServerCredentialsOpenVpn(const QString &username, const QString &password)
 {
     serverCredentials_.setForOpenVpn(username, password);
+    dirtySections_ |= kServerCredentials;
 }
 
 void ApiInfo::setServerCredentialsIkev2(const QString &username, const QString &password)
 {
     serverCredentials_.setForIkev2(username, password);
+    dirtySections_ |= kServerCredentials;
 }
 
 bool ApiInfo::isServerCredentialsOpenVpnInit() const
@@ -93,6 +105,7 @@ void ApiInfo::setOvpnConfig(const QString &value)
 {
     isOvpnConfigInit_ = true;
     ovpnConfig_ = value;
+    dirtySections_ |= kOvpnConfig;
 }
 
 // return empty string if auth hash not exist in the settings
@@ -127,12 +140,14 @@ void ApiInfo::setPortMap(const api_responses::PortMap &portMap)
     isPortMapInit_ = true;
     portMap_ = portMap;
     checkPortMapForUnavailableProtocolAndFix();
+    dirtySections_ |= kPortMap;
 }
 
 void ApiInfo::setStaticIps(const api_responses::StaticIps &value)
 {
     isStaticIpsInit_ = true;
     staticIps_ = value;
+    dirtySections_ |= kStaticIps;
 }
 
 api_responses::StaticIps ApiInfo::getStaticIps() const
@@ -142,23 +157,31 @@ api_responses::StaticIps ApiInfo::getStaticIps() const
 
 void ApiInfo::saveToSettings()
 {
-    QByteArray arr;
-    {
-        QDataStream ds(&arr, QIODevice::WriteOnly);
-        ds << magic_;
-        ds << versionForSerialization_;
-        ds << sessionStatus_ << locations_ << serverCredentials_ << ovpnConfig_ << portMap_ << staticIps_;
-    }
+    if (dirtySections_ == 0)
+        return;
+
     QSettings settings;
-    settings.setValue("apiInfo", simpleCrypt_.encryptToString(arr));
-    if (!sessionStatus_.getRevisionHash().isEmpty())
-    {
-        settings.setValue("revisionHash", sessionStatus_.getRevisionHash());
-    }
-    else
-    {
-        settings.remove("revisionHash");
+    if (dirtySections_ & kSessionStatus) {
+        writeSection(settings, kSessionStatus, sessionStatus_);
+        if (!sessionStatus_.getRevisionHash().isEmpty())
+            settings.setValue("revisionHash", sessionStatus_.getRevisionHash());
+        else
+            settings.remove("revisionHash");
     }
+    if (dirtySections_ & kLocations)
+        writeSection(settings, kLocations, locations_);
+    if (dirtySections_ & kServerCredentials)
+        writeSection(settings, kServerCredentials, serverCredentials_);
+    if (dirtySections_ & kOvpnConfig)
+        writeSection(settings, kOvpnConfig, ovpnConfig_);
+    if (dirtySections_ & kPortMap)
+        writeSection(settings, kPortMap, portMap_);
+    if (dirtySections_ & kStaticIps)
+        writeSection(settings, kStaticIps, staticIps_);
+
+    // the single record of the previous versions is replaced by the sections
+    settings.remove("apiInfo");
+    dirtySections_ = 0;
 }
 
 void ApiInfo::removeFromSettings()
@@ -166,6 +189,7 @@ void ApiInfo::removeFromSettings()
     {
         QSettings settings;
         settings.remove("apiInfo");
+        settings.remove(kSectionsGroup);
         settings.remove("authHash");
     }
     // remove from first version too
@@ -185,6 +209,48 @@ bool ApiInfo::isEverythingInit() const
 bool ApiInfo::loadFromSettings()
 {
     QSettings settings;
+    if (!settings.contains(sectionKey(kLocations)))
+        return loadFromLegacySettings(settings);
+
+    if (!readSection(settings.value(sectionKey(kSessionStatus)).toString(), sessionStatus_) ||
+        !readSection(settings.value(sectionKey(kServerCredentials)).toString(), serverCredentials_) ||
+        !readSection(settings.value(sectionKey(kOvpnConfig)).toString(), ovpnConfig_) ||
+        !readSection(settings.value(sectionKey(kPortMap)).toString(), portMap_) ||
+        !readSection(settings.value(sectionKey(kStaticIps)).toString(), staticIps_))
+    {
+        return false;
+    }
+
+    locations_.clear();
+    locationsRecord_ = settings.value(sectionKey(kLocations)).toString();
+    forceDisconnectNodes_.clear();
+    sessionStatus_.setRevisionHash(settings.value("revisionHash", "").toString());
+    isSessionStatusInit_ = true;
+    isLocationsInit_ = true;
+    isForceDisconnectInit_ = true;
+    isOvpnConfigInit_ = true;
+    isPortMapInit_ = true;
+    isStaticIpsInit_ = true;
+    dirtySections_ = 0;
+    checkPortMapForUnavailableProtocolAndFix();
+    return true;
+}
+
+void ApiInfo::loadLocations() const
+{
+    if (locationsRecord_.isEmpty())
+        return;
+
+    if (!readSection(locationsRecord_, locations_)) {
+        qCDebug(LOG_BASIC) << "ApiInfo::loadLocations() - failed to read the locations from settings";
+        locations_.clear();
+    }
+    locationsRecord_.clear();
+}
+
+// the data of the previous versions is stored as a single record
+bool ApiInfo::loadFromLegacySettings(const QSettings &settings)
+{
     QString s = settings.value("apiInfo", "").toString();
     if (!s.isEmpty())
     {
@@ -213,6 +279,8 @@ bool ApiInfo::loadFromSettings()
             isOvpnConfigInit_ = true;
             isPortMapInit_ = true;
             isStaticIpsInit_ = true;
+            // will be converted to the sections on the next save
+            dirtySections_ = kAllSections;
             checkPortMapForUnavailableProtocolAndFix();
             return true;
         }
@@ -220,6 +288,57 @@ bool ApiInfo::loadFromSettings()
     return false;
 }
 
+QString ApiInfo::sectionKey(Section section)
+{
+    switch (section) {
+    case kSessionStatus:
+        return QString(kSectionsGroup) + "/sessionStatus";
+    case kLocations:
+        return QString(kSectionsGroup) + "/locations";
+    case kServerCredentials:
+        return QString(kSectionsGroup) + "/serverCredentials";
+    case kOvpnConfig:
+        return QString(kSectionsGroup) + "/ovpnConfig";
+    case kPortMap:
+        return QString(kSectionsGroup) + "/portMap";
+    case kStaticIps:
+        return QString(kSectionsGroup) + "/staticIps";
+    default:
+        WS_ASSERT(false);
+        return QString();
+    }
+}
+
+template<typename T>
+bool ApiInfo::readSection(const QString &record, T &value) const
+{
+    if (record.isEmpty())
+        return false;
+
+    QByteArray arr = simpleCrypt_.decryptToByteArray(record);
+    QDataStream ds(&arr, QIODevice::ReadOnly);
+    quint32 magic, version;
+    ds >> magic;
+    if (magic != magic_)
+        return false;
+    ds >> version;
+    if (version > versionForSerialization_)
+        return false;
+    ds >> value;
+    return ds.status() == QDataStream::Ok;
+}
+
+template<typename T>
+void ApiInfo::writeSection(QSettings &settings, Section section, const T &value)
+{
+    QByteArray arr;
+    {
+        QDataStream ds(&arr, QIODevice::WriteOnly);
+        ds << magic_ << versionForSerialization_ << value;
+    }
+    settings.setValue(sectionKey(section), simpleCrypt_.encryptToString(arr));
+}
+
 void ApiInfo::mergeWindflixLocations()
 {
     // Build a new list of server locations to merge, removing them from the old list.
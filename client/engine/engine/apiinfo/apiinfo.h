@@ -5,6 +5,7 @@
 #include <QVector>
 #include <QSet>
 #include <QMap>
+#include <QSettings>
 #include "servercredentials.h"
 #include "utils/simplecrypt.h"
 #include "api_responses/staticips.h"
@@ -16,6 +17,8 @@ namespace apiinfo {
 
 // Contains data from the Server API that is minimally necessary for the program to switch from the Login screen to Connect Screen
 // It can also read and save all data in settings.
+// Each section is stored as a separate record, so only the changed sections are rewritten.
+// The locations record is the largest one, it is deserialized on first use.
 class ApiInfo
 {
 public:
@@ -26,6 +29,8 @@ public:
 
     void setLocations(const QVector<api_responses::Location> &value);
     QVector<api_responses::Location> getLocations() const;
+    // does not deserialize the locations record
+    bool hasLocations() const;
 
     QStringList getForceDisconnectNodes() const;
     void setForceDisconnectNodes(const QStringList &value);
@@ -52,6 +57,7 @@ public:
     api_responses::StaticIps getStaticIps() const;
 
     bool loadFromSettings();
+    // saves the sections changed since the last save
     void saveToSettings();
     static void removeFromSettings();
 
@@ -62,13 +68,23 @@ public:
     static QString autoLoginPassword();
 
 private:
+    enum Section { kSessionStatus = 0x01, kLocations = 0x02, kServerCredentials = 0x04, kOvpnConfig = 0x08,
+                   kPortMap = 0x10, kStaticIps = 0x20, kAllSections = 0x3F };
+
     void mergeWindflixLocations();
+    void loadLocations() const;
+    bool loadFromLegacySettings(const QSettings &settings);
+
+    static QString sectionKey(Section section);
+    template<typename T> bool readSection(const QString &record, T &value) const;
+    template<typename T> void writeSection(QSettings &settings, Section section, const T &value);
 
     // remove all not supported protocols on this OS from portMap_
     void checkPortMapForUnavailableProtocolAndFix();
 
     api_responses::SessionStatus sessionStatus_;
-    QVector<api_responses::Location> locations_;
+    mutable QVector<api_responses::Location> locations_;
+    mutable QString locationsRecord_;   // encrypted locations record not yet deserialized
     QStringList forceDisconnectNodes_;
     ServerCredentials serverCredentials_;
     QString ovpnConfig_;
@@ -82,11 +98,14 @@ private:
     bool isPortMapInit_ = false;
     bool isStaticIpsInit_ = false;
 
-    SimpleCrypt simpleCrypt_;
+    quint32 dirtySections_ = 0;
+
+    mutable SimpleCrypt simpleCrypt_;
 
     // for serialization
     static constexpr quint32 magic_ = 0x7605A2AE;
     static constexpr quint32 versionForSerialization_ = 1;  // should increment the version if the data format is changed
+    static constexpr char kSectionsGroup[] = "apiInfoSections";
 };
 
 } //namespace apiinfo
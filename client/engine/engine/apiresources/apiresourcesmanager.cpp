@@ -18,12 +18,20 @@ ApiResourcesManager::ApiResourcesManager(QObject *parent, IConnectStateControlle
 
     fetchTimer_ = new QTimer(this);
     connect(fetchTimer_, &QTimer::timeout, this, &ApiResourcesManager::onFetchTimer);
+
+    saveTimer_ = new QTimer(this);
+    saveTimer_->setSingleShot(true);
+    connect(saveTimer_, &QTimer::timeout, this, &ApiResourcesManager::onSaveTimer);
 }
 
 ApiResourcesManager::~ApiResourcesManager()
 {
     for (auto &it : requestsInProgress_)
         it->cancel();
+
+    // flush the pending changes
+    if (saveTimer_->isActive())
+        onSaveTimer();
 }
 
 void ApiResourcesManager::fetchAllWithAuthHash()
@@ -154,10 +162,19 @@ void ApiResourcesManager::onServerCredentialsIkev2Answer(ServerApiRetCode server
     requestsInProgress_.remove(RequestType::kServerCredentialsIkev2);
 }
 
-void ApiResourcesManager::onServerLocationsAnswer(ServerApiRetCode serverApiRetCode, const std::string &jsonData)
+void ApiResourcesManager::onServerLocationsAnswer(ServerApiRetCode serverApiRetCode, const std::shared_ptr<WSNetServerLocations> &serverLocations)
 {
     if (serverApiRetCode == ServerApiRetCode::kSuccess) {
-        api_responses::ServerList sl(jsonData);
+        // the serverlist is re-fetched on a schedule and usually does not change, wsnet skips parsing it in this case
+        if (serverLocations->isUnchanged() && apiInfo_.hasLocations()) {
+            lastUpdateTimeMs_[RequestType::kLocations] = QDateTime::currentMSecsSinceEpoch();
+            requestsInProgress_.remove(RequestType::kLocations);
+            checkForReadyLogin();
+            return;
+        }
+        locationsRevision_ = serverLocations->payloadHash();
+
+        api_responses::ServerList sl(serverLocations);
         apiInfo_.setLocations(sl.locations());
         apiInfo_.setForceDisconnectNodes(sl.forceDisconnectNodes());
         saveApiInfoToSettings();
@@ -413,9 +430,9 @@ void ApiResourcesManager::fetchLocations()
     if (requestsInProgress_.contains(RequestType::kLocations))
         return;
 
-    auto callback = [this](ServerApiRetCode serverApiRetCode, const std::string &jsonData) {
-        QMetaObject::invokeMethod(this, [this, serverApiRetCode, jsonData] {
-            onServerLocationsAnswer(serverApiRetCode, jsonData);
+    auto callback = [this](ServerApiRetCode serverApiRetCode, std::shared_ptr<WSNetServerLocations> serverLocations) {
+        QMetaObject::invokeMethod(this, [this, serverApiRetCode, serverLocations] {
+            onServerLocationsAnswer(serverApiRetCode, serverLocations);
         });
     };
 
@@ -426,8 +443,11 @@ void ApiResourcesManager::fetchLocations()
         alcList.push_back(it.toStdString());
     }
 
-    requestsInProgress_[RequestType::kLocations] = WSNet::instance()->serverAPI()->serverLocations("en", apiInfo_.getSessionStatus().getRevisionHash().toStdString(),
-                                                                                                   apiInfo_.getSessionStatus().isPremium(), alcList, callback);
+    // the serverlist records are not parsed again if the payload did not change since the last time
+    std::string knownPayloadHash = apiInfo_.hasLocations() ? locationsRevision_ : std::string();
+    requestsInProgress_[RequestType::kLocations] = WSNet::instance()->serverAPI()->serverLocationsRecords("en", apiInfo_.getSessionStatus().getRevisionHash().toStdString(),
+                                                                                                          apiInfo_.getSessionStatus().isPremium(), alcList,
+                                                                                                          knownPayloadHash, callback);
 }
 
 void ApiResourcesManager::fetchPortMap(const QString &authHash)
@@ -535,6 +555,12 @@ void ApiResourcesManager::updateSessionStatus()
 }
 
 void ApiResourcesManager::saveApiInfoToSettings()
+{
+    if (!saveTimer_->isActive())
+        saveTimer_->start(kSaveDelayMs);
+}
+
+void ApiResourcesManager::onSaveTimer()
 {
     if (apiInfo_.isEverythingInit())
         apiInfo_.saveToSettings();
@@ -67,6 +67,7 @@ private slots:
     void onFetchTimer();
     void onConnectivityOnline();
     void onConnectivityTimeoutExpired();
+    void onSaveTimer();
 
 private:
     IConnectStateController *connectStateController_;
@@ -76,10 +77,14 @@ private:
     static constexpr int kMinute = 60 * 1000;
     static constexpr int kHour = 60 * 60 * 1000;
     static constexpr int k24Hours = 24 * 60 * 60 * 1000;
+    // coalesces the settings writes of the answers that come in a burst (for example, at login)
+    static constexpr int kSaveDelayMs = 3000;
 
     QHash<RequestType, qint64> lastUpdateTimeMs_;
     QHash<RequestType, std::shared_ptr<wsnet::WSNetCancelableCallback> > requestsInProgress_;
     QTimer *fetchTimer_;
+    QTimer *saveTimer_;
+    std::string locationsRevision_;     // payload hash of the last parsed serverlist
 
     api_responses::SessionStatus prevSessionStatus_;
     api_responses::SessionStatus prevSessionForLogging_;
@@ -121,7 +126,7 @@ private:
     void onServerConfigsAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
     void onServerCredentialsOpenVpnAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
     void onServerCredentialsIkev2Answer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
-    void onServerLocationsAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
+    void onServerLocationsAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::shared_ptr<wsnet::WSNetServerLocations> &serverLocations);
     void onPortMapAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
     void onStaticIpsAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
     void onNotificationsAnswer(wsnet::ServerApiRetCode serverApiRetCode, const std::string &jsonData);
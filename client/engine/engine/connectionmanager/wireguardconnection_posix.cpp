@@ -20,12 +20,16 @@ public:
     void connect();
     void configure();
     void disconnect();
-    bool getStatus(types::WireGuardStatus *status);
+    bool waitForStatus(types::WireGuardStatus *status, int timeoutMs);
+    void interruptWaitForStatus();
+    void finishWaitForStatus();
     bool stopWireGuard();
 
     QString getAdapterName() const { return adapterName_; }
 
 private:
+    Helper_posix *helperPosix() const { return static_cast<Helper_posix *>(host_->helper_); }
+
     WireGuardConnection *host_;
     QString adapterName_;
     WireGuardConfig config_;
@@ -90,9 +94,19 @@ void WireGuardConnectionImpl::disconnect()
     host_->setCurrentStateAndEmitSignal(WireGuardConnection::ConnectionState::DISCONNECTED);
 }
 
-bool WireGuardConnectionImpl::getStatus(types::WireGuardStatus *status)
+bool WireGuardConnectionImpl::waitForStatus(types::WireGuardStatus *status, int timeoutMs)
+{
+    return isStarted_ && helperPosix()->waitForWireGuardStatus(status, timeoutMs);
+}
+
+void WireGuardConnectionImpl::interruptWaitForStatus()
 {
-    return isStarted_ && host_->helper_->getWireGuardStatus(status);
+    helperPosix()->interruptWireGuardStatusWait();
+}
+
+void WireGuardConnectionImpl::finishWaitForStatus()
+{
+    helperPosix()->finishWireGuardStatusWait();
 }
 
 bool WireGuardConnectionImpl::stopWireGuard()
@@ -147,6 +161,7 @@ void WireGuardConnection::startConnect(const QString &configPathOrUrl, const QSt
     qCDebug(LOG_CONNECTION) << "Connecting WireGuard:" << pimpl_->getAdapterName();
 
     do_stop_thread_ = true;
+    pimpl_->interruptWaitForStatus();
     wait();
     do_stop_thread_ = false;
 
@@ -179,6 +194,7 @@ void WireGuardConnection::startDisconnect()
 
     adapterGatewayInfo_.clear();
     do_stop_thread_ = true;
+    pimpl_->interruptWaitForStatus();
 }
 
 bool WireGuardConnection::isDisconnected() const
@@ -215,13 +231,16 @@ void WireGuardConnection::run()
             break;
         }
         const auto current_state = getCurrentState();
-        unsigned int next_status_check_ms = 100u;
         if (current_state != ConnectionState::DISCONNECTED) {
 
             if (current_state == ConnectionState::CONNECTED)
                 elapsedTimer.invalidate();
 
-            if (!pimpl_->getStatus(&status)) {
+            // blocks until the helper reports a status change, the first call returns the current status
+            int timeoutMs = -1;
+            if (isAutomaticConnectionMode_ && elapsedTimer.isValid())
+                timeoutMs = qMax(0, kTimeoutForAutomatic - (int)elapsedTimer.elapsed());
+            if (!pimpl_->waitForStatus(&status, timeoutMs)) {
                 qCDebug(LOG_WIREGUARD) << "Failed to get WireGuard status";
                 pimpl_->disconnect();
                 break;
@@ -249,7 +268,6 @@ void WireGuardConnection::run()
                 break;
             case types::WireGuardState::CONNECTING:
                 // Connecting (waiting for a handshake).
-                next_status_check_ms = 250u;
                 break;
             case types::WireGuardState::ACTIVE:
             {
@@ -265,18 +283,18 @@ void WireGuardConnection::run()
                     bytesTransmitted = status.bytesTransmitted;
                     emit statisticsUpdated(newBytesReceived, newBytesTransmitted, false);
                 }
-                next_status_check_ms = 500u;
                 break;
             }
             }
+        } else {
+            QThread::msleep(100);
         }
 
         if (isAutomaticConnectionMode_ && elapsedTimer.isValid() && elapsedTimer.elapsed() >= kTimeoutForAutomatic) {
             setError(STATE_TIMEOUT_FOR_AUTOMATIC);
         }
-
-        QThread::msleep(next_status_check_ms);
     }
+    pimpl_->finishWaitForStatus();
 }
 
 void WireGuardConnection::onProcessKillTimeout()
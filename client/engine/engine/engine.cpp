@@ -1718,7 +1718,9 @@ void Engine::detectAppropriatePacketSizeImpl()
         qCDebug(LOG_PACKET_SIZE) << "Detecting appropriate packet size";
         runningPacketDetection_ = true;
         emit packetSizeDetectionStateChanged(true, false);
-        packetSizeController_->detectAppropriatePacketSize(HardcodedSettings::instance().windscribeHost());
+        types::NetworkInterface networkInterface;
+        networkDetectionManager_->getCurrentNetworkInterface(networkInterface);
+        packetSizeController_->detectAppropriatePacketSize(HardcodedSettings::instance().windscribeHost(), networkInterface.networkOrSsid);
     }
     else
     {
@@ -1766,6 +1768,8 @@ void Engine::updateAdvancedParamsImpl()
     // send some parameters to wsnet
     WSNet::instance()->advancedParameters()->setAPIExtraTLSPadding(ExtraConfig::instance().getAPIExtraTLSPadding() || engineSettings_.isAntiCensorship());
     WSNet::instance()->advancedParameters()->setLogApiResponce(ExtraConfig::instance().getLogAPIResponse());
+    WSNet::instance()->advancedParameters()->setDnsStaleWhileRevalidate(ExtraConfig::instance().getDnsStaleWhileRevalidate());
+    WSNet::instance()->advancedParameters()->setAPIFailoverRacing(ExtraConfig::instance().getAPIFailoverRacing());
     std::optional<QString> countryOverride = ExtraConfig::instance().serverlistCountryOverride();
     WSNet::instance()->advancedParameters()->setCountryOverrideValue(countryOverride.has_value() ? countryOverride->toStdString() : "");
     WSNet::instance()->advancedParameters()->setIgnoreCountryOverride(ExtraConfig::instance().serverListIgnoreCountryOverride());
@@ -2021,6 +2025,8 @@ void Engine::onNetworkOnlineStateChange(bool isOnline)
 
 void Engine::onNetworkChange(const types::NetworkInterface &networkInterface)
 {
+    WSNet::instance()->setCurrentNetwork(networkInterface.networkOrSsid.toStdString());
+
     if (!networkInterface.networkOrSsid.isEmpty()) {
         if (apiResourcesManager_) {
             connectionManager_->updateConnectionSettings(
@@ -7,7 +7,7 @@
 #include "engine/helper/ihelper.h"
 
 FirewallController_linux::FirewallController_linux(QObject *parent, IHelper *helper) :
-    FirewallController(parent), forceUpdateInterfaceToSkip_(false), comment_("Windscribe client rule")
+    FirewallController(parent), forceUpdateInterfaceToSkip_(false), isIpSetUsed_(false), comment_("Windscribe client rule")
 {
     helper_ = dynamic_cast<Helper_linux *>(helper);
 }
@@ -19,8 +19,15 @@ FirewallController_linux::~FirewallController_linux()
 bool FirewallController_linux::firewallOn(const QString &connectingIp, const QSet<QString> &ips, bool bAllowLanTraffic, bool bIsCustomConfig)
 {
     QMutexLocker locker(&mutex_);
+    const bool isOnlyIpsChanged = bInitialized_ && latestEnabledState_ && latestConnectingIp_ == connectingIp &&
+                                  latestAllowLanTraffic_ == bAllowLanTraffic && latestIsCustomConfig_ == bIsCustomConfig;
     FirewallController::firewallOn(connectingIp, ips, bAllowLanTraffic, bIsCustomConfig);
     if (isStateChanged()) {
+        // the rules match the whitelisted ips by the ipset, so only the set needs an update
+        if (isOnlyIpsChanged && isIpSetUsed_ && !forceUpdateInterfaceToSkip_ && firewallActualState() && helper_->setFirewallIps(ips)) {
+            qCDebug(LOG_FIREWALL_CONTROLLER) << "firewall ips changed, count:" << ips.count();
+            return true;
+        }
         qCDebug(LOG_FIREWALL_CONTROLLER) << "firewall enabled with ips count:" << ips.count() + 1;
         return firewallOnImpl(connectingIp, ips, bAllowLanTraffic, bIsCustomConfig, latestStaticIpPorts_);
     } else if (forceUpdateInterfaceToSkip_) {
@@ -44,6 +51,7 @@ bool FirewallController_linux::firewallOff()
         // remove IPv6 rules
         removeWindscribeRules(comment_, true);
 
+        isIpSetUsed_ = false;
         bool ret = helper_->clearFirewallRules(false);
         if (!ret) {
             qCDebug(LOG_FIREWALL_CONTROLLER) << "Clear firewall rules unsuccessful:" << ret;
@@ -99,6 +107,12 @@ bool FirewallController_linux::firewallOnImpl(const QString &connectingIp, const
     forceUpdateInterfaceToSkip_ = false;
     bool bExists = firewallActualState();
 
+    // the set must exist before the rules referencing it are applied, fall back to the per-ip rules if ipset is not available
+    isIpSetUsed_ = helper_->setFirewallIps(ips);
+    if (!isIpSetUsed_) {
+        qCDebug(LOG_FIREWALL_CONTROLLER) << "Could not set the firewall ipset, using per-ip rules";
+    }
+
     // rules for IPv4
     {
         QStringList rules;
@@ -162,9 +176,14 @@ bool FirewallController_linux::firewallOnImpl(const QString &connectingIp, const
             rules << "-A windscribe_output -d " + connectingIp + "/32 -j ACCEPT -m mark --mark 51820 -m comment --comment \"" + comment_ + "\"\n";
         }
 
-        for (const auto &i : ips) {
-            rules << "-A windscribe_input -s " + i + "/32 -j ACCEPT -m comment --comment \"" + comment_ + "\"\n";
-            rules << "-A windscribe_output -d " + i + "/32 -j ACCEPT -m comment --comment \"" + comment_ + "\"\n";
+        if (isIpSetUsed_) {
+            rules << "-A windscribe_input -m set --match-set " HELPER_FIREWALL_IPSET " src -j ACCEPT -m comment --comment \"" + comment_ + "\"\n";
+            rules << "-A windscribe_output -m set --match-set " HELPER_FIREWALL_IPSET " dst -j ACCEPT -m comment --comment \"" + comment_ + "\"\n";
+        } else {
+            for (const auto &i : ips) {
+                rules << "-A windscribe_input -s " + i + "/32 -j ACCEPT -m comment --comment \"" + comment_ + "\"\n";
+                rules << "-A windscribe_output -d " + i + "/32 -j ACCEPT -m comment --comment \"" + comment_ + "\"\n";
+            }
         }
 
         // drop filter for the hotspot adapter in the disconnected state
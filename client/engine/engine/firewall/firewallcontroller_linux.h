@@ -25,6 +25,7 @@ private:
     Helper_linux *helper_;
     QString interfaceToSkip_;
     bool forceUpdateInterfaceToSkip_;
+    bool isIpSetUsed_;      // the whitelisted ips are matched by the ipset of the helper
     QRecursiveMutex mutex_;
     QString pathToTempTable_;
     QString comment_;
@@ -1,17 +1,26 @@
 #include "helper_linux.h"
 
 #include <QProcess>
+#include <errno.h>
+#include <poll.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include "../../../../backend/posix_common/helper_commands_serialize.h"
 #include "utils/logger.h"
 
-Helper_linux::Helper_linux(QObject *parent) : Helper_posix(parent)
+Helper_linux::Helper_linux(QObject *parent) : Helper_posix(parent), isStatusFeedUnavailable_(false)
 {
+    statusInterruptFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 }
 
 Helper_linux::~Helper_linux()
 {
+    closeWireGuardStatusFeed();
+    if (statusInterruptFd_ != -1) {
+        close(statusInterruptFd_);
+    }
 }
 
 void Helper_linux::startInstallHelper()
@@ -29,6 +38,121 @@ QString Helper_linux::getHelperVersion()
     return "";
 }
 
+bool Helper_linux::waitForWireGuardStatus(types::WireGuardStatus *status, int timeoutMs)
+{
+    if (!statusSocket_ && !isStatusFeedUnavailable_) {
+        if (subscribeToWireGuardStatus(status)) {
+            return true;
+        }
+        qCDebug(LOG_BASIC) << "WireGuard status feed is not available, polling the helper";
+        isStatusFeedUnavailable_ = true;
+    }
+    if (!statusSocket_ || statusInterruptFd_ == -1) {
+        return Helper_posix::waitForWireGuardStatus(status, timeoutMs);
+    }
+
+    struct pollfd fds[2] = { { statusSocket_->native_handle(), POLLIN, 0 }, { statusInterruptFd_, POLLIN, 0 } };
+    int ret = poll(fds, 2, timeoutMs);
+    if (ret < 0) {
+        return errno == EINTR;
+    }
+    if (ret == 0) {
+        // timeout, the status is unchanged
+        return true;
+    }
+    if (fds[1].revents & POLLIN) {
+        eventfd_t value;
+        eventfd_read(statusInterruptFd_, &value);
+        return true;
+    }
+
+    uint32_t requestId;
+    CMD_ANSWER answer;
+    if (!readAnswer(*statusSocket_, statusBuf_, requestId, answer) || !answer.executed) {
+        qCDebug(LOG_BASIC) << "WireGuard status feed closed by the helper";
+        closeWireGuardStatusFeed();
+        return false;
+    }
+    answerToWireGuardStatus(answer, status);
+    return true;
+}
+
+void Helper_linux::interruptWireGuardStatusWait()
+{
+    Helper_posix::interruptWireGuardStatusWait();
+    if (statusInterruptFd_ != -1) {
+        eventfd_write(statusInterruptFd_, 1);
+    }
+}
+
+void Helper_linux::finishWireGuardStatusWait()
+{
+    Helper_posix::finishWireGuardStatusWait();
+    closeWireGuardStatusFeed();
+    isStatusFeedUnavailable_ = false;
+    if (statusInterruptFd_ != -1) {
+        eventfd_t value;
+        eventfd_read(statusInterruptFd_, &value);
+    }
+}
+
+bool Helper_linux::subscribeToWireGuardStatus(types::WireGuardStatus *status)
+{
+    if (curState_ != STATE_CONNECTED) {
+        return false;
+    }
+
+    // the same cadence as the polling of an active tunnel for the counters, the state changes are pushed at once
+    CMD_SUBSCRIBE_WIREGUARD_STATUS cmd;
+    cmd.checkIntervalMs = 250;
+    cmd.statsIntervalMs = 500;
+    cmd.keepAliveMs = 10000;
+    std::stringstream stream;
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
+    oa << cmd;
+
+    statusSocket_.reset(new boost::asio::local::stream_protocol::socket(statusIoService_));
+    boost::system::error_code ec;
+    statusSocket_->connect(ep_, ec);
+
+    // the first answer is the current status, the feed has a connection of its own and all its answers
+    // carry the request id of the subscription
+    uint32_t requestId;
+    CMD_ANSWER answer;
+    if (ec || !writeRequest(*statusSocket_, 0, HELPER_CMD_SUBSCRIBE_WIREGUARD_STATUS, stream.str()) ||
+        !readAnswer(*statusSocket_, statusBuf_, requestId, answer) || !answer.executed) {
+        closeWireGuardStatusFeed();
+        return false;
+    }
+    answerToWireGuardStatus(answer, status);
+    return true;
+}
+
+void Helper_linux::closeWireGuardStatusFeed()
+{
+    if (statusSocket_) {
+        boost::system::error_code ec;
+        statusSocket_->close(ec);
+        statusSocket_.reset();
+    }
+}
+
+bool Helper_linux::setFirewallIps(const QSet<QString> &ips)
+{
+    CMD_ANSWER answer;
+    CMD_SET_FIREWALL_IPS cmd;
+    cmd.ips.reserve(ips.size());
+    for (const auto &ip : ips) {
+        cmd.ips.push_back(ip.toStdString());
+    }
+
+    std::stringstream stream;
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
+    oa << cmd;
+
+    return runCommand(HELPER_CMD_SET_FIREWALL_IPS, stream.str(), answer) && answer.executed;
+}
+
 std::optional<bool> Helper_linux::installUpdate(const QString &package) const
 {
     QProcess process;
@@ -45,14 +169,12 @@ std::optional<bool> Helper_linux::installUpdate(const QString &package) const
 
 bool Helper_linux::setDnsLeakProtectEnabled(bool bEnabled)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_ANSWER answer;
     CMD_SET_DNS_LEAK_PROTECT_ENABLED cmd;
     cmd.enabled = bEnabled;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_DNS_LEAK_PROTECT_ENABLED, stream.str(), answer);
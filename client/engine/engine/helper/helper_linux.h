@@ -14,7 +14,24 @@ public:
     bool reinstallHelper() override;
     QString getHelperVersion() override;
 
+    // WireGuard status feed of the helper
+    bool waitForWireGuardStatus(types::WireGuardStatus *status, int timeoutMs) override;
+    void interruptWireGuardStatusWait() override;
+    void finishWireGuardStatusWait() override;
+
     // linux specific
     std::optional<bool> installUpdate(const QString& package) const;
     bool setDnsLeakProtectEnabled(bool bEnabled);
+    bool setFirewallIps(const QSet<QString> &ips);
+
+private:
+    // a separate connection which the helper pushes the WireGuard status to, used only by the waiting thread
+    boost::asio::io_service statusIoService_;
+    std::unique_ptr<boost::asio::local::stream_protocol::socket> statusSocket_;
+    std::vector<char> statusBuf_;
+    bool isStatusFeedUnavailable_;
+    int statusInterruptFd_;     // eventfd to wake up the waiting thread
+
+    bool subscribeToWireGuardStatus(types::WireGuardStatus *status);
+    void closeWireGuardStatusFeed();
 };
@@ -76,7 +76,6 @@ bool Helper_mac::reinstallHelper()
 
 QString Helper_mac::getHelperVersion()
 {
-    QMutexLocker locker(&mutex_);
     CMD_ANSWER answer;
     if (runCommand(HELPER_CMD_HELPER_VERSION, std::string(), answer))
         return QString::fromStdString(answer.body);
@@ -86,15 +85,13 @@ QString Helper_mac::getHelperVersion()
 
 bool Helper_mac::setMacAddress(const QString &interface, const QString &macAddress)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_SET_MAC_ADDRESS cmd;
     CMD_ANSWER answer;
     cmd.interface = interface.toStdString();
     cmd.macAddress = macAddress.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_MAC_ADDRESS, stream.str(), answer);
@@ -103,8 +100,6 @@ bool Helper_mac::setMacAddress(const QString &interface, const QString &macAddre
 
 bool Helper_mac::enableMacSpoofingOnBoot(bool bEnabled, const QString &interface, const QString &macAddress)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_SET_MAC_SPOOFING_ON_BOOT cmd;
     CMD_ANSWER answer;
     cmd.enabled = bEnabled;
@@ -112,7 +107,7 @@ bool Helper_mac::enableMacSpoofingOnBoot(bool bEnabled, const QString &interface
     cmd.macAddress = macAddress.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_MAC_SPOOFING_ON_BOOT, stream.str(), answer);
@@ -120,8 +115,6 @@ bool Helper_mac::enableMacSpoofingOnBoot(bool bEnabled, const QString &interface
 
 bool Helper_mac::setDnsOfDynamicStoreEntry(const QString &ipAddress, const QString &entry)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_APPLY_CUSTOM_DNS cmd;
     cmd.ipAddress = ipAddress.toStdString();
     cmd.networkService = entry.toStdString();
@@ -130,7 +123,7 @@ bool Helper_mac::setDnsOfDynamicStoreEntry(const QString &ipAddress, const QStri
         return false;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -143,14 +136,12 @@ bool Helper_mac::setDnsOfDynamicStoreEntry(const QString &ipAddress, const QStri
 
 bool Helper_mac::setIpv6Enabled(bool bEnabled)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_ANSWER answer;
     CMD_SET_IPV6_ENABLED cmd;
     cmd.enabled = bEnabled;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_IPV6_ENABLED, stream.str(), answer);
@@ -163,7 +154,11 @@ void Helper_mac::doDisconnectAndReconnect()
 
 bool Helper_mac::runCommand(int cmdId, const std::string &data, CMD_ANSWER &answer)
 {
+    // the XPC transport has no request ids, the commands are sent one at a time
+    QMutexLocker locker(&mutex_);
+
     xpc_object_t message = xpc_dictionary_create(NULL, NULL, 0);
+    xpc_dictionary_set_int64(message, "version", HELPER_PROTOCOL_VERSION);
     xpc_dictionary_set_int64(message, "cmdId", cmdId);
     xpc_dictionary_set_data(message, "data", data.c_str(), data.size());
     xpc_object_t answer_object = xpc_connection_send_message_with_reply_sync(connection_, message);
@@ -175,10 +170,14 @@ bool Helper_mac::runCommand(int cmdId, const std::string &data, CMD_ANSWER &answ
         size_t length;
         const void *buf = xpc_dictionary_get_data(answer_object, "data", &length);
         if (buf && length > 0) {
-            std::string str((char *)buf, length);
-            std::istringstream stream(str);
-            boost::archive::text_iarchive ia(stream, boost::archive::no_header);
-            ia >> answer;
+            HelperMemoryStreamBuf stream((const char *)buf, length);
+            try {
+                boost::archive::binary_iarchive ia(stream, boost::archive::no_header);
+                ia >> answer;
+            } catch (const std::exception &e) {
+                qCDebug(LOG_BASIC) << "Malformed answer from helper:" << e.what();
+                return false;
+            }
             return true;
         } else {
             return false;
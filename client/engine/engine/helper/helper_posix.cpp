@@ -57,8 +57,6 @@ void Helper_posix::setNeedFinish()
 
 void Helper_posix::getUnblockingCmdStatus(unsigned long cmdId, QString &outLog, bool &outFinished)
 {
-    QMutexLocker locker(&mutex_);
-
     outFinished = false;
     if (curState_ != STATE_CONNECTED)
     {
@@ -69,7 +67,7 @@ void Helper_posix::getUnblockingCmdStatus(unsigned long cmdId, QString &outLog,
     cmd.cmdId = cmdId;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -86,8 +84,6 @@ void Helper_posix::clearUnblockingCmd(unsigned long cmdId)
 {
     Q_UNUSED(cmdId);
 
-    QMutexLocker locker(&mutex_);
-
     if (curState_ != STATE_CONNECTED) {
         return;
     }
@@ -95,7 +91,7 @@ void Helper_posix::clearUnblockingCmd(unsigned long cmdId)
     CMD_CLEAR_CMDS cmd;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -114,8 +110,6 @@ bool Helper_posix::setSplitTunnelingSettings(bool isActive, bool isExclude,
                                            bool isAllowLanTraffic, const QStringList &files,
                                            const QStringList &ips, const QStringList &hosts)
 {
-    QMutexLocker locker(&mutex_);
-
     if (curState_ != STATE_CONNECTED) {
         return false;
     }
@@ -138,7 +132,7 @@ bool Helper_posix::setSplitTunnelingSettings(bool isActive, bool isExclude,
     }
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmdSplitTunnelingSettings;
 
     CMD_ANSWER answer;
@@ -155,7 +149,6 @@ bool Helper_posix::sendConnectStatus(bool isConnected, bool isTerminateSocket, b
 {
     Q_UNUSED(isTerminateSocket);
     Q_UNUSED(isKeepLocalSocket);
-    QMutexLocker locker(&mutex_);
 
     if (curState_ != STATE_CONNECTED) {
         return false;
@@ -199,7 +192,7 @@ bool Helper_posix::sendConnectStatus(bool isConnected, bool isTerminateSocket, b
     }
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -216,15 +209,13 @@ bool Helper_posix::sendConnectStatus(bool isConnected, bool isTerminateSocket, b
 
 bool Helper_posix::changeMtu(const QString &adapter, int mtu)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_ANSWER answer;
     CMD_CHANGE_MTU cmd;
     cmd.mtu = mtu;
     cmd.adapterName = adapter.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_CHANGE_MTU, stream.str(), answer);
@@ -232,8 +223,6 @@ bool Helper_posix::changeMtu(const QString &adapter, int mtu)
 
 bool Helper_posix::deleteRoute(const QString &range, int mask, const QString &gateway)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_ANSWER answer;
     CMD_DELETE_ROUTE cmd;
     cmd.range = range.toStdString();
@@ -241,7 +230,7 @@ bool Helper_posix::deleteRoute(const QString &range, int mask, const QString &ga
     cmd.gateway = gateway.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_DELETE_ROUTE, stream.str(), answer);
@@ -249,8 +238,6 @@ bool Helper_posix::deleteRoute(const QString &range, int mask, const QString &ga
 
 IHelper::ExecuteError Helper_posix::startWireGuard()
 {
-    QMutexLocker locker(&mutex_);
-
     if (curState_ != STATE_CONNECTED) {
         return IHelper::EXECUTE_ERROR;
     }
@@ -267,8 +254,6 @@ IHelper::ExecuteError Helper_posix::startWireGuard()
 bool Helper_posix::stopWireGuard()
 {
     if (curState_ == STATE_CONNECTED) {
-        QMutexLocker locker(&mutex_);
-
         CMD_ANSWER answer;
         if (!runCommand(HELPER_CMD_STOP_WIREGUARD, "", answer)) {
             doDisconnectAndReconnect();
@@ -283,8 +268,6 @@ bool Helper_posix::stopWireGuard()
 
 bool Helper_posix::configureWireGuard(const WireGuardConfig &config)
 {
-    QMutexLocker locker(&mutex_);
-
     if (curState_ != STATE_CONNECTED)
         return false;
 
@@ -316,7 +299,7 @@ bool Helper_posix::configureWireGuard(const WireGuardConfig &config)
     cmd.listenPort = config.clientListenPort().toUInt();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -330,8 +313,6 @@ bool Helper_posix::configureWireGuard(const WireGuardConfig &config)
 
 bool Helper_posix::getWireGuardStatus(types::WireGuardStatus *status)
 {
-    QMutexLocker locker(&mutex_);
-
     if (status) {
         status->state = types::WireGuardState::NONE;
         status->errorCode = 0;
@@ -350,6 +331,55 @@ bool Helper_posix::getWireGuardStatus(types::WireGuardStatus *status)
         return false;
     }
 
+    answerToWireGuardStatus(answer, status);
+    return true;
+}
+
+bool Helper_posix::waitForWireGuardStatus(types::WireGuardStatus *status, int timeoutMs)
+{
+    // no status feed from the helper, poll it with a cadence depending on the state
+    int pollMs = 100;
+    if (status->state == types::WireGuardState::CONNECTING) {
+        pollMs = 250;
+    } else if (status->state == types::WireGuardState::ACTIVE) {
+        pollMs = 500;
+    }
+    if (timeoutMs >= 0) {
+        pollMs = qMin(pollMs, timeoutMs);
+    }
+
+    {
+        QMutexLocker locker(&waitStatusMutex_);
+        if (!isWaitStatusInterrupted_) {
+            waitStatusCondition_.wait(&waitStatusMutex_, pollMs);
+        }
+        if (isWaitStatusInterrupted_) {
+            isWaitStatusInterrupted_ = false;
+            return true;
+        }
+    }
+    return getWireGuardStatus(status);
+}
+
+void Helper_posix::interruptWireGuardStatusWait()
+{
+    QMutexLocker locker(&waitStatusMutex_);
+    isWaitStatusInterrupted_ = true;
+    waitStatusCondition_.wakeAll();
+}
+
+void Helper_posix::finishWireGuardStatusWait()
+{
+    QMutexLocker locker(&waitStatusMutex_);
+    isWaitStatusInterrupted_ = false;
+}
+
+void Helper_posix::answerToWireGuardStatus(const CMD_ANSWER &answer, types::WireGuardStatus *status)
+{
+    status->state = types::WireGuardState::NONE;
+    status->errorCode = 0;
+    status->bytesReceived = status->bytesTransmitted = 0;
+
     switch (answer.cmdId) {
     default:
     case kWgStateNone:
@@ -374,13 +404,10 @@ bool Helper_posix::getWireGuardStatus(types::WireGuardStatus *status)
         status->bytesTransmitted = answer.customInfoValue[1];
         break;
     }
-    return true;
 }
 
 IHelper::ExecuteError Helper_posix::startCtrld(const QString &ip, const QString &upstream1, const QString &upstream2, const QStringList &domains, bool isCreateLog)
 {
-    QMutexLocker locker(&mutex_);
-
     if (curState_ != STATE_CONNECTED) {
         return IHelper::EXECUTE_ERROR;
     }
@@ -398,7 +425,7 @@ IHelper::ExecuteError Helper_posix::startCtrld(const QString &ip, const QString
     cmd.isCreateLog = isCreateLog;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -420,8 +447,6 @@ IHelper::ExecuteError Helper_posix::executeOpenVPN(const QString &config, unsign
                                                    const QString &socksProxy, unsigned int socksPort, unsigned long &outCmdId, bool isCustomConfig)
 
 {
-    QMutexLocker locker(&mutex_);
-
     if (curState_ != STATE_CONNECTED) {
         return IHelper::EXECUTE_ERROR;
     }
@@ -451,7 +476,7 @@ IHelper::ExecuteError Helper_posix::executeOpenVPN(const QString &config, unsign
 #endif
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -466,14 +491,12 @@ IHelper::ExecuteError Helper_posix::executeOpenVPN(const QString &config, unsign
 
 bool Helper_posix::executeTaskKill(CmdKillTarget target)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_TASK_KILL cmd;
     CMD_ANSWER answer;
     cmd.target = target;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_TASK_KILL, stream.str(), answer);
@@ -481,14 +504,12 @@ bool Helper_posix::executeTaskKill(CmdKillTarget target)
 
 bool Helper_posix::setDnsScriptEnabled(bool bEnabled)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_SET_DNS_SCRIPT_ENABLED cmd;
     CMD_ANSWER answer;
     cmd.enabled = bEnabled;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_DNS_SCRIPT_ENABLED, stream.str(), answer);
@@ -496,14 +517,12 @@ bool Helper_posix::setDnsScriptEnabled(bool bEnabled)
 
 bool Helper_posix::checkFirewallState(const QString &tag)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_CHECK_FIREWALL_STATE cmd;
     CMD_ANSWER answer;
     cmd.tag = tag.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     if (!runCommand(HELPER_CMD_CHECK_FIREWALL_STATE, stream.str(), answer)) {
@@ -514,14 +533,12 @@ bool Helper_posix::checkFirewallState(const QString &tag)
 
 bool Helper_posix::clearFirewallRules(bool isKeepPfEnabled)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_CLEAR_FIREWALL_RULES cmd;
     CMD_ANSWER answer;
     cmd.isKeepPfEnabled = isKeepPfEnabled;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_CLEAR_FIREWALL_RULES, stream.str(), answer);
@@ -529,8 +546,6 @@ bool Helper_posix::clearFirewallRules(bool isKeepPfEnabled)
 
 bool Helper_posix::setFirewallRules(CmdIpVersion version, const QString &table, const QString &group, const QString &rules)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_SET_FIREWALL_RULES cmd;
     CMD_ANSWER answer;
     cmd.ipVersion = version;
@@ -539,7 +554,7 @@ bool Helper_posix::setFirewallRules(CmdIpVersion version, const QString &table,
     cmd.rules = rules.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_FIREWALL_RULES, stream.str(), answer);
@@ -547,8 +562,6 @@ bool Helper_posix::setFirewallRules(CmdIpVersion version, const QString &table,
 
 bool Helper_posix::getFirewallRules(CmdIpVersion version, const QString &table, const QString &group, QString &rules)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_GET_FIREWALL_RULES cmd;
     CMD_ANSWER answer;
     cmd.ipVersion = version;
@@ -556,7 +569,7 @@ bool Helper_posix::getFirewallRules(CmdIpVersion version, const QString &table,
     cmd.group = group.toStdString();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     if (!runCommand(HELPER_CMD_GET_FIREWALL_RULES, stream.str(), answer)) {
@@ -568,8 +581,6 @@ bool Helper_posix::getFirewallRules(CmdIpVersion version, const QString &table,
 
 bool Helper_posix::setFirewallOnBoot(bool bEnabled, const QSet<QString> &ipTable)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_SET_FIREWALL_ON_BOOT cmd;
     CMD_ANSWER answer;
     cmd.enabled = bEnabled;
@@ -583,7 +594,7 @@ bool Helper_posix::setFirewallOnBoot(bool bEnabled, const QSet<QString> &ipTable
     cmd.ipTable = ipTableStr;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_SET_FIREWALL_ON_BOOT, stream.str(), answer);
@@ -591,8 +602,6 @@ bool Helper_posix::setFirewallOnBoot(bool bEnabled, const QSet<QString> &ipTable
 
 bool Helper_posix::startStunnel(const QString &hostname, unsigned int port, unsigned int localPort, bool extraPadding)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_START_STUNNEL cmd;
     cmd.hostname = hostname.toStdString();
     cmd.port = port;
@@ -600,7 +609,7 @@ bool Helper_posix::startStunnel(const QString &hostname, unsigned int port, unsi
     cmd.extraPadding = extraPadding;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -614,15 +623,13 @@ bool Helper_posix::startStunnel(const QString &hostname, unsigned int port, unsi
 
 bool Helper_posix::startWstunnel(const QString &hostname, unsigned int port, unsigned int localPort)
 {
-    QMutexLocker locker(&mutex_);
-
     CMD_START_WSTUNNEL cmd;
     cmd.hostname = hostname.toStdString();
     cmd.port = port;
     cmd.localPort = localPort;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     CMD_ANSWER answer;
@@ -683,6 +690,7 @@ void Helper_posix::connectHandler(const boost::system::error_code &ec)
 
 void Helper_posix::doDisconnectAndReconnect()
 {
+    QMutexLocker locker(&mutex_);
     if (!isRunning())
     {
         qCDebug(LOG_BASIC) << "Disconnected from helper socket, try reconnect";
@@ -693,66 +701,97 @@ void Helper_posix::doDisconnectAndReconnect()
 
 bool Helper_posix::runCommand(int cmdId, const std::string &data, CMD_ANSWER &answer)
 {
-    bool ret = sendCmdToHelper(cmdId, data);
-    if (!ret) {
-        return ret;
+    QMutexLocker locker(&requestMutex_);
+
+    // the commands are written in the order of their request ids, the helper answers them in the same order
+    const uint32_t requestId = nextRequestId_++;
+    if (!writeRequest(*socket_, requestId, cmdId, data)) {
+        locker.unlock();
+        doDisconnectAndReconnect();
+        return false;
     }
 
-    return readAnswer(answer);
-}
+    while (true) {
+        auto it = receivedAnswers_.find(requestId);
+        if (it != receivedAnswers_.end()) {
+            answer = std::move(it->second);
+            receivedAnswers_.erase(it);
+            return true;
+        }
 
-bool Helper_posix::readAnswer(CMD_ANSWER &outAnswer)
-{
-    boost::system::error_code ec;
-    int length;
-    boost::asio::read(*socket_, boost::asio::buffer(&length, sizeof(length)),
-                      boost::asio::transfer_exactly(sizeof(length)), ec);
-    if (ec) {
-        return false;
-    } else {
-        std::vector<char> buff(length);
-        boost::asio::read(*socket_, boost::asio::buffer(&buff[0], length),
-                          boost::asio::transfer_exactly(length), ec);
-        if (ec) {
-            return false;
+        if (isReadingAnswer_) {
+            // another thread reads the answers, ours is behind the one it waits for
+            answerCondition_.wait(&requestMutex_);
+            continue;
         }
 
-        std::string str(buff.begin(), buff.end());
-        std::istringstream stream(str);
-        boost::archive::text_iarchive ia(stream, boost::archive::no_header);
-        ia >> outAnswer;
+        // read the answers until ours, the other threads can write their commands meanwhile
+        isReadingAnswer_ = true;
+        locker.unlock();
+        uint32_t answerRequestId;
+        CMD_ANSWER received;
+        const bool isRead = readAnswer(*socket_, answerBuf_, answerRequestId, received);
+        locker.relock();
+        isReadingAnswer_ = false;
+        // wake up the owner of the answer or a thread that takes over the reading
+        answerCondition_.wakeAll();
+
+        if (!isRead) {
+            return false;
+        }
+        if (answerRequestId == requestId) {
+            answer = std::move(received);
+            return true;
+        }
+        receivedAnswers_[answerRequestId] = std::move(received);
     }
-
-    return true;
 }
 
-bool Helper_posix::sendCmdToHelper(int cmdId, const std::string &data)
+bool Helper_posix::readAnswer(boost::asio::local::stream_protocol::socket &socket, std::vector<char> &buf, uint32_t &outRequestId, CMD_ANSWER &outAnswer)
 {
-    int length = data.size();
     boost::system::error_code ec;
-
-    // first 4 bytes - cmdId
-    boost::asio::write(*socket_, boost::asio::buffer(&cmdId, sizeof(cmdId)), boost::asio::transfer_exactly(sizeof(cmdId)), ec);
+    HELPER_ANSWER_HEADER header;
+    boost::asio::read(socket, boost::asio::buffer(&header, sizeof(header)),
+                      boost::asio::transfer_exactly(sizeof(header)), ec);
     if (ec) {
         return false;
     }
-    // second 4 bytes - pid
-    const auto pid = getpid();
-    boost::asio::write(*socket_, boost::asio::buffer(&pid, sizeof(pid)), boost::asio::transfer_exactly(sizeof(pid)), ec);
-    if (ec) {
+    if (header.version != HELPER_PROTOCOL_VERSION) {
+        qCDebug(LOG_BASIC) << "Unsupported helper protocol version:" << header.version;
         return false;
     }
-    // third 4 bytes - size of buffer
-    boost::asio::write(*socket_, boost::asio::buffer(&length, sizeof(length)), boost::asio::transfer_exactly(sizeof(length)), ec);
+
+    buf.resize(header.size);
+    boost::asio::read(socket, boost::asio::buffer(buf.data(), header.size),
+                      boost::asio::transfer_exactly(header.size), ec);
     if (ec) {
         return false;
     }
-    // body of message
-    boost::asio::write(*socket_, boost::asio::buffer(data.data(), length), boost::asio::transfer_exactly(length), ec);
-    if (ec) {
-        doDisconnectAndReconnect();
+
+    HelperMemoryStreamBuf stream(buf.data(), buf.size());
+    try {
+        boost::archive::binary_iarchive ia(stream, boost::archive::no_header);
+        ia >> outAnswer;
+    } catch (const std::exception &e) {
+        qCDebug(LOG_BASIC) << "Malformed answer from helper:" << e.what();
         return false;
     }
-
+    outRequestId = header.requestId;
     return true;
 }
+
+bool Helper_posix::writeRequest(boost::asio::local::stream_protocol::socket &socket, uint32_t requestId, int cmdId, const std::string &data)
+{
+    HELPER_REQUEST_HEADER header;
+    header.version = HELPER_PROTOCOL_VERSION;
+    header.requestId = requestId;
+    header.cmdId = cmdId;
+    header.pid = getpid();
+    header.size = data.size();
+
+    // send the header and the body with a single write
+    std::array<boost::asio::const_buffer, 2> buffers = { boost::asio::buffer(&header, sizeof(header)), boost::asio::buffer(data) };
+    boost::system::error_code ec;
+    boost::asio::write(socket, buffers, ec);
+    return !ec;
+}
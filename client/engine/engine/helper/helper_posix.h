@@ -4,6 +4,7 @@
 #include <QThread>
 #include <QWaitCondition>
 #include <QMutex>
+#include <map>
 #include "ihelper.h"
 #include "utils/boost_includes.h"
 #include "../../../../backend/posix_common/helper_commands.h"
@@ -40,6 +41,13 @@ public:
     bool stopWireGuard() override;
     bool configureWireGuard(const WireGuardConfig &config) override;
     bool getWireGuardStatus(types::WireGuardStatus *status) override;
+    // Blocks until the WireGuard status changes, at most timeoutMs (-1 for no timeout) or until interrupted.
+    // The caller passes the last known status in *status. Returns false if the status could not be obtained.
+    virtual bool waitForWireGuardStatus(types::WireGuardStatus *status, int timeoutMs);
+    // Wakes up waitForWireGuardStatus(), may be called from any thread.
+    virtual void interruptWireGuardStatusWait();
+    // Releases the resources of waitForWireGuardStatus(), called from the waiting thread.
+    virtual void finishWireGuardStatusWait();
 
     // ctrld functions
     ExecuteError startCtrld(const QString &ip, const QString &upstream1, const QString &upstream2, const QStringList &domains, bool isCreateLog) override;
@@ -91,12 +99,25 @@ protected:
     QMutex mutex_;
     unsigned long cmdId_;
 
+    // The commands of all the threads are written to socket_ without waiting for the answers of the previous ones,
+    // the thread that waits for an answer reads the answers in order and hands them over to their threads.
+    QMutex requestMutex_;
+    QWaitCondition answerCondition_;
+    uint32_t nextRequestId_ = 0;
+    bool isReadingAnswer_ = false;
+    std::map<uint32_t, CMD_ANSWER> receivedAnswers_;
+
     std::atomic<unsigned long> lastOpenVPNCmdId_;
 
     boost::asio::io_service io_service_;
     boost::asio::local::stream_protocol::endpoint ep_;
     boost::scoped_ptr<boost::asio::local::stream_protocol::socket> socket_;
     QMutex mutexSocket_;
+    std::vector<char> answerBuf_;       // reused between the answers
+
+    QMutex waitStatusMutex_;
+    QWaitCondition waitStatusCondition_;
+    bool isWaitStatusInterrupted_ = false;
 
     QElapsedTimer reconnectElapsedTimer_;
     bool bHelperConnectedEmitted_;
@@ -114,8 +135,11 @@ protected:
     static void connectHandler(const boost::system::error_code &ec);
     virtual void doDisconnectAndReconnect();
 
-    bool readAnswer(CMD_ANSWER &outAnswer);
-    bool sendCmdToHelper(int cmdId, const std::string &data);
+    static void answerToWireGuardStatus(const CMD_ANSWER &answer, types::WireGuardStatus *status);
+
+    static bool readAnswer(boost::asio::local::stream_protocol::socket &socket, std::vector<char> &buf, uint32_t &outRequestId, CMD_ANSWER &outAnswer);
+    static bool writeRequest(boost::asio::local::stream_protocol::socket &socket, uint32_t requestId, int cmdId, const std::string &data);
+
     virtual bool runCommand(int cmdId, const std::string &data, CMD_ANSWER &answer);
 
 private:
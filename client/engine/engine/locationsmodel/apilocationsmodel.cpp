@@ -1,10 +1,12 @@
 #include "apilocationsmodel.h"
 
 #include <QFile>
+#include <QSet>
 #include <QTextStream>
 
 #include "mutablelocationinfo.h"
 #include "nodeselectionalgorithm.h"
+#include "utils/extraconfig.h"
 #include "utils/logger.h"
 
 namespace locationsmodel {
@@ -20,7 +22,7 @@ ApiLocationsModel::ApiLocationsModel(QObject *parent, IConnectStateController *s
     {
         qCDebug(LOG_BEST_LOCATION) << "No saved best location in settings";
     }
-    connect(&pingManager_, &PingManager::pingInfoChanged, this, &ApiLocationsModel::onPingInfoChanged);
+    connect(&pingManager_, &PingManager::pingInfosChanged, this, &ApiLocationsModel::onPingInfosChanged);
 }
 
 void ApiLocationsModel::setLocations(const QVector<api_responses::Location> &locations, const api_responses::StaticIps &staticIps)
@@ -31,6 +33,7 @@ void ApiLocationsModel::setLocations(const QVector<api_responses::Location> &loc
 
     locations_ = locations;
     staticIps_ = staticIps;
+    updatePingIpToLocations();
 
     whitelistIps();
 
@@ -54,6 +57,7 @@ void ApiLocationsModel::setLocations(const QVector<api_responses::Location> &loc
         }
     }
 
+    updatePriorityIps();
     pingManager_.updateIps(ips);
     sendLocationsUpdated();
 }
@@ -62,6 +66,8 @@ void ApiLocationsModel::clear()
 {
     locations_.clear();
     staticIps_ = api_responses::StaticIps();
+    pingIpToLocations_.clear();
+    updatePriorityIps();
     pingManager_.clearIps();
     QSharedPointer<QVector<types::Location> > empty(new QVector<types::Location>());
     emit locationsUpdated(LocationID(), QString(),  empty);
@@ -143,27 +149,17 @@ QSharedPointer<BaseLocationInfo> ApiLocationsModel::getMutableLocationInfoById(c
     return NULL;
 }
 
-void ApiLocationsModel::onPingInfoChanged(const QString &ip, int timems)
+void ApiLocationsModel::onPingInfosChanged(const QHash<QString, int> &pingTimes)
 {
     if (pingManager_.isAllNodesHaveCurIteration()) {
         detectBestLocation(true);
     }
 
-    for (const api_responses::Location &l : locations_) {
-        for (int i = 0; i < l.groupsCount(); ++i) {
-            const api_responses::Group group = l.getGroup(i);
-            if (group.getPingIp() == ip) {
-                emit locationPingTimeChanged(LocationID::createApiLocationId(l.getId(), group.getCity(), group.getNick()), timems);
-            }
-        }
-    }
-
-    if (staticIps_.getIpsCount() > 0) {
-        for (int i = 0; i < staticIps_.getIpsCount(); ++i) {
-            const api_responses::StaticIpDescr &sid = staticIps_.getIp(i);
-            if (sid.getPingIp() == ip) {
-                emit locationPingTimeChanged(LocationID::createStaticIpsLocationId(sid.cityName, sid.staticIp), timems);
-                break;
+    for (auto ping = pingTimes.constBegin(); ping != pingTimes.constEnd(); ++ping) {
+        auto it = pingIpToLocations_.constFind(ping.key());
+        if (it != pingIpToLocations_.constEnd()) {
+            for (const LocationID &lid : it.value()) {
+                emit locationPingTimeChanged(lid, ping.value());
             }
         }
     }
@@ -180,6 +176,9 @@ void ApiLocationsModel::detectBestLocation(bool isAllNodesInDisconnectedState)
 
     int prevBestLocationLatency = INT_MAX;
 
+    // the latest ping time is used unless another statistic is selected, e.g. the median is less prone to flapping
+    PingStatistics::Type statisticType = PingStatistics::typeFromString(ExtraConfig::instance().getBestLocationStatistic());
+
     int ind = 0;
     for (const api_responses::Location &l : locations_)
     {
@@ -194,6 +193,11 @@ void ApiLocationsModel::detectBestLocation(bool isAllNodesInDisconnectedState)
 
             LocationID lid = LocationID::createApiLocationId(l.getId(), group.getCity(), group.getNick());
             int latency = pingManager_.getPing(group.getPingIp()).toInt();
+            if (latency >= 0 && statisticType != PingStatistics::Type::kLatest) {
+                int value = pingManager_.getPingStatistics(group.getPingIp()).value(statisticType);
+                if (value >= 0)
+                    latency = value;
+            }
 
             // we assume a maximum ping time for three bars when no ping info
             if (latency == PingTime::NO_PING_INFO)
@@ -279,10 +283,34 @@ void ApiLocationsModel::detectBestLocation(bool isAllNodesInDisconnectedState)
         }
 
         qCDebug(LOG_BEST_LOCATION) << "Best location changed to " << bestLocation_.getId().getHashString();
+        updatePriorityIps();
         emit bestLocationUpdated(bestLocation_.getId().apiLocationToBestLocation());
     }
 }
 
+void ApiLocationsModel::updatePriorityIps()
+{
+    // the best location and static IPs are pinged first
+    QStringList priorityIps;
+    if (bestLocation_.isValid()) {
+        for (const api_responses::Location &l : qAsConst(locations_)) {
+            for (int i = 0; i < l.groupsCount(); ++i) {
+                api_responses::Group group = l.getGroup(i);
+                if (!group.getPingHost().isEmpty() && bestLocation_.getId() == LocationID::createApiLocationId(l.getId(), group.getCity(), group.getNick()))
+                    priorityIps << group.getPingIp();
+            }
+        }
+    }
+
+    for (int i = 0; i < staticIps_.getIpsCount(); ++i) {
+        const api_responses::StaticIpDescr &sid = staticIps_.getIp(i);
+        if (!sid.getPingHost().isEmpty())
+            priorityIps << sid.getPingIp();
+    }
+
+    pingManager_.setPriorityIps(priorityIps);
+}
+
 BestAndAllLocations ApiLocationsModel::generateLocationsUpdated()
 {
     QSharedPointer <QVector<types::Location> > items(new QVector<types::Location>());
@@ -390,6 +418,27 @@ void ApiLocationsModel::sendLocationsUpdated()
     emit locationsUpdated(ball.bestLocation, ball.staticIpDeviceName, ball.locations);
 }
 
+void ApiLocationsModel::updatePingIpToLocations()
+{
+    pingIpToLocations_.clear();
+    for (const api_responses::Location &l : locations_) {
+        for (int i = 0; i < l.groupsCount(); ++i) {
+            const api_responses::Group group = l.getGroup(i);
+            pingIpToLocations_[group.getPingIp()] << LocationID::createApiLocationId(l.getId(), group.getCity(), group.getNick());
+        }
+    }
+
+    // only the first static IP location with the same ping IP
+    QSet<QString> staticPingIps;
+    for (int i = 0; i < staticIps_.getIpsCount(); ++i) {
+        const api_responses::StaticIpDescr &sid = staticIps_.getIp(i);
+        if (!staticPingIps.contains(sid.getPingIp())) {
+            staticPingIps.insert(sid.getPingIp());
+            pingIpToLocations_[sid.getPingIp()] << LocationID::createStaticIpsLocationId(sid.cityName, sid.staticIp);
+        }
+    }
+}
+
 void ApiLocationsModel::whitelistIps()
 {
     QStringList ips;
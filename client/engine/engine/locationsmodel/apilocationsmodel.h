@@ -44,19 +44,23 @@ signals:
     //void customOvpnConfgsIpsChanged(const QStringList &ips);
 
 private slots:
-    void onPingInfoChanged(const QString &ip, int timems);
+    void onPingInfosChanged(const QHash<QString, int> &pingTimes);
 
 private:
     QVector<api_responses::Location> locations_;
     api_responses::StaticIps staticIps_;
     BestLocation bestLocation_;
     PingManager pingManager_;
+    // ping IP -> locations that use it, to handle ping results without scanning all the locations
+    QHash<QString, QVector<LocationID> > pingIpToLocations_;
 
 private:
     void detectBestLocation(bool isAllNodesInDisconnectedState);
     BestAndAllLocations generateLocationsUpdated();
     void sendLocationsUpdated();
     void whitelistIps();
+    void updatePingIpToLocations();
+    void updatePriorityIps();
 
     bool isChanged(const QVector<api_responses::Location> &locations, const api_responses::StaticIps &staticIps);
 };
@@ -15,7 +15,7 @@ using namespace wsnet;
 CustomConfigLocationsModel::CustomConfigLocationsModel(QObject *parent, IConnectStateController *stateController, INetworkDetectionManager *networkDetectionManager) : QObject(parent),
     pingManager_(this, stateController, networkDetectionManager, "pingStorageCustomConfigs", "ping_log_custom_configs.txt")
 {
-    connect(&pingManager_, &PingManager::pingInfoChanged, this, &CustomConfigLocationsModel::onPingInfoChanged);
+    connect(&pingManager_, &PingManager::pingInfosChanged, this, &CustomConfigLocationsModel::onPingInfosChanged);
 }
 
 void CustomConfigLocationsModel::setCustomConfigs(const QVector<QSharedPointer<const customconfigs::ICustomConfig> > &customConfigs)
@@ -102,11 +102,17 @@ QSharedPointer<BaseLocationInfo> CustomConfigLocationsModel::getMutableLocationI
     return NULL;
 }
 
-void CustomConfigLocationsModel::onPingInfoChanged(const QString &ip, int timems)
+void CustomConfigLocationsModel::onPingInfosChanged(const QHash<QString, int> &pingTimes)
 {
     for (auto it = pingInfos_.begin(); it != pingInfos_.end(); ++it)
     {
-        if (it->setPingTime(ip, timems))
+        bool isChanged = false;
+        for (auto ping = pingTimes.constBegin(); ping != pingTimes.constEnd(); ++ping)
+        {
+            if (it->setPingTime(ping.key(), ping.value()))
+                isChanged = true;
+        }
+        if (isChanged)
         {
             emit locationPingTimeChanged(LocationID::createCustomConfigLocationId(it->customConfig->filename()), it->getPing());
         }
@@ -33,7 +33,7 @@ signals:
     void whitelistIpsChanged(const QStringList &ips);
 
 private slots:
-    void onPingInfoChanged(const QString &ip, int timems);
+    void onPingInfosChanged(const QHash<QString, int> &pingTimes);
 
 private:
     PingManager pingManager_;
@@ -1,16 +1,8 @@
 #include "networkdetectionmanager_linux.h"
 
-#include <QRegularExpression>
-
-#include <sys/socket.h>
-#include <sys/ioctl.h>
-#include <net/if.h>
-#include <unistd.h>
-#include <linux/wireless.h>
+#include <stdio.h>
 
 #include "utils/logger.h"
-#include "utils/network_utils/network_utils_linux.h"
-#include "utils/utils.h"
 
 const int typeIdNetworkInterface = qRegisterMetaType<types::NetworkInterface>("types::NetworkInterface");
 
@@ -19,11 +11,13 @@ NetworkDetectionManager_linux::NetworkDetectionManager_linux(QObject *parent, IH
     Q_UNUSED(helper);
 
     networkInterface_ = types::NetworkInterface::noNetworkInterface();
-    getDefaultRouteInterface(isOnline_);
-    updateNetworkInfo(false);
 
+    // the monitor dumps the current state on construction
     routeMonitorThread_ = new QThread;
     routeMonitor_ = new RouteMonitor_linux;
+    isOnline_ = routeMonitor_->defaultInterface().isOnline;
+    updateNetworkInfo(false);
+
     connect(routeMonitor_, &RouteMonitor_linux::routesChanged, this, &NetworkDetectionManager_linux::onRoutesChanged);
     connect(routeMonitorThread_, &QThread::started, routeMonitor_, &RouteMonitor_linux::init);
     connect(routeMonitorThread_, &QThread::finished, routeMonitor_, &RouteMonitor_linux::finish);
@@ -58,20 +52,19 @@ void NetworkDetectionManager_linux::onRoutesChanged()
 
 void NetworkDetectionManager_linux::updateNetworkInfo(bool bWithEmitSignal)
 {
-    bool newIsOnline;
-    QString ifname = getDefaultRouteInterface(newIsOnline);
+    const RouteMonitor_linux::DefaultInterface defaultInterface = routeMonitor_->defaultInterface();
 
-    if (isOnline_ != newIsOnline)
+    if (isOnline_ != defaultInterface.isOnline)
     {
-        isOnline_ = newIsOnline;
+        isOnline_ = defaultInterface.isOnline;
         emit onlineStateChanged(isOnline_);
     }
 
 
     types::NetworkInterface newNetworkInterface = types::NetworkInterface::noNetworkInterface();
-    if (!ifname.isEmpty())
+    if (!defaultInterface.ifname.isEmpty())
     {
-        getInterfacePars(ifname, newNetworkInterface);
+        getInterfacePars(defaultInterface, newNetworkInterface);
     }
 
     if (newNetworkInterface != networkInterface_)
@@ -84,122 +77,37 @@ void NetworkDetectionManager_linux::updateNetworkInfo(bool bWithEmitSignal)
     }
 }
 
-QString NetworkDetectionManager_linux::getDefaultRouteInterface(bool &isOnline)
-{
-    QString gateway;
-    QString interface;
-    QString adapterIp;
-
-    NetworkUtils_linux::getDefaultRoute(gateway, interface, adapterIp, true);
-    if (gateway.isEmpty() || interface.isEmpty()) {
-        isOnline = false;
-        return QString();
-    }
-    isOnline = true;
-    return interface;
-}
-
-void NetworkDetectionManager_linux::getInterfacePars(const QString &ifname, types::NetworkInterface &outNetworkInterface)
+void NetworkDetectionManager_linux::getInterfacePars(const RouteMonitor_linux::DefaultInterface &defaultInterface, types::NetworkInterface &outNetworkInterface)
 {
-    outNetworkInterface.interfaceName = ifname;
-    outNetworkInterface.interfaceIndex = if_nametoindex(ifname.toStdString().c_str());
-    QString macAddress = getMacAddressByIfName(ifname);
-    outNetworkInterface.physicalAddress = macAddress;
+    outNetworkInterface.interfaceName = defaultInterface.ifname;
+    outNetworkInterface.interfaceIndex = defaultInterface.ifindex;
+    outNetworkInterface.physicalAddress = defaultInterface.macAddress;
+    outNetworkInterface.interfaceType = defaultInterface.isWireless ? NETWORK_INTERFACE_WIFI : NETWORK_INTERFACE_ETH;
 
-    bool isWifi = checkWirelessByIfName(ifname);
-    if (isWifi)
+    QString friendlyName = getFriendlyNameByIfName(defaultInterface.ifname, defaultInterface.generation);
+    if (!friendlyName.isEmpty())
     {
-        outNetworkInterface.interfaceType = NETWORK_INTERFACE_WIFI;
-        QString friendlyName = getFriendlyNameByIfName(ifname);
-        if (!friendlyName.isEmpty())
-        {
-            outNetworkInterface.networkOrSsid = friendlyName;
-        }
-        else
-        {
-            outNetworkInterface.networkOrSsid = macAddress;
-        }
+        outNetworkInterface.networkOrSsid = friendlyName;
     }
     else
     {
-        outNetworkInterface.interfaceType = NETWORK_INTERFACE_ETH;
-        QString friendlyName = getFriendlyNameByIfName(ifname);
-        if (!friendlyName.isEmpty())
-        {
-            outNetworkInterface.networkOrSsid = friendlyName;
-        }
-        else
-        {
-            outNetworkInterface.networkOrSsid = macAddress;
-        }
+        outNetworkInterface.networkOrSsid = defaultInterface.macAddress;
     }
 
-    outNetworkInterface.active = isActiveByIfName(ifname);
+    outNetworkInterface.active = defaultInterface.isActive;
 }
 
-QString NetworkDetectionManager_linux::getMacAddressByIfName(const QString &ifname)
+QString NetworkDetectionManager_linux::getFriendlyNameByIfName(const QString &ifname, quint64 generation)
 {
-    QString ret;
-
-    int fd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (fd != -1)
+    // the connection name can only change together with the link, its addresses or its routes
+    if (ifname == friendlyNameIfName_ && generation == friendlyNameGeneration_)
     {
-        struct ifreq ifr;
-        memset(&ifr, 0, sizeof(ifr));
-        ifr.ifr_addr.sa_family = AF_INET;
-        strncpy(ifr.ifr_name , ifname.toStdString().c_str() , IFNAMSIZ-1);
-        if (ioctl(fd, SIOCGIFHWADDR, &ifr) == 0)
-        {
-            unsigned char *mac = (unsigned char *)ifr.ifr_hwaddr.sa_data;
-            // format mac address
-            ret = QString::asprintf("%.2X:%.2X:%.2X:%.2X:%.2X:%.2X" , mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-        }
-        close(fd);
+        return friendlyName_;
     }
-    return ret;
-}
-
-bool NetworkDetectionManager_linux::isActiveByIfName(const QString &ifname)
-{
-    bool ret = false;
-
-    int fd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (fd != -1)
-    {
-        struct ifreq ifr;
-        memset(&ifr, 0, sizeof(ifr));
-        ifr.ifr_addr.sa_family = AF_INET;
-        strncpy(ifr.ifr_name , ifname.toStdString().c_str() , IFNAMSIZ-1);
-        if (ioctl(fd, SIOCGIFFLAGS, &ifr) == 0)
-        {
-            ret = (ifr.ifr_flags & ( IFF_UP | IFF_RUNNING )) == ( IFF_UP | IFF_RUNNING );
-        }
-        close(fd);
-    }
-    return ret;
-}
+    friendlyNameIfName_ = ifname;
+    friendlyNameGeneration_ = generation;
+    friendlyName_.clear();
 
-bool NetworkDetectionManager_linux::checkWirelessByIfName(const QString &ifname)
-{
-    bool ret = false;
-
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (fd != -1)
-    {
-        struct iwreq pwrq;
-        memset(&pwrq, 0, sizeof(pwrq));
-        strncpy(pwrq.ifr_name, ifname.toStdString().c_str(), IFNAMSIZ-1);
-        if (ioctl(fd, SIOCGIWNAME, &pwrq) != -1)
-        {
-            ret = true;
-        }
-        close(fd);
-    }
-    return ret;
-}
-
-QString NetworkDetectionManager_linux::getFriendlyNameByIfName(const QString &ifname)
-{
     QString strReply;
     FILE *file = popen("nmcli -t -f NAME,DEVICE c show", "r");
     if (file)
@@ -220,10 +128,11 @@ QString NetworkDetectionManager_linux::getFriendlyNameByIfName(const QString &if
         {
             if (pars[1] == ifname)
             {
-                return pars[0];
+                friendlyName_ = pars[0];
+                break;
             }
         }
     }
-    return QString();
+    return friendlyName_;
 }
 
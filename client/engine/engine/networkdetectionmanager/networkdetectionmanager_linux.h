@@ -26,11 +26,12 @@ private:
     QThread *routeMonitorThread_ = nullptr;
     RouteMonitor_linux *routeMonitor_ = nullptr;
 
+    // the result of the last nmcli call, valid until the link changes
+    QString friendlyNameIfName_;
+    quint64 friendlyNameGeneration_ = 0;
+    QString friendlyName_;
+
     void updateNetworkInfo(bool bWithEmitSignal);
-    QString getDefaultRouteInterface(bool &isOnline);
-    void getInterfacePars(const QString &ifname, types::NetworkInterface &outNetworkInterface);
-    QString getMacAddressByIfName(const QString &ifname);
-    bool isActiveByIfName(const QString &ifname);
-    bool checkWirelessByIfName(const QString &ifname);
-    QString getFriendlyNameByIfName(const QString &ifname);
+    void getInterfacePars(const RouteMonitor_linux::DefaultInterface &defaultInterface, types::NetworkInterface &outNetworkInterface);
+    QString getFriendlyNameByIfName(const QString &ifname, quint64 generation);
 };
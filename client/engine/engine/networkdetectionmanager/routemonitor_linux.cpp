@@ -1,16 +1,41 @@
 #include "routemonitor_linux.h"
 
+#include <QMutexLocker>
+
+#include <errno.h>
+#include <net/if.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <linux/wireless.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include "utils/logger.h"
 #include "utils/ws_assert.h"
 
+namespace {
+
+QString macAddressToString(const unsigned char *data, size_t size)
+{
+    // formatted the same as SIOCGIFHWADDR did, the links without an address (tun) get zeros
+    unsigned char mac[6] = {};
+    if (data) {
+        memcpy(mac, data, qMin(size, sizeof(mac)));
+    }
+    return QString::asprintf("%.2X:%.2X:%.2X:%.2X:%.2X:%.2X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+} // namespace
+
 RouteMonitor_linux::RouteMonitor_linux(QObject *parent) : QObject(parent)
 {
+    if (openSockets()) {
+        resync(false);
+        updateDefaultInterface();
+    }
 }
 
 RouteMonitor_linux::~RouteMonitor_linux()
@@ -18,31 +43,34 @@ RouteMonitor_linux::~RouteMonitor_linux()
     if (fd_ >= 0) {
         close(fd_);
     }
+    if (requestFd_ >= 0) {
+        close(requestFd_);
+    }
+}
+
+RouteMonitor_linux::DefaultInterface RouteMonitor_linux::defaultInterface() const
+{
+    QMutexLocker locker(&mutex_);
+    return defaultInterface_;
 }
 
 void RouteMonitor_linux::init()
 {
-    if ((fd_ = socket(AF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE)) < 0) {
-        qCDebug(LOG_BASIC) << "RouteMonitor_linux could not open netlink socket";
-        WS_ASSERT(false);
+    if (fd_ < 0) {
         return;
     }
 
-    struct sockaddr_nl addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.nl_family = AF_NETLINK;
-    addr.nl_pid    = getpid();
-    addr.nl_groups = RTMGRP_IPV4_ROUTE;
-
-    if (bind(fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        qCDebug(LOG_BASIC) << "RouteMonitor_linux could not bind address";
-        WS_ASSERT(false);
-        return;
-    }
+    debounceTimer_ = new QTimer(this);
+    debounceTimer_->setSingleShot(true);
+    debounceTimer_->setInterval(kDebounceMs);
+    connect(debounceTimer_, &QTimer::timeout, this, &RouteMonitor_linux::onDebounceTimer);
 
     notifier_ = new QSocketNotifier(fd_, QSocketNotifier::Read, this);
     connect(notifier_, &QSocketNotifier::activated, this, &RouteMonitor_linux::netlinkSocketReady);
     notifier_->setEnabled(true);
+
+    // the notifications received between the construction and now
+    netlinkSocketReady(QSocketDescriptor(fd_), QSocketNotifier::Read);
 }
 
 void RouteMonitor_linux::finish()
@@ -50,6 +78,9 @@ void RouteMonitor_linux::finish()
     if (notifier_) {
         notifier_->setEnabled(false);
     }
+    if (debounceTimer_) {
+        debounceTimer_->stop();
+    }
 }
 
 void RouteMonitor_linux::netlinkSocketReady(QSocketDescriptor socket, QSocketNotifier::Type activationEvent)
@@ -57,9 +88,427 @@ void RouteMonitor_linux::netlinkSocketReady(QSocketDescriptor socket, QSocketNot
     Q_UNUSED(socket)
     Q_UNUSED(activationEvent)
 
-    char buffer[4096];
-    ssize_t len = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
-    if (len >= 0) {
+    bool isReceived = false;
+    char buffer[32768];
+    while (true) {
+        ssize_t len = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                // the socket buffer has overflowed and some notifications are lost
+                isResyncNeeded_ = true;
+                isReceived = true;
+                continue;
+            }
+            break;
+        }
+        if (len == 0) {
+            break;
+        }
+
+        isReceived = true;
+        int remaining = (int)len;
+        for (const struct nlmsghdr *msg = (const struct nlmsghdr *)buffer; NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining)) {
+            processMessage(msg);
+        }
+    }
+
+    // not restarted on every message, so that a continuous route storm still produces an update every kDebounceMs
+    if (isReceived && !debounceTimer_->isActive()) {
+        debounceTimer_->start();
+    }
+}
+
+void RouteMonitor_linux::onDebounceTimer()
+{
+    if (isResyncNeeded_) {
+        resync(false);
+    } else if (isRoutesResyncNeeded_) {
+        resync(true);
+    }
+    isResyncNeeded_ = false;
+    isRoutesResyncNeeded_ = false;
+
+    if (updateDefaultInterface()) {
         emit routesChanged();
     }
 }
+
+bool RouteMonitor_linux::openSockets()
+{
+    if ((fd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+        qCDebug(LOG_BASIC) << "RouteMonitor_linux could not open netlink socket";
+        WS_ASSERT(false);
+        return false;
+    }
+
+    // route storms during the VPN bring-up can be large, do not lose the notifications
+    int rcvbuf = 1024 * 1024;
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV4_ROUTE;
+
+    if (bind(fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        qCDebug(LOG_BASIC) << "RouteMonitor_linux could not bind address";
+        WS_ASSERT(false);
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // the dumps use a separate socket, so their replies are not mixed with the notifications
+    if ((requestFd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+        qCDebug(LOG_BASIC) << "RouteMonitor_linux could not open netlink request socket";
+        WS_ASSERT(false);
+        return false;
+    }
+
+    struct timeval tv;
+    tv.tv_sec = 2;
+    tv.tv_usec = 0;
+    setsockopt(requestFd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return true;
+}
+
+void RouteMonitor_linux::resync(bool routesOnly)
+{
+    if (requestFd_ < 0) {
+        return;
+    }
+
+    if (!routesOnly) {
+        links_.clear();
+        addresses_.clear();
+        if (!dump(RTM_GETLINK) || !dump(RTM_GETADDR)) {
+            qCDebug(LOG_BASIC) << "RouteMonitor_linux could not dump links or addresses";
+        }
+    }
+
+    QList<Route> oldRoutes;
+    oldRoutes.swap(routes_);
+    if (!dump(RTM_GETROUTE)) {
+        qCDebug(LOG_BASIC) << "RouteMonitor_linux could not dump routes";
+    }
+
+    // the kernel does not notify about the IPv4 routes flushed with a link or an address, the dump finds them
+    for (const Route &route : qAsConst(oldRoutes)) {
+        if (!routes_.contains(route)) {
+            touchLink(route.ifindex);
+        }
+    }
+    for (const Route &route : qAsConst(routes_)) {
+        if (!oldRoutes.contains(route)) {
+            touchLink(route.ifindex);
+        }
+    }
+}
+
+bool RouteMonitor_linux::dump(int type)
+{
+    struct {
+        struct nlmsghdr hdr;
+        struct rtgenmsg gen;
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtgenmsg));
+    req.hdr.nlmsg_type = type;
+    req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.hdr.nlmsg_seq = ++seq_;
+    req.gen.rtgen_family = (type == RTM_GETLINK) ? AF_UNSPEC : AF_INET;
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+
+    if (sendto(requestFd_, &req, req.hdr.nlmsg_len, 0, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        return false;
+    }
+
+    isDumping_ = true;
+    char buffer[32768];
+    while (true) {
+        ssize_t len = recv(requestFd_, buffer, sizeof(buffer), 0);
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len <= 0) {
+            break;
+        }
+
+        int remaining = (int)len;
+        for (const struct nlmsghdr *msg = (const struct nlmsghdr *)buffer; NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining)) {
+            if (msg->nlmsg_seq != seq_) {
+                continue;
+            }
+            if (msg->nlmsg_type == NLMSG_DONE) {
+                isDumping_ = false;
+                return true;
+            }
+            if (msg->nlmsg_type == NLMSG_ERROR) {
+                isDumping_ = false;
+                return false;
+            }
+            processMessage(msg);
+        }
+    }
+    isDumping_ = false;
+    return false;
+}
+
+void RouteMonitor_linux::processMessage(const struct nlmsghdr *msg)
+{
+    switch (msg->nlmsg_type) {
+    case RTM_NEWLINK:
+    case RTM_DELLINK:
+        processLinkMessage(msg);
+        break;
+    case RTM_NEWADDR:
+    case RTM_DELADDR:
+        processAddressMessage(msg);
+        break;
+    case RTM_NEWROUTE:
+    case RTM_DELROUTE:
+        processRouteMessage(msg);
+        break;
+    default:
+        break;
+    }
+}
+
+void RouteMonitor_linux::processLinkMessage(const struct nlmsghdr *msg)
+{
+    if (msg->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifinfomsg))) {
+        return;
+    }
+    const struct ifinfomsg *ifi = (const struct ifinfomsg *)NLMSG_DATA(msg);
+
+    if (msg->nlmsg_type == RTM_DELLINK) {
+        links_.remove(ifi->ifi_index);
+        addresses_.remove(ifi->ifi_index);
+        routes_.removeIf([ifi](const Route &route) { return route.ifindex == ifi->ifi_index; });
+        return;
+    }
+
+    QString name;
+    QString macAddress = macAddressToString(nullptr, 0);
+    int len = IFLA_PAYLOAD(msg);
+    for (const struct rtattr *attr = IFLA_RTA(ifi); RTA_OK(attr, len); attr = RTA_NEXT(attr, len)) {
+        if (attr->rta_type == IFLA_IFNAME) {
+            name = QString::fromUtf8((const char *)RTA_DATA(attr), strnlen((const char *)RTA_DATA(attr), RTA_PAYLOAD(attr)));
+        } else if (attr->rta_type == IFLA_ADDRESS) {
+            macAddress = macAddressToString((const unsigned char *)RTA_DATA(attr), RTA_PAYLOAD(attr));
+        }
+    }
+
+    auto it = links_.find(ifi->ifi_index);
+    if (it == links_.end()) {
+        Link link;
+        link.name = name;
+        link.macAddress = macAddress;
+        link.flags = ifi->ifi_flags;
+        link.isWireless = checkWirelessByIfName(name);
+        link.generation = ++generationCounter_;
+        links_.insert(ifi->ifi_index, link);
+        return;
+    }
+
+    // the wireless events are also delivered as RTM_NEWLINK, only the real changes matter
+    if (it->name == name && it->macAddress == macAddress && it->flags == ifi->ifi_flags) {
+        return;
+    }
+    if ((it->flags & IFF_UP) && !(ifi->ifi_flags & IFF_UP)) {
+        isRoutesResyncNeeded_ = true;
+    }
+    if (it->name != name) {
+        it->isWireless = checkWirelessByIfName(name);
+    }
+    it->name = name;
+    it->macAddress = macAddress;
+    it->flags = ifi->ifi_flags;
+    touchLink(ifi->ifi_index);
+}
+
+void RouteMonitor_linux::processAddressMessage(const struct nlmsghdr *msg)
+{
+    if (msg->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifaddrmsg))) {
+        return;
+    }
+    const struct ifaddrmsg *ifa = (const struct ifaddrmsg *)NLMSG_DATA(msg);
+    if (ifa->ifa_family != AF_INET) {
+        return;
+    }
+
+    quint32 address = 0;
+    bool isLocalFound = false;
+    int len = IFA_PAYLOAD(msg);
+    for (const struct rtattr *attr = IFA_RTA(ifa); RTA_OK(attr, len); attr = RTA_NEXT(attr, len)) {
+        if (RTA_PAYLOAD(attr) < sizeof(address)) {
+            continue;
+        }
+        if (attr->rta_type == IFA_LOCAL) {
+            memcpy(&address, RTA_DATA(attr), sizeof(address));
+            isLocalFound = true;
+        } else if (attr->rta_type == IFA_ADDRESS && !isLocalFound) {
+            memcpy(&address, RTA_DATA(attr), sizeof(address));
+        }
+    }
+
+    const int ifindex = (int)ifa->ifa_index;
+    QList<quint32> &addresses = addresses_[ifindex];
+    if (msg->nlmsg_type == RTM_NEWADDR) {
+        if (addresses.contains(address)) {
+            return;
+        }
+        addresses.append(address);
+    } else {
+        if (!addresses.removeOne(address)) {
+            return;
+        }
+        isRoutesResyncNeeded_ = true;
+    }
+    touchLink(ifindex);
+}
+
+void RouteMonitor_linux::processRouteMessage(const struct nlmsghdr *msg)
+{
+    if (msg->nlmsg_len < NLMSG_LENGTH(sizeof(struct rtmsg))) {
+        return;
+    }
+    const struct rtmsg *rtm = (const struct rtmsg *)NLMSG_DATA(msg);
+    if (rtm->rtm_family != AF_INET || rtm->rtm_type != RTN_UNICAST || (rtm->rtm_flags & RTM_F_CLONED)) {
+        return;
+    }
+
+    quint32 table = rtm->rtm_table;
+    quint32 destination = 0;
+    Route route;
+    route.prefixLength = rtm->rtm_dst_len;
+    route.tos = rtm->rtm_tos;
+    int len = RTM_PAYLOAD(msg);
+    for (const struct rtattr *attr = RTM_RTA(rtm); RTA_OK(attr, len); attr = RTA_NEXT(attr, len)) {
+        if (RTA_PAYLOAD(attr) < sizeof(quint32)) {
+            continue;
+        }
+        switch (attr->rta_type) {
+        case RTA_TABLE:
+            memcpy(&table, RTA_DATA(attr), sizeof(table));
+            break;
+        case RTA_DST:
+            memcpy(&destination, RTA_DATA(attr), sizeof(destination));
+            break;
+        case RTA_OIF:
+            memcpy(&route.ifindex, RTA_DATA(attr), sizeof(route.ifindex));
+            break;
+        case RTA_PRIORITY:
+            memcpy(&route.metric, RTA_DATA(attr), sizeof(route.metric));
+            break;
+        case RTA_GATEWAY:
+            memcpy(&route.gateway, RTA_DATA(attr), sizeof(route.gateway));
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the same set of routes as /proc/net/route provided: the main table, the 0.0.0.0 destination with any prefix
+    if (table != RT_TABLE_MAIN || destination != 0 || route.ifindex == 0) {
+        return;
+    }
+
+    if (msg->nlmsg_type == RTM_NEWROUTE) {
+        if (routes_.contains(route)) {
+            return;
+        }
+        const bool isReplace = (msg->nlmsg_flags & NLM_F_REPLACE);
+        for (auto it = routes_.begin(); it != routes_.end(); ) {
+            if (it->isSameKey(route, isReplace)) {
+                touchLink(it->ifindex);
+                it = routes_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        routes_.append(route);
+    } else {
+        const qsizetype count = routes_.removeIf([&route](const Route &r) { return r.isSameKey(route, false); });
+        if (count == 0) {
+            return;
+        }
+    }
+    touchLink(route.ifindex);
+}
+
+void RouteMonitor_linux::touchLink(int ifindex)
+{
+    // during a dump the changes are detected by the caller
+    if (isDumping_) {
+        return;
+    }
+    auto it = links_.find(ifindex);
+    if (it != links_.end()) {
+        it->generation = ++generationCounter_;
+    }
+}
+
+bool RouteMonitor_linux::updateDefaultInterface()
+{
+    DefaultInterface defaultInterface;
+
+    // the lowest metric route wins, the zero metric routes are skipped the same way getDefaultRoute() does
+    int lowestMetric = INT32_MAX;
+    QMap<int, Link>::const_iterator bestLink = links_.constEnd();
+    for (const Route &route : qAsConst(routes_)) {
+        auto link = links_.constFind(route.ifindex);
+        if (link == links_.constEnd() || route.metric == 0) {
+            continue;
+        }
+        if (link->name.startsWith("tun") || link->name.startsWith("utun")) {
+            continue;
+        }
+        if (route.metric < lowestMetric) {
+            lowestMetric = route.metric;
+            bestLink = link;
+        }
+    }
+
+    if (bestLink != links_.constEnd()) {
+        defaultInterface.isOnline = true;
+        defaultInterface.ifname = bestLink->name;
+        defaultInterface.ifindex = bestLink.key();
+        defaultInterface.macAddress = bestLink->macAddress;
+        defaultInterface.isWireless = bestLink->isWireless;
+        defaultInterface.isActive = (bestLink->flags & (IFF_UP | IFF_RUNNING)) == (IFF_UP | IFF_RUNNING);
+        defaultInterface.generation = bestLink->generation;
+    }
+
+    QMutexLocker locker(&mutex_);
+    if (defaultInterface == defaultInterface_) {
+        return false;
+    }
+    defaultInterface_ = defaultInterface;
+    return true;
+}
+
+bool RouteMonitor_linux::checkWirelessByIfName(const QString &ifname)
+{
+    bool ret = false;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd != -1)
+    {
+        struct iwreq pwrq;
+        memset(&pwrq, 0, sizeof(pwrq));
+        strncpy(pwrq.ifr_name, ifname.toStdString().c_str(), IFNAMSIZ-1);
+        if (ioctl(fd, SIOCGIWNAME, &pwrq) != -1)
+        {
+            ret = true;
+        }
+        close(fd);
+    }
+    return ret;
+}
@@ -1,15 +1,50 @@
 #pragma once
 
+#include <QList>
+#include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QSocketNotifier>
+#include <QTimer>
 
+struct nlmsghdr;
+
+// Keeps a model of the links, IPv4 addresses and default routes of the system.
+// The model is built from an rtnetlink dump and then updated incrementally from the netlink notifications,
+// changes are debounced and routesChanged() is emitted only if the default interface state has changed.
 class RouteMonitor_linux : public QObject
 {
     Q_OBJECT
 public:
+    struct DefaultInterface
+    {
+        bool isOnline = false;
+        QString ifname;
+        int ifindex = 0;
+        QString macAddress;
+        bool isWireless = false;
+        bool isActive = false;
+        quint64 generation = 0;     // changes with every change of the link, its addresses or its routes
+
+        bool operator==(const DefaultInterface &other) const
+        {
+            return isOnline == other.isOnline && ifname == other.ifname && ifindex == other.ifindex &&
+                   macAddress == other.macAddress && isWireless == other.isWireless && isActive == other.isActive &&
+                   generation == other.generation;
+        }
+        bool operator!=(const DefaultInterface &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    // opens the netlink sockets and dumps the current state, so defaultInterface() is valid right after the construction
     explicit RouteMonitor_linux(QObject *parent = nullptr);
     ~RouteMonitor_linux();
 
+    // thread safe
+    DefaultInterface defaultInterface() const;
+
 signals:
     void routesChanged();
 
@@ -19,8 +54,65 @@ public slots:
 
 private slots:
     void netlinkSocketReady(QSocketDescriptor socket, QSocketNotifier::Type activationEvent);
+    void onDebounceTimer();
 
 private:
-    int fd_ = -1;
+    static constexpr int kDebounceMs = 200;
+
+    struct Link
+    {
+        QString name;
+        QString macAddress;
+        unsigned int flags = 0;
+        bool isWireless = false;
+        quint64 generation = 0;
+    };
+
+    // only the routes with the 0.0.0.0 destination from the main table are kept
+    struct Route
+    {
+        int ifindex = 0;
+        int prefixLength = 0;
+        int tos = 0;
+        int metric = 0;
+        quint32 gateway = 0;
+
+        bool operator==(const Route &other) const
+        {
+            return isSameKey(other, false) && gateway == other.gateway;
+        }
+        bool isSameKey(const Route &other, bool isIgnoreIfindex) const
+        {
+            return prefixLength == other.prefixLength && tos == other.tos && metric == other.metric &&
+                   (isIgnoreIfindex || ifindex == other.ifindex);
+        }
+    };
+
+    int fd_ = -1;               // subscribed to the notifications
+    int requestFd_ = -1;        // used for the dumps
+    quint32 seq_ = 0;
     QSocketNotifier *notifier_ = nullptr;
+    QTimer *debounceTimer_ = nullptr;
+
+    QMap<int, Link> links_;
+    QMap<int, QList<quint32>> addresses_;
+    QList<Route> routes_;
+    quint64 generationCounter_ = 0;
+    bool isResyncNeeded_ = false;
+    bool isRoutesResyncNeeded_ = false;
+    bool isDumping_ = false;
+
+    mutable QMutex mutex_;
+    DefaultInterface defaultInterface_;
+
+    bool openSockets();
+    void resync(bool routesOnly);
+    bool dump(int type);
+    void processMessage(const struct nlmsghdr *msg);
+    void processLinkMessage(const struct nlmsghdr *msg);
+    void processAddressMessage(const struct nlmsghdr *msg);
+    void processRouteMessage(const struct nlmsghdr *msg);
+    void touchLink(int ifindex);
+    bool updateDefaultInterface();
+    static bool checkWirelessByIfName(const QString &ifname);
 };
@@ -1,5 +1,10 @@
 #include "packetsizecontroller.h"
 
+#include <QDateTime>
+#include <QHostInfo>
+#include <future>
+#include <vector>
+
 #include "utils/ipvalidation.h"
 #include "utils/logger.h"
 #include "utils/network_utils/network_utils.h"
@@ -30,10 +35,10 @@ void PacketSizeController::setPacketSize(const types::PacketSize &packetSize)
     setPacketSizeImpl(packetSize);
 }
 
-void PacketSizeController::detectAppropriatePacketSize(const QString &hostname)
+void PacketSizeController::detectAppropriatePacketSize(const QString &hostname, const QString &networkId)
 {
     QMutexLocker locker(&mutex_);
-    QMetaObject::invokeMethod(this, "detectAppropriatePacketSizeImpl", Q_ARG(QString, hostname));
+    QMetaObject::invokeMethod(this, "detectAppropriatePacketSizeImpl", Q_ARG(QString, hostname), Q_ARG(QString, networkId));
 }
 
 void PacketSizeController::earlyStop()
@@ -51,14 +56,29 @@ void PacketSizeController::setPacketSizeImpl(const types::PacketSize &packetSize
     }
 }
 
-void PacketSizeController::detectAppropriatePacketSizeImpl(const QString &hostname)
+void PacketSizeController::detectAppropriatePacketSizeImpl(const QString &hostname, const QString &networkId)
 {
     {
         QMutexLocker locker(&mutex_);
         earlyStop_ = false;
     }
 
-    const int mtu = getIdealPacketSize(hostname);
+    int mtu;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto it = cache_.constFind(networkId);
+    if (!networkId.isEmpty() && it != cache_.constEnd() && now - it->detectionTime < kCacheExpirationMs)
+    {
+        qCDebug(LOG_PACKET_SIZE) << "Using the mtu detected earlier for this network";
+        mtu = it->mtu;
+    }
+    else
+    {
+        mtu = getIdealPacketSize(hostname);
+        if (mtu > 0 && !networkId.isEmpty())
+        {
+            cache_[networkId] = CachedMtu { mtu, now };
+        }
+    }
     const bool is_error = mtu < 0;
 
     QMutexLocker locker(&mutex_);
@@ -76,7 +96,6 @@ void PacketSizeController::detectAppropriatePacketSizeImpl(const QString &hostna
 
 int PacketSizeController::getIdealPacketSize(const QString &hostname)
 {
-    int mtu = 1470;
     QString modifiedHostname = hostname;
 
     // if this is IP, use without change
@@ -93,30 +112,83 @@ int PacketSizeController::getIdealPacketSize(const QString &hostname)
 
     qCDebug(LOG_PACKET_SIZE) << "Detecting packet size via:" << modifiedHostname;
 
-    bool success = false;
-    while (mtu >= 1300)
+    // resolve once, so the probes do not repeat the lookup
+    QString ip;
+    const QList<QHostAddress> addresses = QHostInfo::fromName(modifiedHostname).addresses();
+    for (const QHostAddress &address : addresses)
     {
-        QMutexLocker locker(&mutex_);
-        if (earlyStop_)
+        if (address.protocol() == QAbstractSocket::IPv4Protocol)
         {
-            qCDebug(LOG_PACKET_SIZE) << "Exiting packet size detection loop early";
+            ip = address.toString();
             break;
         }
+    }
+    if (ip.isEmpty())
+    {
+        qCDebug(LOG_PACKET_SIZE) << "Couldn't resolve" << modifiedHostname << "-- check internet connection";
+        return -1;
+    }
+
+    // search over [low, high] with kParallelProbes probes per round, the largest successful size so far is in best.
+    // The first round always probes kMaxMtu, which is the answer on most networks.
+    int low = kMinMtu;
+    int high = kMaxMtu;
+    int best = -1;
+    while (low <= high)
+    {
+        {
+            QMutexLocker locker(&mutex_);
+            if (earlyStop_)
+            {
+                qCDebug(LOG_PACKET_SIZE) << "Exiting packet size detection loop early";
+                return -1;
+            }
+        }
 
-        bool pingSuccess = NetworkUtils::pingWithMtu(modifiedHostname, mtu);
-        if (pingSuccess)
+        const int count = qMin(kParallelProbes, high - low + 1);
+        QVector<int> sizes;
+        std::vector<std::future<bool>> probes;
+        for (int i = 0; i < count; ++i)
         {
-            success = true;
-            break;
+            sizes << low + (high - low + 1) * (i + 1) / count - 1;
+            probes.push_back(std::async(std::launch::async, NetworkUtils::pingWithMtu, ip, sizes.last()));
+        }
+
+        QVector<bool> results;
+        for (auto &probe : probes)
+        {
+            results << probe.get();
+        }
+        qCDebug(LOG_PACKET_SIZE) << "Probed sizes" << sizes << "results" << results;
+
+        // a failure below a success is a lost probe, it does not limit the range
+        int newLow = low;
+        int newHigh = high;
+        for (int i = 0; i < count; ++i)
+        {
+            if (results[i])
+            {
+                best = sizes[i];
+                newLow = sizes[i] + 1;
+            }
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            if (!results[i] && sizes[i] >= newLow)
+            {
+                newHigh = sizes[i] - 1;
+                break;
+            }
         }
-        mtu -= 10;
+        low = newLow;
+        high = newHigh;
     }
 
-    if (!success)
+    if (best < 0)
     {
         qCDebug(LOG_PACKET_SIZE) << "Couldn't find appropriate MTU -- check internet connection";
         return -1;
     }
 
-    return mtu;
+    return best;
 }
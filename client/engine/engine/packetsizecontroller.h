@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QObject>
 #include <QMutex>
 #include "types/packetsize.h"
@@ -15,7 +16,8 @@ public:
     explicit PacketSizeController(QObject *parent = nullptr);
 
     void setPacketSize(const types::PacketSize &packetSize);
-    void detectAppropriatePacketSize(const QString &hostname);
+    // networkId identifies the current network (SSID or connection name), the detected size is cached for it
+    void detectAppropriatePacketSize(const QString &hostname, const QString &networkId);
     void earlyStop();
 
 signals:
@@ -27,13 +29,25 @@ public slots:
     void finish();
 
 private slots:
-    void detectAppropriatePacketSizeImpl(const QString &hostname);
+    void detectAppropriatePacketSizeImpl(const QString &hostname, const QString &networkId);
 
 private:
+    static constexpr int kMinMtu = 1300;
+    static constexpr int kMaxMtu = 1470;
+    static constexpr int kParallelProbes = 4;
+    static constexpr qint64 kCacheExpirationMs = 60 * 60 * 1000;
+
     QMutex mutex_;
     bool earlyStop_;
     types::PacketSize packetSize_;
 
+    struct CachedMtu
+    {
+        int mtu;
+        qint64 detectionTime;
+    };
+    QHash<QString, CachedMtu> cache_;     // by networkId, used only in the controller thread
+
 #ifdef Q_OS_WIN
     QScopedPointer<Debug::CrashHandlerForThread> crashHandler_;
 #endif
@@ -1,5 +1,7 @@
 #include "pingmanager.h"
 
+#include <algorithm>
+
 #include "../connectstatecontroller/iconnectstatecontroller.h"
 #include "types/pingtime.h"
 #include "utils/extraconfig.h"
@@ -62,6 +64,14 @@ void PingManager::clearIps()
     updateIps(QVector<PingIpInfo>());
 }
 
+void PingManager::setPriorityIps(const QStringList &ips)
+{
+    std::vector<std::string> priorityIps;
+    for (const auto &ip : ips)
+        priorityIps.push_back(ip.toStdString());
+    WSNet::instance()->pingManager()->setPriorityIps(priorityIps);
+}
+
 bool PingManager::isAllNodesHaveCurIteration() const
 {
     return pingStorage_.isAllNodesHaveCurIteration();
@@ -72,6 +82,11 @@ PingTime PingManager::getPing(const QString &ip) const
     return pingStorage_.getPing(ip);
 }
 
+PingStatistics PingManager::getPingStatistics(const QString &ip) const
+{
+    return pingStorage_.getPingStatistics(ip);
+}
+
 void PingManager::onPingTimer()
 {
     using namespace std::placeholders;
@@ -82,6 +97,9 @@ void PingManager::onPingTimer()
     if (ips_.isEmpty())
         return;
 
+    bool success;
+    samplesPerNode_ = qBound(1, ExtraConfig::instance().getPingSamples(success), MAX_SAMPLES_PER_NODE);
+
     QDateTime curDateTime = QDateTime::currentDateTimeUtc();
     QDateTime nextDateTime = QDateTime::fromMSecsSinceEpoch(pingStorage_.currentIterationTime(), Qt::UTC).addSecs(NEXT_PERIOD_SECS);
 
@@ -99,6 +117,8 @@ void PingManager::onPingTimer()
             pingLog_.addLog("PingIpsController::onPingTimer", "Re-ping all nodes by network change");
     }
 
+    // the pings are started with a batch per ping type
+    QMap<wsnet::PingType, QPair<QStringList, QStringList>> pingTargets;
     for (auto it = ips_.begin(); it != ips_.end(); ++it) {
         PingIpState &pni = it.value();
 
@@ -112,30 +132,60 @@ void PingManager::onPingTimer()
         }
 
         if (pni.iterationTime != pingStorage_.currentIterationTime()) {
-            pingLog_.addLog("PingNodesController::onPingTimer", QString::fromLatin1("ping new node: %1 (%2 - %3)").arg(pni.ipInfo.ip, pni.ipInfo.city, pni.ipInfo.nick));
+            if (pni.samples.isEmpty())
+                pingLog_.addLog("PingNodesController::onPingTimer", QString::fromLatin1("ping new node: %1 (%2 - %3)").arg(pni.ipInfo.ip, pni.ipInfo.city, pni.ipInfo.nick));
             pni.nowPinging = true;
-            WSNet::instance()->pingManager()->ping(pni.ipInfo.ip.toStdString(), pni.ipInfo.hostname.toStdString(), pingType,
-                        [this](const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState) {
-                            QMetaObject::invokeMethod(this, [this, ip, isSuccess, timeMs, isFromDisconnectedVpnState] {
-                                onPingFinished(ip, isSuccess, timeMs, isFromDisconnectedVpnState);
-                        });
-            });
+            pingTargets[pingType].first << pni.ipInfo.ip;
+            pingTargets[pingType].second << pni.ipInfo.hostname;
         } else if (pni.latestPingFailed) {
             if (pni.nextTimeForFailedPing == 0 || QDateTime::currentMSecsSinceEpoch() >= pni.nextTimeForFailedPing) {
                 pni.nowPinging = true;
                 pingLog_.addLog("PingNodesController::onPingTimer", "start ping because latest ping failed: " + it.key());
-                WSNet::instance()->pingManager()->ping(pni.ipInfo.ip.toStdString(), pni.ipInfo.hostname.toStdString(), pingType,
-                   [this](const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState) {
-                       QMetaObject::invokeMethod(this, [this, ip, isSuccess, timeMs, isFromDisconnectedVpnState] {
-                           onPingFinished(ip, isSuccess, timeMs, isFromDisconnectedVpnState);
-                    });
-                });
+                pingTargets[pingType].first << pni.ipInfo.ip;
+                pingTargets[pingType].second << pni.ipInfo.hostname;
             }
         }
     }
+
+    for (auto it = pingTargets.constBegin(); it != pingTargets.constEnd(); ++it)
+        pingBatch(it.value().first, it.value().second, it.key());
+}
+
+void PingManager::pingBatch(const QStringList &ips, const QStringList &hostnames, wsnet::PingType pingType)
+{
+    std::vector<std::string> ipsVector, hostnamesVector;
+    ipsVector.reserve(ips.size());
+    hostnamesVector.reserve(hostnames.size());
+    for (const auto &ip : ips)
+        ipsVector.push_back(ip.toStdString());
+    for (const auto &hostname : hostnames)
+        hostnamesVector.push_back(hostname.toStdString());
+
+    WSNet::instance()->pingManager()->pingBatch(ipsVector, hostnamesVector, pingType,
+        [this](const std::vector<std::string> &ips, const std::vector<bool> &isSuccess,
+               const std::vector<std::int32_t> &timesMs, const std::vector<bool> &isFromDisconnectedVpnState) {
+            QMetaObject::invokeMethod(this, [this, ips, isSuccess, timesMs, isFromDisconnectedVpnState] {
+                onPingBatchFinished(ips, isSuccess, timesMs, isFromDisconnectedVpnState);
+            });
+    });
 }
 
-void PingManager::onPingFinished(const std::string &ip, bool isSuccess, int32_t timeMs, bool isFromDisconnectedVpnState)
+void PingManager::onPingBatchFinished(const std::vector<std::string> &ips, const std::vector<bool> &isSuccess,
+                                      const std::vector<std::int32_t> &timesMs, const std::vector<bool> &isFromDisconnectedVpnState)
+{
+    QHash<QString, int> changedPings;
+    for (size_t i = 0; i < ips.size(); ++i)
+        onPingFinished(ips[i], isSuccess[i], timesMs[i], isFromDisconnectedVpnState[i], changedPings);
+
+    if (!changedPings.isEmpty())
+        emit pingInfosChanged(changedPings);
+
+    if (pingStorage_.isAllNodesHaveCurIteration()) {
+        pingLog_.addLog("PingIpsController::onPingFinished", "All nodes have the same iteration time");
+    }
+}
+
+void PingManager::onPingFinished(const std::string &ip, bool isSuccess, int32_t timeMs, bool isFromDisconnectedVpnState, QHash<QString, int> &changedPings)
 {
     QString ipStr = QString::fromStdString(ip);
 
@@ -148,6 +198,25 @@ void PingManager::onPingFinished(const std::string &ip, bool isSuccess, int32_t
     // Note: we only issue ping requests in the disconnected state.  However, it is possible we transitioned to the
     // connecting/connected state between the time the ping request was issued to PingHost and when it was executed.
     PingIpState &p = itNode.value();
+
+    // in the multi-sample mode, the next sample is taken on the next timer tick until there are enough of them
+    if (samplesPerNode_ > 1 && isFromDisconnectedVpnState) {
+        if (isSuccess)
+            p.samples << timeMs;
+        else if (!p.samples.isEmpty())
+            p.lostSamples++;
+
+        if (!p.samples.isEmpty()) {
+            if (p.samples.size() + p.lostSamples < samplesPerNode_)
+                return;
+            // the node is shown with the median of the samples
+            QVector<int> sorted = p.samples;
+            std::sort(sorted.begin(), sorted.end());
+            isSuccess = true;
+            timeMs = sorted[sorted.size() / 2];
+        }
+    }
+
     if (isSuccess) {
         p.nextTimeForFailedPing = 0;
         p.latestPingFailed = false;
@@ -157,8 +226,10 @@ void PingManager::onPingFinished(const std::string &ip, bool isSuccess, int32_t
         // we're back in the disconnected state.
         if (isFromDisconnectedVpnState) {
             p.iterationTime = pingStorage_.currentIterationTime();
-            pingStorage_.setPing(ipStr, timeMs);
-            emit pingInfoChanged(ipStr, timeMs);
+            pingStorage_.setPing(ipStr, timeMs, p.samples);
+            p.samples.clear();
+            p.lostSamples = 0;
+            changedPings[ipStr] = timeMs;
             pingLog_.addLog("PingIpsController::onPingFinished", QString::fromLatin1("ping successful: %1 (%2 - %3) %4ms").arg(p.ipInfo.ip, p.ipInfo.city, p.ipInfo.nick).arg(timeMs));
         }
         else {
@@ -177,7 +248,7 @@ void PingManager::onPingFinished(const std::string &ip, bool isSuccess, int32_t
             if (isFromDisconnectedVpnState) {
                 p.iterationTime = pingStorage_.currentIterationTime();
                 pingStorage_.setPing(ipStr, PingTime::PING_FAILED);
-                emit pingInfoChanged(ipStr, PingTime::PING_FAILED);
+                changedPings[ipStr] = PingTime::PING_FAILED;
             }
 
             if (failedPingLogController_.logFailedIPs(ipStr)) {
@@ -189,9 +260,6 @@ void PingManager::onPingFinished(const std::string &ip, bool isSuccess, int32_t
             p.nextTimeForFailedPing = QDateTime::currentMSecsSinceEpoch() + 1000 * p.curDelayForFailedPing;
         }
     }
-    if (pingStorage_.isAllNodesHaveCurIteration()) {
-        pingLog_.addLog("PingIpsController::onPingFinished", "All nodes have the same iteration time");
-    }
 }
 
 int PingManager::exponentialBackoff_GetNextDelay(int curDelay, float factor, float jitter, float maxDelay)
@@ -33,12 +33,16 @@ public:
 
     void updateIps(const QVector<PingIpInfo> &ips);
     void clearIps();
+    // these IPs are pinged before the others, shared by all the PingManager instances
+    void setPriorityIps(const QStringList &ips);
 
     bool isAllNodesHaveCurIteration() const;
     PingTime getPing(const QString &ip) const;
+    PingStatistics getPingStatistics(const QString &ip) const;
 
 signals:
-    void pingInfoChanged(const QString &ip, int timems);
+    // the ping times changed by a batch of ping results, ip -> time ms
+    void pingInfosChanged(const QHash<QString, int> &pingTimes);
 
 private slots:
     void onPingTimer();
@@ -48,6 +52,7 @@ private:
     static constexpr int MAX_FAILED_PING_IN_ROW = 3;
     static constexpr int MIN_DELAY_FOR_FAILED_IN_ROW_PINGS = 1;
     static constexpr int NEXT_PERIOD_SECS = 2*60*60*24;   //  How many secs to wait until the next ping (48 hours)
+    static constexpr int MAX_SAMPLES_PER_NODE = 10;
 
     IConnectStateController* const connectStateController_;
     INetworkDetectionManager* const networkDetectionManager_;
@@ -55,6 +60,7 @@ private:
     PingStorage pingStorage_;
     FailedPingLogController failedPingLogController_;
     PingLog pingLog_;
+    int samplesPerNode_ = 1;   // ws-ping-samples, the samples are taken one per PING_TIMER_INTERVAL
 
     struct PingIpState
     {
@@ -66,6 +72,8 @@ private:
         qint64 nextTimeForFailedPing;
         int curDelayForFailedPing = MIN_DELAY_FOR_FAILED_IN_ROW_PINGS;
         bool existThisIp;
+        QVector<int> samples;   // successful samples of the current iteration
+        int lostSamples;
 
         PingIpState()
         {
@@ -89,13 +97,18 @@ private:
             nextTimeForFailedPing = 0;
             curDelayForFailedPing = MIN_DELAY_FOR_FAILED_IN_ROW_PINGS;
             existThisIp = false;
+            samples.clear();
+            lostSamples = 0;
         }
     };
 
     QHash<QString, PingIpState> ips_;
     QTimer pingTimer_;
 
-    void onPingFinished(const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState);
+    void pingBatch(const QStringList &ips, const QStringList &hostnames, wsnet::PingType pingType);
+    void onPingBatchFinished(const std::vector<std::string> &ips, const std::vector<bool> &isSuccess,
+                             const std::vector<std::int32_t> &timesMs, const std::vector<bool> &isFromDisconnectedVpnState);
+    void onPingFinished(const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState, QHash<QString, int> &changedPings);
 
 
     // Exponential Backoff algorithm, get next delay
@@ -0,0 +1,57 @@
+#include "pingstatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+PingStatistics PingStatistics::fromSamples(QVector<int> samples, const PingStatistics &prev)
+{
+    PingStatistics s;
+    s.ewma = prev.ewma;
+    if (samples.isEmpty())
+        return s;
+
+    double jitter = 0;
+    for (int i = 1; i < samples.size(); ++i)
+        jitter += std::abs(samples[i] - samples[i - 1]);
+    s.jitter = samples.size() > 1 ? std::round(jitter / (samples.size() - 1)) : 0;
+
+    std::sort(samples.begin(), samples.end());
+    s.min = samples.first();
+    s.median = samples[samples.size() / 2];
+    s.p90 = samples[std::min((int)samples.size() - 1, (int)std::ceil(samples.size() * 0.9) - 1)];
+
+    if (s.ewma < 0)
+        s.ewma = s.median;
+    else
+        s.ewma = std::round(s.ewma + kEwmaAlpha * (s.median - s.ewma));
+    return s;
+}
+
+int PingStatistics::value(Type type) const
+{
+    switch (type) {
+    case Type::kMin:
+        return min;
+    case Type::kMedian:
+        return median;
+    case Type::kP90:
+        return p90;
+    case Type::kEwma:
+        return ewma;
+    default:
+        return -1;
+    }
+}
+
+PingStatistics::Type PingStatistics::typeFromString(const QString &str)
+{
+    if (str.compare("min", Qt::CaseInsensitive) == 0)
+        return Type::kMin;
+    if (str.compare("median", Qt::CaseInsensitive) == 0)
+        return Type::kMedian;
+    if (str.compare("p90", Qt::CaseInsensitive) == 0)
+        return Type::kP90;
+    if (str.compare("ewma", Qt::CaseInsensitive) == 0)
+        return Type::kEwma;
+    return Type::kLatest;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+// Latency statistics of a node in ms, -1 if unknown
+struct PingStatistics
+{
+    enum class Type { kLatest, kMin, kMedian, kP90, kEwma };
+
+    qint16 min = -1;
+    qint16 median = -1;
+    qint16 p90 = -1;
+    qint16 jitter = -1;     // mean difference between consecutive samples
+    qint16 ewma = -1;       // smoothed median across ping iterations
+
+    // samples of the current iteration, the EWMA is continued from the previous statistics
+    static PingStatistics fromSamples(QVector<int> samples, const PingStatistics &prev);
+
+    // -1 if not available
+    int value(Type type) const;
+
+    // ws-best-location-statistic values: "min", "median", "p90", "ewma", anything else is the latest ping time
+    static Type typeFromString(const QString &str);
+
+private:
+    static constexpr double kEwmaAlpha = 0.3;
+};
@@ -1,12 +1,44 @@
 #include "pingstorage.h"
 
-#include <QDataStream>
-#include <QIODevice>
+#include <QHostAddress>
 #include <QSettings>
 
+#include <cstring>
+
 #include "utils/simplecrypt.h"
 #include "types/global_consts.h"
 
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "PingStorage records are stored in the native byte order");
+
+namespace {
+
+int alignedSize(int size)
+{
+    return (size + 7) & ~7;
+}
+
+} // namespace
+
+PingStatistics PingStorage::PingRecord::stats() const
+{
+    PingStatistics s;
+    s.min = min;
+    s.median = median;
+    s.p90 = p90;
+    s.jitter = jitter;
+    s.ewma = ewma;
+    return s;
+}
+
+void PingStorage::PingRecord::setStats(const PingStatistics &stats)
+{
+    min = stats.min;
+    median = stats.median;
+    p90 = stats.p90;
+    jitter = stats.jitter;
+    ewma = stats.ewma;
+}
+
 PingStorage::PingStorage(const QString &settingsKey) : settingsKey_(settingsKey)
 {
     loadFromSettings();
@@ -19,31 +51,58 @@ PingStorage::~PingStorage()
 
 void PingStorage::setCurrentIterationData(qint64 msecsSinceEpoch, const QString &networkOrSsid)
 {
+    // the smoothed latency from another network is meaningless
+    if (networkOrSsid != curIterationNetworkOrSsid_) {
+        for (auto &record : records_)
+            record.ewma = -1;
+    }
     curIterationTime_ = msecsSinceEpoch;
     curIterationNetworkOrSsid_ = networkOrSsid;
+    recountPendingNodes();
 }
 
-void PingStorage::setPing(const QString &ip, PingTime timeMs)
+void PingStorage::setPing(const QString &ip, PingTime timeMs, const QVector<int> &samples)
 {
-    pingDataDB_[ip] = PingData{timeMs, curIterationTime_};
+    PingRecord *record = findRecord(ip);
+    if (!record)
+        record = &addRecord(toKey(ip));
+    else if (record->iterationTime != curIterationTime_)
+        pendingNodesCount_--;
+
+    if (timeMs == PingTime::PING_FAILED || timeMs == PingTime::NO_PING_INFO)
+        record->setStats(PingStatistics::fromSamples(QVector<int>(), record->stats()));
+    else
+        record->setStats(PingStatistics::fromSamples(samples.isEmpty() ? QVector<int>{ timeMs.toInt() } : samples, record->stats()));
+    record->timeMs = timeMs.toInt();
+    record->iterationTime = curIterationTime_;
 }
 
 PingTime PingStorage::getPing(const QString &ip) const
 {
-    auto it = pingDataDB_.constFind(ip);
-    if (it != pingDataDB_.constEnd()) {
-        return it.value().timeMs_;
+    const PingRecord *record = findRecord(ip);
+    if (record) {
+        return record->timeMs;
     }
 
     return PingTime::NO_PING_INFO;
 }
 
+PingStatistics PingStorage::getPingStatistics(const QString &ip) const
+{
+    const PingRecord *record = findRecord(ip);
+    if (record) {
+        return record->stats();
+    }
+
+    return PingStatistics();
+}
+
 void PingStorage::getPingData(const QString &ip, PingTime &outPingTime, qint64 &outIterationTime) const
 {
-    auto it = pingDataDB_.constFind(ip);
-    if (it != pingDataDB_.constEnd()) {
-        outPingTime = it.value().timeMs_;
-        outIterationTime = it.value().iterationTime_;
+    const PingRecord *record = findRecord(ip);
+    if (record) {
+        outPingTime = record->timeMs;
+        outIterationTime = record->iterationTime;
         return;
     }
 
@@ -53,39 +112,112 @@ void PingStorage::getPingData(const QString &ip, PingTime &outPingTime, qint64 &
 
 void PingStorage::initPingDataIfNotExists(const QString &ip)
 {
-    if (!pingDataDB_.contains(ip))
-        pingDataDB_[ip] = PingData();
+    const IpKey key = toKey(ip);
+    if (!index_.contains(key)) {
+        addRecord(key);
+        if (curIterationTime_ != 0)
+            pendingNodesCount_++;
+    }
 }
 
 void PingStorage::removePingNode(const QString &ip)
 {
-    pingDataDB_.remove(ip);
+    auto it = index_.find(toKey(ip));
+    if (it == index_.end())
+        return;
+
+    int ind = it.value();
+    if (records_[ind].iterationTime != curIterationTime_)
+        pendingNodesCount_--;
+    index_.erase(it);
+
+    // move the last record to the freed slot
+    int last = records_.size() - 1;
+    if (ind != last) {
+        records_[ind] = records_[last];
+        index_[toKey(records_[ind])] = ind;
+    }
+    records_.removeLast();
 }
 
 bool PingStorage::isAllNodesHaveCurIteration() const
 {
-    for (const auto &it : pingDataDB_.values())
-        if (it.iterationTime_ != curIterationTime_)
-            return false;
+    Q_ASSERT(pendingNodesCount_ >= 0);
+    return pendingNodesCount_ == 0;
+}
 
-    return true;
+PingStorage::PingRecord *PingStorage::findRecord(const QString &ip)
+{
+    auto it = index_.constFind(toKey(ip));
+    return it != index_.constEnd() ? &records_[it.value()] : nullptr;
 }
 
-void PingStorage::saveToSettings()
+const PingStorage::PingRecord *PingStorage::findRecord(const QString &ip) const
+{
+    auto it = index_.constFind(toKey(ip));
+    return it != index_.constEnd() ? &records_[it.value()] : nullptr;
+}
+
+PingStorage::PingRecord &PingStorage::addRecord(const IpKey &key)
+{
+    PingRecord record;
+    memset(&record, 0, sizeof(record));
+    memcpy(record.ip, key.ip, sizeof(record.ip));
+    record.timeMs = PingTime::NO_PING_INFO;
+    record.setStats(PingStatistics());
+    index_[key] = records_.size();
+    records_.append(record);
+    return records_.last();
+}
+
+PingStorage::IpKey PingStorage::toKey(const QString &ip)
 {
-    QByteArray arr;
-    {
-        QDataStream ds(&arr, QIODevice::WriteOnly);
-        ds << magic_;
-        ds << versionForSerialization_;
-        ds << curIterationTime_;
-        ds << curIterationNetworkOrSsid_;
-        ds << pingDataDB_.size();
-        for (auto it = pingDataDB_.begin(); it != pingDataDB_.end(); ++it) {
-            ds << it.key() << it.value().timeMs_.toInt() << it.value().iterationTime_;
-        }
+    // the models pass the IP addresses only, a malformed one gets the all-zero key
+    IpKey key;
+    QHostAddress address;
+    if (address.setAddress(ip)) {
+        Q_IPV6ADDR ipv6 = address.toIPv6Address();
+        memcpy(key.ip, ipv6.c, sizeof(key.ip));
+    } else {
+        memset(key.ip, 0, sizeof(key.ip));
     }
+    return key;
+}
+
+PingStorage::IpKey PingStorage::toKey(const PingRecord &record)
+{
+    IpKey key;
+    memcpy(key.ip, record.ip, sizeof(key.ip));
+    return key;
+}
+
+void PingStorage::recountPendingNodes()
+{
+    pendingNodesCount_ = 0;
+    for (const auto &record : qAsConst(records_))
+        if (record.iterationTime != curIterationTime_)
+            pendingNodesCount_++;
+}
+
+void PingStorage::saveToSettings()
+{
+    const QByteArray networkName = curIterationNetworkOrSsid_.toUtf8();
 
+    QByteArray arr(sizeof(Header) + alignedSize(networkName.size()), 0);
+    memcpy(arr.data() + sizeof(Header), networkName.constData(), networkName.size());
+    arr.append(reinterpret_cast<const char *>(records_.constData()), records_.size() * sizeof(PingRecord));
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = magic_;
+    header.version = versionForSerialization_;
+    header.curIterationTime = curIterationTime_;
+    header.recordsCount = records_.size();
+    header.networkNameSize = networkName.size();
+    header.checksum = qChecksum(QByteArrayView(arr).sliced(sizeof(Header)));
+    memcpy(arr.data(), &header, sizeof(header));
+
+    // the network name and the IPs are private, so the blob is stored encrypted as before
     QSettings settings;
     SimpleCrypt simpleCrypt(SIMPLE_CRYPT_KEY);
     settings.setValue(settingsKey_, simpleCrypt.encryptToString(arr));
@@ -94,50 +226,39 @@ void PingStorage::saveToSettings()
 void PingStorage::loadFromSettings()
 {
     curIterationNetworkOrSsid_.clear();
-    pingDataDB_.clear();
+    records_.clear();
+    index_.clear();
 
     QSettings settings;
     if (!settings.contains(settingsKey_)) {
         return;
     }
 
+    // the data of the previous versions is dropped by the header check
     SimpleCrypt simpleCrypt(SIMPLE_CRYPT_KEY);
-    QString str = settings.value(settingsKey_).toString();
-    QByteArray arr = simpleCrypt.decryptToByteArray(str);
-
-    QDataStream ds(&arr, QIODevice::ReadOnly);
-    quint32 magic;
-    ds >> magic;
-
-    if (magic == magic_) {
-        quint32 version;
-        ds >> version;
-
-        if (version != versionForSerialization_)
-            return;
-
-        ds >> curIterationTime_;
-        ds >> curIterationNetworkOrSsid_;
-
-        qsizetype numDBElements;
-        ds >> numDBElements;
-        for (qsizetype i = 0; i < numDBElements; ++i) {
-            QString ip;
-            int timeMs;
-            qint64 iterationTime;
-            ds >> ip >> timeMs >> iterationTime;
-
-            PingData pingData;
-            pingData.timeMs_ = timeMs;
-            pingData.iterationTime_ = iterationTime;
-
-            pingDataDB_[ip] = pingData;
-        }
-
-        if (ds.status() != QDataStream::Ok) {
-            pingDataDB_.clear();
-            curIterationTime_ = 0;
-            curIterationNetworkOrSsid_.clear();
-        }
+    const QByteArray arr = simpleCrypt.decryptToByteArray(settings.value(settingsKey_).toString());
+    if (arr.size() < (qsizetype)sizeof(Header))
+        return;
+
+    Header header;
+    memcpy(&header, arr.constData(), sizeof(header));
+    if (header.magic != magic_ || header.version != versionForSerialization_ || header.networkNameSize > (quint32)arr.size())
+        return;
+
+    const qsizetype networkNameOffset = sizeof(Header);
+    const qsizetype recordsOffset = networkNameOffset + alignedSize(header.networkNameSize);
+    if (arr.size() != recordsOffset + (qsizetype)header.recordsCount * (qsizetype)sizeof(PingRecord) ||
+        header.checksum != qChecksum(QByteArrayView(arr).sliced(sizeof(Header)))) {
+        return;
     }
+
+    curIterationTime_ = header.curIterationTime;
+    curIterationNetworkOrSsid_ = QString::fromUtf8(arr.constData() + networkNameOffset, header.networkNameSize);
+    records_.resize(header.recordsCount);
+    memcpy(records_.data(), arr.constData() + recordsOffset, header.recordsCount * sizeof(PingRecord));
+    index_.reserve(header.recordsCount);
+    for (int i = 0; i < records_.size(); ++i)
+        index_[toKey(records_[i])] = i;
+
+    recountPendingNodes();
 }
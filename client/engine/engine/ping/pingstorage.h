@@ -1,8 +1,12 @@
 #pragma once
 
 #include <QHash>
+#include <QVector>
+
+#include <cstring>
 
 #include "types/pingtime.h"
+#include "pingstatistics.h"
 
 // IP ping storage that saves state between program launches
 class PingStorage
@@ -16,8 +20,10 @@ public:
 
     void setCurrentIterationData(qint64 msecsSinceEpoch, const QString &networkOrSsid);
 
-    void setPing(const QString &ip, PingTime timeMs);
+    // samples - all successful samples of the node in the current iteration, if empty then timeMs is the only sample
+    void setPing(const QString &ip, PingTime timeMs, const QVector<int> &samples = QVector<int>());
     PingTime getPing(const QString &ip) const;
+    PingStatistics getPingStatistics(const QString &ip) const;
     void getPingData(const QString &ip, PingTime &outPingTime, qint64 &outIterationTime) const;
     void initPingDataIfNotExists(const QString &ip);
 
@@ -26,22 +32,65 @@ public:
     bool isAllNodesHaveCurIteration() const;
 
 private:
-    struct PingData
+    // Fixed-size record of a node, stored as is: the saved data is the header, the network name and the array of records,
+    // encrypted as a whole.
+    struct PingRecord
+    {
+        quint8 ip[16];              // IPv6 or IPv4-mapped IPv6 address
+        qint64 iterationTime;
+        qint32 timeMs;
+        qint16 min;
+        qint16 median;
+        qint16 p90;
+        qint16 jitter;
+        qint16 ewma;
+        qint16 reserved;
+
+        PingStatistics stats() const;
+        void setStats(const PingStatistics &stats);
+    };
+    static_assert(sizeof(PingRecord) == 40, "PingRecord must have a fixed size");
+
+    struct Header
     {
-        PingTime timeMs_;
-        qint64 iterationTime_ = 0;
+        quint32 magic;
+        quint32 version;
+        qint64 curIterationTime;
+        quint32 recordsCount;
+        quint32 networkNameSize;    // in bytes, padded to 8 in the data
+        quint32 checksum;           // CRC of the data after the header
+        quint32 reserved;
+    };
+    static_assert(sizeof(Header) == 32, "Header must have a fixed size");
+
+    // the packed address, so the different textual forms of an IP address find the same record
+    struct IpKey
+    {
+        quint8 ip[16];
+
+        bool operator==(const IpKey &other) const { return memcmp(ip, other.ip, sizeof(ip)) == 0; }
+        friend size_t qHash(const IpKey &key, size_t seed = 0) { return qHashBits(key.ip, sizeof(key.ip), seed); }
     };
 
     const QString settingsKey_;
     qint64 curIterationTime_ = 0;    // last iteration date and time in UTC time in ms
     QString curIterationNetworkOrSsid_;     // the name of the network to which the pings were made
 
-    // Maps the ip to its ping data.
-    QHash<QString, PingData> pingDataDB_;
+    // records are updated in place, the index maps the packed ip to its record
+    QVector<PingRecord> records_;
+    QHash<IpKey, int> index_;
+    // number of nodes without the ping of the current iteration
+    int pendingNodesCount_ = 0;
 
-    static constexpr quint32 magic_ = 0x734AB2AE;
-    static constexpr int versionForSerialization_ = 3;  // should increment the version if the data format is changed
+    static constexpr quint32 magic_ = 0x734AB2AF;
+    static constexpr quint32 versionForSerialization_ = 6;  // should increment the version if the data format is changed
 
+    PingRecord *findRecord(const QString &ip);
+    const PingRecord *findRecord(const QString &ip) const;
+    PingRecord &addRecord(const IpKey &key);
+    static IpKey toKey(const QString &ip);
+    static IpKey toKey(const PingRecord &record);
+    void recountPendingNodes();
     void saveToSettings();
     void loadFromSettings();
 };
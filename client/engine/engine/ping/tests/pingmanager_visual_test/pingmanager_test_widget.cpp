@@ -42,8 +42,9 @@ Widget::Widget(QWidget *parent)
     accessManager_ = new NetworkAccessManager(this);
     pingHosts_ = new PingMultipleHosts(this, connectStateController_, accessManager_);
     pingManager_ = new PingManager(this, connectStateController_, networkDetectionManager_, pingHosts_, "pingData", "pingmanager.log");
-    connect(pingManager_, &PingManager::pingInfoChanged, [this](const QString &ip, int timems) {
-        qDebug() << "Finished ip: " << ip << " -> " << timems << "ms";
+    connect(pingManager_, &PingManager::pingInfosChanged, [this](const QHash<QString, int> &pingTimes) {
+        for (auto it = pingTimes.constBegin(); it != pingTimes.constEnd(); ++it)
+            qDebug() << "Finished ip: " << it.key() << " -> " << it.value() << "ms";
         if (pingManager_->isAllNodesHaveCurIteration()) {
             qDebug() << "All nodes have the same iteration";
         }
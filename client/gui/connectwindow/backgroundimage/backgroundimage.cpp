@@ -76,6 +76,16 @@ void BackgroundImage::setIsConnected(bool isConnected)
     }
 }
 
+void BackgroundImage::setMovieCacheMode(QMovie *movie)
+{
+    // the small animations are decoded once and then played from memory, the big ones are decoded frame by frame
+    const QSize size = movie->scaledSize();
+    const qint64 decodedSize = (qint64)movie->frameCount() * size.width() * size.height() * 4;
+    if (movie->frameCount() > 1 && decodedSize <= kMaxCachedMovieBytes) {
+        movie->setCacheMode(QMovie::CacheAll);
+    }
+}
+
 void BackgroundImage::updateScaling()
 {
     handleBackgroundsChange();
@@ -105,6 +115,7 @@ void BackgroundImage::handleBackgroundsChange()
             }
             else {
                 movie->setScaledSize(QSize(WIDTH * G_SCALE, 137 * G_SCALE) * DpiScaleManager::instance().curDevicePixelRatio());
+                setMovieCacheMode(movie.get());
                 disconnectedMovie_ = movie;
             }
         }
@@ -120,6 +131,7 @@ void BackgroundImage::handleBackgroundsChange()
             }
             else {
                 movie->setScaledSize(QSize(WIDTH * G_SCALE, 137 * G_SCALE) * DpiScaleManager::instance().curDevicePixelRatio());
+                setMovieCacheMode(movie.get());
                 connectedMovie_ = movie;
             }
         }
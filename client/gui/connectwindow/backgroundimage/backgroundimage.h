@@ -37,6 +37,7 @@ private slots:
 private:
     static constexpr int WIDTH = 332;
     static constexpr int ANIMATION_DURATION = 500;
+    static constexpr qint64 kMaxCachedMovieBytes = 32 * 1024 * 1024;
 
     QString connectingGradient_;
     QString connectedGradient_;
@@ -63,6 +64,7 @@ private:
     void safeChangeToConnectedImage(bool bShowPrevChangeAnimation);
     void switchConnectGradient(bool isCustomBackground);
     void updateImages();
+    void setMovieCacheMode(QMovie *movie);
 };
 
 } //namespace ConnectWindow
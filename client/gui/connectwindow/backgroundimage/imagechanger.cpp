@@ -8,22 +8,22 @@
 namespace ConnectWindow {
 
 ImageChanger::ImageChanger(QObject *parent, int animationDuration) : QObject(parent),
-    pixmap_(nullptr), opacityCurImage_(1.0), opacityPrevImage_(0.0), animationDuration_(animationDuration)
+    backBuffer_(0), composedPixelRatio_(0.0), composedFramesBytes_(0), flagGradientScale_(0.0), opacityCurImage_(1.0), opacityPrevImage_(0.0), animationDuration_(animationDuration)
 {
     connect(&opacityAnimation_, &QVariantAnimation::valueChanged, this, &ImageChanger::onOpacityChanged);
     connect(&opacityAnimation_, &QVariantAnimation::finished, this, &ImageChanger::onOpacityFinished);
 
-    connect(&MainWindowState::instance(), &MainWindowState::isActiveChanged, this, &ImageChanger::onMainWindowIsActiveChanged);
+    connect(&MainWindowState::instance(), &MainWindowState::isActiveChanged, this, &ImageChanger::onMainWindowStateChanged);
+    connect(&MainWindowState::instance(), &MainWindowState::isExposedChanged, this, &ImageChanger::onMainWindowStateChanged);
 }
 
 ImageChanger::~ImageChanger()
 {
-    SAFE_DELETE(pixmap_);
 }
 
 QPixmap *ImageChanger::currentPixmap()
 {
-    return pixmap_;
+    return pixmap_.isNull() ? nullptr : &pixmap_;
 }
 
 void ImageChanger::setImage(QSharedPointer<IndependentPixmap> pixmap, bool bShowPrevChangeAnimation)
@@ -36,6 +36,7 @@ void ImageChanger::setImage(QSharedPointer<IndependentPixmap> pixmap, bool bShow
         curImage_.pixmap = pixmap;
         opacityPrevImage_ = 0.0;
         opacityCurImage_ = 1.0;
+        clearComposedFrames();
         updatePixmap();
     }
     else
@@ -58,9 +59,10 @@ void ImageChanger::setImage(QSharedPointer<IndependentPixmap> pixmap, bool bShow
         opacityAnimation_.setDuration((1.0 - opacityCurImage_) * animationDuration_);
 
         opacityAnimation_.start();
+        clearComposedFrames();
         updatePixmap();
     }
-    onMainWindowIsActiveChanged(MainWindowState::instance().isActive());
+    onMainWindowStateChanged();
 }
 
 void ImageChanger::setMovie(QSharedPointer<QMovie> movie, bool bShowPrevChangeAnimation)
@@ -75,6 +77,7 @@ void ImageChanger::setMovie(QSharedPointer<QMovie> movie, bool bShowPrevChangeAn
         curImage_.movie = movie;
         opacityPrevImage_ = 0.0;
         opacityCurImage_ = 1.0;
+        clearComposedFrames();
         connect(curImage_.movie.get(), &QMovie::updated, this, &ImageChanger::updatePixmap);
         curImage_.movie->start();
     }
@@ -98,11 +101,12 @@ void ImageChanger::setMovie(QSharedPointer<QMovie> movie, bool bShowPrevChangeAn
         opacityAnimation_.setEndValue(1.0);
         opacityAnimation_.setDuration((1.0 - opacityCurImage_) * animationDuration_);
 
+        clearComposedFrames();
         connect(curImage_.movie.get(), &QMovie::updated, this, &ImageChanger::updatePixmap);
         curImage_.movie->start();
         opacityAnimation_.start();
     }
-    onMainWindowIsActiveChanged(MainWindowState::instance().isActive());
+    onMainWindowStateChanged();
 }
 
 void ImageChanger::onOpacityChanged(const QVariant &value)
@@ -126,11 +130,38 @@ void ImageChanger::onOpacityFinished()
 
 void ImageChanger::updatePixmap()
 {
-    SAFE_DELETE(pixmap_);
+    const qreal pixelRatio = DpiScaleManager::instance().curDevicePixelRatio();
+    const QSize size(WIDTH * G_SCALE * pixelRatio, 176 * G_SCALE * pixelRatio);
+    if (composedSize_ != size || composedPixelRatio_ != pixelRatio)
+    {
+        composedSize_ = size;
+        composedPixelRatio_ = pixelRatio;
+        buffers_[0] = QPixmap();
+        buffers_[1] = QPixmap();
+        clearComposedFrames();
+    }
+    if (buffers_[backBuffer_].isNull())
+    {
+        buffers_[backBuffer_] = QPixmap(size);
+        buffers_[backBuffer_].setDevicePixelRatio(pixelRatio);
+    }
+
+    // a movie frame composed earlier is shown as is
+    const bool isComposedFrameCacheable = curImage_.isValid() && curImage_.isMovie && !prevImage_.isValid() &&
+                                          curImage_.movie->cacheMode() == QMovie::CacheAll;
+    if (isComposedFrameCacheable)
+    {
+        auto it = composedFrames_.constFind(curImage_.movie->currentFrameNumber());
+        if (it != composedFrames_.constEnd())
+        {
+            pixmap_ = it.value();
+            emit updated();
+            return;
+        }
+    }
 
-    pixmap_ = new QPixmap(WIDTH * G_SCALE * DpiScaleManager::instance().curDevicePixelRatio(), 176 * G_SCALE * DpiScaleManager::instance().curDevicePixelRatio());
-    pixmap_->setDevicePixelRatio(DpiScaleManager::instance().curDevicePixelRatio());
-    pixmap_->fill(QColor(2, 13, 28));
+    QPixmap *pixmap = &buffers_[backBuffer_];
+    pixmap->fill(QColor(2, 13, 28));
 
     // prev and current gradient info
     enum GRADIENT { GRADIENT_NONE, GRADIENT_FLAG, GRADIENT_CUSTOM_BACKGROUND };
@@ -152,7 +183,7 @@ void ImageChanger::updatePixmap()
     }
 
     {
-        QPainter p(pixmap_);
+        QPainter p(pixmap);
 
         if (prevImage_.isValid())
         {
@@ -164,16 +195,13 @@ void ImageChanger::updatePixmap()
                 if (curGradient != GRADIENT_FLAG)
                 {
                     p.setOpacity(opacityPrevImage_);
-                    QSharedPointer<IndependentPixmap> pixmap = ImageResourcesSvg::instance().getIndependentPixmap("background/FLAG_GRADIENT");
-                    pixmap->draw(0, 0, &p);
+                    flagGradient()->draw(0, 0, &p);
                 }
             }
             else
             {
                 p.setOpacity(opacityPrevImage_);
-                QPixmap framePixmap = prevImage_.movie->currentPixmap();
-                framePixmap.setDevicePixelRatio(DpiScaleManager::instance().curDevicePixelRatio());
-                p.drawPixmap(0, ceil(7.0 * G_SCALE), framePixmap);
+                drawMovieFrame(&p, prevImage_.movie.get());
 
                 if (curGradient != GRADIENT_CUSTOM_BACKGROUND)
                 {
@@ -198,15 +226,12 @@ void ImageChanger::updatePixmap()
                 {
                     p.setOpacity(1.0);
                 }
-                QSharedPointer<IndependentPixmap> pixmap = ImageResourcesSvg::instance().getIndependentPixmap("background/FLAG_GRADIENT");
-                pixmap->draw(0, 0, &p);
+                flagGradient()->draw(0, 0, &p);
             }
             else
             {
                 p.setOpacity(opacityCurImage_);
-                QPixmap framePixmap = curImage_.movie->currentPixmap();
-                framePixmap.setDevicePixelRatio(DpiScaleManager::instance().curDevicePixelRatio());
-                p.drawPixmap(0, ceil(7.0 * G_SCALE), framePixmap);
+                drawMovieFrame(&p, curImage_.movie.get());
 
                 if (prevGradient == GRADIENT_FLAG)
                 {
@@ -220,21 +245,40 @@ void ImageChanger::updatePixmap()
             }
         }
     }
+
+    pixmap_ = *pixmap;
+    const qint64 frameBytes = (qint64)size.width() * size.height() * pixmap->depth() / 8;
+    if (isComposedFrameCacheable && composedFramesBytes_ + frameBytes <= kMaxComposedFramesBytes)
+    {
+        composedFrames_[curImage_.movie->currentFrameNumber()] = *pixmap;
+        composedFramesBytes_ += frameBytes;
+        // the cached frame keeps this buffer, the next one is drawn into a new surface
+        buffers_[backBuffer_] = QPixmap();
+    }
+    backBuffer_ = 1 - backBuffer_;
     emit updated();
 }
 
-void ImageChanger::onMainWindowIsActiveChanged(bool isActive)
+void ImageChanger::onMainWindowStateChanged()
 {
+    // no frames are decoded or composed while nobody can see them
+    const bool isPaused = !MainWindowState::instance().isActive() || !MainWindowState::instance().isExposed();
     if (curImage_.isValid() && curImage_.isMovie && curImage_.movie)
     {
-        curImage_.movie->setPaused(!isActive);
+        curImage_.movie->setPaused(isPaused);
     }
     if (prevImage_.isValid() && prevImage_.isMovie && prevImage_.movie)
     {
-        prevImage_.movie->setPaused(!isActive);
+        prevImage_.movie->setPaused(isPaused);
     }
 }
 
+void ImageChanger::clearComposedFrames()
+{
+    composedFrames_.clear();
+    composedFramesBytes_ = 0;
+}
+
 void ImageChanger::generateCustomGradient(const QSize &size)
 {
     if (customGradient_.isNull() || customGradient_.size() != size)
@@ -251,6 +295,25 @@ void ImageChanger::generateCustomGradient(const QSize &size)
     }
 }
 
+QSharedPointer<IndependentPixmap> ImageChanger::flagGradient()
+{
+    const qreal scale = G_SCALE * DpiScaleManager::instance().curDevicePixelRatio();
+    if (!flagGradient_ || flagGradientScale_ != scale)
+    {
+        flagGradient_ = ImageResourcesSvg::instance().getIndependentPixmap("background/FLAG_GRADIENT");
+        flagGradientScale_ = scale;
+    }
+    return flagGradient_;
+}
+
+void ImageChanger::drawMovieFrame(QPainter *painter, QMovie *movie)
+{
+    // drawn into the logical size instead of setting the device pixel ratio, which would detach (copy) the frame
+    const QPixmap frame = movie->currentPixmap();
+    const qreal ratio = DpiScaleManager::instance().curDevicePixelRatio();
+    painter->drawPixmap(QRectF(0, ceil(7.0 * G_SCALE), frame.width() / ratio, frame.height() / ratio), frame, QRectF(frame.rect()));
+}
+
 
 
 } //namespace ConnectWindow
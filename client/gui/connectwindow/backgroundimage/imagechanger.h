@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QObject>
 #include <QVariantAnimation>
 #include <QMovie>
@@ -26,12 +27,26 @@ private slots:
     void onOpacityChanged(const QVariant &value);
     void onOpacityFinished();
     void updatePixmap();
-    void onMainWindowIsActiveChanged(bool isActive);
+    void onMainWindowStateChanged();
 
 private:
     static constexpr int WIDTH = 332;
-
-    QPixmap *pixmap_;
+    // the composed frames are full-size surfaces, unlike the decoded movie frames
+    static constexpr qint64 kMaxComposedFramesBytes = 32 * 1024 * 1024;
+
+    // the composition surfaces are reused while the size does not change, the back one is drawn while the front one is shown
+    QPixmap buffers_[2];
+    int backBuffer_;
+    // the size and device pixel ratio of the composition surfaces and of composedFrames_
+    QSize composedSize_;
+    qreal composedPixelRatio_;
+    // the front buffer or one of composedFrames_
+    QPixmap pixmap_;
+    // the composed frames of the fully decoded (QMovie::CacheAll) movies without a change animation, by frame number
+    QHash<int, QPixmap> composedFrames_;
+    qint64 composedFramesBytes_;
+    QSharedPointer<IndependentPixmap> flagGradient_;
+    qreal flagGradientScale_;
     qreal opacityCurImage_;
     qreal opacityPrevImage_;
     int animationDuration_;
@@ -75,7 +90,10 @@ private:
 
     QPixmap customGradient_;
 
+    void clearComposedFrames();
     void generateCustomGradient(const QSize &size);
+    QSharedPointer<IndependentPixmap> flagGradient();
+    void drawMovieFrame(QPainter *painter, QMovie *movie);
 
 };
 
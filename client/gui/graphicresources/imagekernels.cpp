@@ -0,0 +1,233 @@
+#include "imagekernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGE_KERNELS_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define IMAGE_KERNELS_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace {
+
+// x / 255 rounded, exact for x <= 255 * 255
+inline uint div255(uint x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline QRgb grayscaleLightenPixel(QRgb p)
+{
+    // lighter(200) of a gray doubles the value and saturates at 255
+    const uint l = qMin(uint(qGray(p)) * 2, 255u);
+    return qRgba(l, l, l, qAlpha(p));
+}
+
+inline QRgb multiplyPixel(QRgb p, uint factor)
+{
+    return qRgba(div255(qRed(p) * factor), div255(qGreen(p) * factor), div255(qBlue(p) * factor), div255(qAlpha(p) * factor));
+}
+
+inline QRgb tintPixel(QRgb p, QRgb premultipliedColor)
+{
+    return multiplyPixel(premultipliedColor, qAlpha(p));
+}
+
+#if defined(IMAGE_KERNELS_SSE2)
+
+inline __m128i div255(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+int grayscaleLightenSimd(QRgb *pixels, int count)
+{
+    const __m128i kByteMask = _mm_set1_epi32(0xFF);
+    const __m128i kAlphaMask = _mm_set1_epi32(0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+        const __m128i b = _mm_and_si128(p, kByteMask);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(p, 8), kByteMask);
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), kByteMask);
+        // the upper halves of the 32-bit lanes are zero, so the 16-bit multiplication is enough
+        __m128i sum = _mm_add_epi32(_mm_mullo_epi16(r, _mm_set1_epi32(11)), _mm_slli_epi32(g, 4));
+        sum = _mm_add_epi32(sum, _mm_mullo_epi16(b, _mm_set1_epi32(5)));
+        const __m128i l = _mm_min_epi16(_mm_slli_epi32(_mm_srli_epi32(sum, 5), 1), kByteMask);
+        __m128i out = _mm_or_si128(l, _mm_slli_epi32(l, 8));
+        out = _mm_or_si128(out, _mm_slli_epi32(l, 16));
+        out = _mm_or_si128(out, _mm_and_si128(p, kAlphaMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), out);
+    }
+    return i;
+}
+
+int multiplySimd(QRgb *pixels, int count, uint factor)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i f = _mm_set1_epi16(factor);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+        const __m128i lo = div255(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), f));
+        const __m128i hi = div255(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), f));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+int tintSimd(QRgb *pixels, int count, QRgb premultipliedColor)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i color = _mm_unpacklo_epi8(_mm_set1_epi32(premultipliedColor), zero);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+        // the alpha of each pixel in all four of its 16-bit lanes
+        __m128i alphaLo = _mm_unpacklo_epi8(p, zero);
+        alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(alphaLo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i alphaHi = _mm_unpackhi_epi8(p, zero);
+        alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(alphaHi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i lo = div255(_mm_mullo_epi16(alphaLo, color));
+        const __m128i hi = div255(_mm_mullo_epi16(alphaHi, color));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+#elif defined(IMAGE_KERNELS_NEON)
+
+inline uint8x8_t div255(uint16x8_t x)
+{
+    x = vaddq_u16(x, vdupq_n_u16(128));
+    return vshrn_n_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), 8);
+}
+
+int grayscaleLightenSimd(QRgb *pixels, int count)
+{
+    const uint32x4_t kByteMask = vdupq_n_u32(0xFF);
+    const uint32x4_t kAlphaMask = vdupq_n_u32(0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t p = vld1q_u32(pixels + i);
+        const uint32x4_t b = vandq_u32(p, kByteMask);
+        const uint32x4_t g = vandq_u32(vshrq_n_u32(p, 8), kByteMask);
+        const uint32x4_t r = vandq_u32(vshrq_n_u32(p, 16), kByteMask);
+        uint32x4_t sum = vmulq_n_u32(r, 11);
+        sum = vmlaq_n_u32(sum, g, 16);
+        sum = vmlaq_n_u32(sum, b, 5);
+        const uint32x4_t l = vminq_u32(vshlq_n_u32(vshrq_n_u32(sum, 5), 1), kByteMask);
+        uint32x4_t out = vorrq_u32(l, vshlq_n_u32(l, 8));
+        out = vorrq_u32(out, vshlq_n_u32(l, 16));
+        out = vorrq_u32(out, vandq_u32(p, kAlphaMask));
+        vst1q_u32(pixels + i, out);
+    }
+    return i;
+}
+
+int multiplySimd(QRgb *pixels, int count, uint factor)
+{
+    const uint8x8_t f = vdup_n_u8(factor);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint8x16_t p = vreinterpretq_u8_u32(vld1q_u32(pixels + i));
+        const uint8x8_t lo = div255(vmull_u8(vget_low_u8(p), f));
+        const uint8x8_t hi = div255(vmull_u8(vget_high_u8(p), f));
+        vst1q_u32(pixels + i, vreinterpretq_u32_u8(vcombine_u8(lo, hi)));
+    }
+    return i;
+}
+
+int tintSimd(QRgb *pixels, int count, QRgb premultipliedColor)
+{
+    // the alpha of each pixel in all four of its bytes
+    static const uint8_t kAlphaIndexes[16] = { 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15 };
+    const uint8x16_t alphaIndexes = vld1q_u8(kAlphaIndexes);
+    const uint8x8_t color = vreinterpret_u8_u32(vdup_n_u32(premultipliedColor));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint8x16_t alpha = vqtbl1q_u8(vreinterpretq_u8_u32(vld1q_u32(pixels + i)), alphaIndexes);
+        const uint8x8_t lo = div255(vmull_u8(vget_low_u8(alpha), color));
+        const uint8x8_t hi = div255(vmull_u8(vget_high_u8(alpha), color));
+        vst1q_u32(pixels + i, vreinterpretq_u32_u8(vcombine_u8(lo, hi)));
+    }
+    return i;
+}
+
+#else
+
+int grayscaleLightenSimd(QRgb *, int)
+{
+    return 0;
+}
+
+int multiplySimd(QRgb *, int, uint)
+{
+    return 0;
+}
+
+int tintSimd(QRgb *, int, QRgb)
+{
+    return 0;
+}
+
+#endif
+
+void ensureArgb32(QImage &image)
+{
+    if (image.format() != QImage::Format_ARGB32_Premultiplied && image.format() != QImage::Format_ARGB32 &&
+        image.format() != QImage::Format_RGB32) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+}
+
+void ensureArgb32Premultiplied(QImage &image)
+{
+    if (image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+}
+
+} // namespace
+
+namespace ImageKernels
+{
+
+void grayscaleLighten(QImage &image)
+{
+    ensureArgb32(image);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *scanline = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = grayscaleLightenSimd(scanline, image.width()); x < image.width(); ++x) {
+            scanline[x] = grayscaleLightenPixel(scanline[x]);
+        }
+    }
+}
+
+void opacity(QImage &image, qreal opacity)
+{
+    ensureArgb32Premultiplied(image);
+    const uint factor = qBound(0, qRound(opacity * 255), 255);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *scanline = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = multiplySimd(scanline, image.width(), factor); x < image.width(); ++x) {
+            scanline[x] = multiplyPixel(scanline[x], factor);
+        }
+    }
+}
+
+void tint(QImage &image, const QColor &color)
+{
+    ensureArgb32Premultiplied(image);
+    const QRgb premultipliedColor = qPremultiply(color.rgba());
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *scanline = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = tintSimd(scanline, image.width(), premultipliedColor); x < image.width(); ++x) {
+            scanline[x] = tintPixel(scanline[x], premultipliedColor);
+        }
+    }
+}
+
+} // namespace ImageKernels
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+
+// In-place pixel kernels for the generated pixmap variants (grayed flags, etc.)
+// Vectorized with SSE2 on x86 and NEON on ARM64, with a scalar fallback; all the variants produce identical results.
+// The images are converted to QImage::Format_ARGB32_Premultiplied if they are in another format.
+namespace ImageKernels
+{
+    // the same as QColor(qGray(p), qGray(p), qGray(p), qAlpha(p)).lighter(200) for every pixel p
+    void grayscaleLighten(QImage &image);
+
+    // multiplies all the channels by opacity (0.0 - 1.0)
+    void opacity(QImage &image, qreal opacity);
+
+    // the same as filling the image with color in QPainter::CompositionMode_SourceIn
+    void tint(QImage &image, const QColor &color);
+}
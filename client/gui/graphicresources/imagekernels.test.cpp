@@ -0,0 +1,102 @@
+#include <QtTest>
+#include <QPainter>
+#include <QRandomGenerator>
+#include "imagekernels.test.h"
+#include "imagekernels.h"
+
+void TestImageKernels::testGrayscaleLighten()
+{
+    QImage image = testImage();
+
+    // the loop ImageKernels::grayscaleLighten replaced
+    QImage reference = image;
+    for (int i = 0; i < reference.height(); ++i) {
+        auto *scanline = reinterpret_cast<QRgb*>(reference.scanLine(i));
+        for (int j = 0; j < reference.width(); ++j) {
+            const auto gray = qGray(scanline[j]);
+            const auto alpha = qAlpha(scanline[j]);
+            scanline[j] = QColor(gray, gray, gray, alpha).lighter(200).rgba();
+        }
+    }
+
+    ImageKernels::grayscaleLighten(image);
+    QVERIFY(isEqual(image, reference, 0));
+}
+
+void TestImageKernels::testOpacity()
+{
+    const QList<qreal> opacities = { 0.0, 0.3, 0.5, 1.0 };
+    for (qreal opacity : opacities) {
+        QImage image = testImage();
+
+        QImage reference(image.size(), QImage::Format_ARGB32_Premultiplied);
+        reference.fill(Qt::transparent);
+        {
+            QPainter painter(&reference);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.setOpacity(opacity);
+            painter.drawImage(0, 0, image);
+        }
+
+        ImageKernels::opacity(image, opacity);
+        QVERIFY(isEqual(image, reference, 2));
+    }
+}
+
+void TestImageKernels::testTint()
+{
+    const QList<QColor> colors = { QColor(Qt::white), QColor(255, 128, 0), QColor(0, 100, 200, 128) };
+    for (const QColor &color : colors) {
+        QImage image = testImage();
+
+        QImage reference = image;
+        {
+            QPainter painter(&reference);
+            painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+            painter.fillRect(reference.rect(), color);
+        }
+
+        ImageKernels::tint(image, color);
+        QVERIFY(isEqual(image, reference, 2));
+    }
+}
+
+QImage TestImageKernels::testImage() const
+{
+    QRandomGenerator generator(12345);
+    QImage image(37, 23, QImage::Format_ARGB32_Premultiplied);
+    for (int i = 0; i < image.height(); ++i) {
+        auto *scanline = reinterpret_cast<QRgb*>(image.scanLine(i));
+        for (int j = 0; j < image.width(); ++j) {
+            scanline[j] = qPremultiply(generator.generate());
+        }
+    }
+    // the edge values
+    image.setPixel(0, 0, qRgba(0, 0, 0, 0));
+    image.setPixel(1, 0, qRgba(255, 255, 255, 255));
+    image.setPixel(2, 0, qRgba(127, 128, 129, 255));
+    return image;
+}
+
+bool TestImageKernels::isEqual(const QImage &image, const QImage &reference, int tolerance) const
+{
+    if (image.size() != reference.size() || image.format() != reference.format()) {
+        return false;
+    }
+    for (int i = 0; i < image.height(); ++i) {
+        const auto *line = reinterpret_cast<const QRgb*>(image.constScanLine(i));
+        const auto *referenceLine = reinterpret_cast<const QRgb*>(reference.constScanLine(i));
+        for (int j = 0; j < image.width(); ++j) {
+            if (qAbs(qRed(line[j]) - qRed(referenceLine[j])) > tolerance ||
+                qAbs(qGreen(line[j]) - qGreen(referenceLine[j])) > tolerance ||
+                qAbs(qBlue(line[j]) - qBlue(referenceLine[j])) > tolerance ||
+                qAbs(qAlpha(line[j]) - qAlpha(referenceLine[j])) > tolerance) {
+                qDebug() << "Mismatch at" << j << i << Qt::hex << line[j] << referenceLine[j];
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QTEST_MAIN(TestImageKernels)
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QImage>
+#include <QObject>
+#include <QTest>
+
+// tests for ImageKernels, the results are compared with the output of QColor (exactly) and QPainter (within the rounding)
+class TestImageKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testGrayscaleLighten();
+    void testOpacity();
+    void testTint();
+
+private:
+    // random premultiplied pixels, the width is not a multiple of the vector size so the scalar tail is covered too
+    QImage testImage() const;
+    bool isEqual(const QImage &image, const QImage &reference, int tolerance) const;
+};
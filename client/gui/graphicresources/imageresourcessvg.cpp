@@ -1,16 +1,32 @@
 #include "imageresourcessvg.h"
 
+#include <memory>
+#include <QDir>
 #include <QDirIterator>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QSvgRenderer>
 #include <QPainter>
 #include <QApplication>
 #include <QScreen>
+#include <QThreadPool>
 #include "utils/ws_assert.h"
 #include "utils/crashhandler.h"
 #include "utils/logger.h"
 #include "dpiscalemanager.h"
+#include "imagekernels.h"
+#include "version/appversion.h"
 #include "widgetutils/widgetutils.h"
 
+namespace {
+
+int alignedSize(int size)
+{
+    return (size + 3) & ~3;
+}
+
+} // namespace
+
 ImageResourcesSvg::ImageResourcesSvg() : QThread(nullptr), bNeedFinish_(false), bFininishedGracefully_(false)
 {
 }
@@ -24,6 +40,8 @@ void ImageResourcesSvg::clearHash()
 {
     hashIndependent_.clear();
     iconHashes_.clear();
+    // the preloading thread is stopped and the lookups come from the GUI thread, so nobody else reads the atlas now
+    delete atlas_.fetchAndStoreOrdered(nullptr);
 }
 
 
@@ -47,6 +65,16 @@ void ImageResourcesSvg::finishGracefully()
 // get pixmap with original size
 QSharedPointer<IndependentPixmap> ImageResourcesSvg::getIndependentPixmap(const QString &name)
 {
+    const auto *atlas = atlas_.loadAcquire();
+    if (atlas)
+    {
+        auto it = atlas->constFind(name);
+        if (it != atlas->constEnd())
+        {
+            return it.value();
+        }
+    }
+
     QMutexLocker locker(&mutex_);
     auto it = hashIndependent_.find(name);
     if (it != hashIndependent_.end())
@@ -92,7 +120,6 @@ QSharedPointer<IndependentPixmap> ImageResourcesSvg::getIconIndependentPixmap(co
 
 QSharedPointer<IndependentPixmap> ImageResourcesSvg::getFlag(const QString &flagName)
 {
-    QMutexLocker locker(&mutex_);
     QSharedPointer<IndependentPixmap> ret = getIndependentPixmap("flags/" + flagName);
     if (ret)
     {
@@ -122,18 +149,198 @@ QSharedPointer<IndependentPixmap> ImageResourcesSvg::getScaledFlag(const QString
 void ImageResourcesSvg::run()
 {
     BIND_CRASH_HANDLER_FOR_THREAD();
+    const int pixelRatio = DpiScaleManager::instance().curDevicePixelRatio();
+    const qreal scale = G_SCALE;
+    const QString path = atlasFilePath(scale, pixelRatio);
+
+    QHash<QString, QImage> images;
+    loadAtlas(path, scale, pixelRatio, images);
+    const int cachedCount = images.size();
+
+    QStringList misses;
     QDirIterator it(":/svg", QDirIterator::Subdirectories);
-    while (!bNeedFinish_ && it.hasNext())
+    while (it.hasNext())
     {
         it.next();
         if (it.fileInfo().isFile())
         {
-            QMutexLocker locker(&mutex_);
             QString name = it.fileInfo().filePath().mid(6, it.fileInfo().filePath().length() - 10);
-            loadFromResource(name);
+            if (!images.contains(name))
+            {
+                misses << name;
+            }
+        }
+    }
+
+    // only the cache misses are rasterized, in parallel; the mutex_ is not taken, so the GUI lookups do not wait for this
+    QMutex imagesMutex;
+    QThreadPool pool;
+    for (const QString &name : qAsConst(misses))
+    {
+        pool.start([this, name, scale, pixelRatio, &images, &imagesMutex]() {
+            if (bNeedFinish_)
+            {
+                return;
+            }
+            QImage image = renderSvg(name, scale * pixelRatio);
+            if (!image.isNull())
+            {
+                QMutexLocker locker(&imagesMutex);
+                images[name] = image;
+            }
+        });
+    }
+    pool.waitForDone();
+    if (bNeedFinish_)
+    {
+        return;
+    }
+
+    if (images.size() != cachedCount)
+    {
+        saveAtlas(path, scale, pixelRatio, images);
+    }
+
+    auto *atlas = new QHash<QString, QSharedPointer<IndependentPixmap> >();
+    atlas->reserve(images.size());
+    for (auto i = images.cbegin(); i != images.cend(); ++i)
+    {
+        QPixmap pixmap = QPixmap::fromImage(i.value());
+        pixmap.setDevicePixelRatio(pixelRatio);
+        atlas->insert(i.key(), QSharedPointer<IndependentPixmap>(new IndependentPixmap(pixmap)));
+    }
+    delete atlas_.fetchAndStoreOrdered(atlas);
+
+    qCDebug(LOG_BASIC) << "ImageResourcesSvg::run() - all SVGs loaded," << cachedCount << "from the cache," << images.size() - cachedCount << "rendered";
+}
+
+QImage ImageResourcesSvg::renderSvg(const QString &name, qreal scale)
+{
+    QSvgRenderer render(":/svg/" + name + ".svg");
+    if (!render.isValid())
+    {
+        return QImage();
+    }
+    QImage image(render.defaultSize() * scale, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        render.render(&painter);
+    }
+    return image;
+}
+
+QString ImageResourcesSvg::atlasFilePath(qreal scale, int pixelRatio)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+           QString("/svgcache_%1_%2.bin").arg(qRound(scale * 100)).arg(pixelRatio);
+}
+
+void ImageResourcesSvg::loadAtlas(const QString &path, qreal scale, int pixelRatio, QHash<QString, QImage> &outImages)
+{
+    // The images are built over the mapping of the file without copying, each of them keeps a reference to the file
+    // and the last one unmaps it. saveAtlas() replaces the file with a rename, which leaves the mapping intact.
+    std::shared_ptr<QFile> file = std::make_shared<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    const qint64 size = file->size();
+    if (size < (qint64)sizeof(AtlasHeader))
+    {
+        return;
+    }
+    const uchar *data = file->map(0, size);
+    if (!data)
+    {
+        return;
+    }
+    AtlasHeader header;
+    memcpy(&header, data, sizeof(header));
+    const QByteArray appVersion = AppVersion::instance().semanticVersionString().toUtf8();
+    if (header.magic != kAtlasMagic || header.formatVersion != kAtlasFormatVersion || header.pixelRatio != pixelRatio ||
+        header.scale != scale || header.appVersionSize != (quint32)appVersion.size() ||
+        size < (qint64)sizeof(AtlasHeader) + alignedSize(appVersion.size()) ||
+        memcmp(data + sizeof(AtlasHeader), appVersion.constData(), appVersion.size()) != 0)
+    {
+        return;
+    }
+
+    qint64 offset = sizeof(AtlasHeader) + alignedSize(appVersion.size());
+    if ((qint64)header.count > (size - offset) / (qint64)sizeof(AtlasEntryHeader))
+    {
+        return;
+    }
+    QHash<QString, QImage> images;
+    images.reserve(header.count);
+    for (quint32 i = 0; i < header.count; ++i)
+    {
+        if (offset + (qint64)sizeof(AtlasEntryHeader) > size)
+        {
+            return;
         }
+        AtlasEntryHeader entry;
+        memcpy(&entry, data + offset, sizeof(entry));
+        offset += sizeof(entry);
+
+        const qint64 pixelsSize = (qint64)entry.width * entry.height * 4;
+        if (entry.nameSize > 1024 || offset + alignedSize(entry.nameSize) + pixelsSize > size)
+        {
+            return;
+        }
+        const QString name = QString::fromUtf8((const char *)data + offset, entry.nameSize);
+        offset += alignedSize(entry.nameSize);
+
+        images[name] = QImage(data + offset, entry.width, entry.height, entry.width * 4, QImage::Format_ARGB32_Premultiplied,
+                              [](void *info) { delete static_cast<std::shared_ptr<QFile> *>(info); }, new std::shared_ptr<QFile>(file));
+        offset += pixelsSize;
+    }
+    outImages = images;
+}
+
+void ImageResourcesSvg::saveAtlas(const QString &path, qreal scale, int pixelRatio, const QHash<QString, QImage> &images)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCDebug(LOG_BASIC) << "ImageResourcesSvg::saveAtlas() - can't write the cache:" << file.errorString();
+        return;
+    }
+
+    const QByteArray appVersion = AppVersion::instance().semanticVersionString().toUtf8();
+    AtlasHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kAtlasMagic;
+    header.formatVersion = kAtlasFormatVersion;
+    header.pixelRatio = pixelRatio;
+    header.count = images.size();
+    header.appVersionSize = appVersion.size();
+    header.scale = scale;
+    file.write((const char *)&header, sizeof(header));
+    file.write(appVersion.leftJustified(alignedSize(appVersion.size()), '\0'));
+
+    for (auto i = images.cbegin(); i != images.cend(); ++i)
+    {
+        const QImage image = i.value().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const QByteArray name = i.key().toUtf8();
+        AtlasEntryHeader entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.nameSize = name.size();
+        entry.width = image.width();
+        entry.height = image.height();
+        file.write((const char *)&entry, sizeof(entry));
+        file.write(name.leftJustified(alignedSize(name.size()), '\0'));
+        for (int y = 0; y < image.height(); ++y)
+        {
+            file.write((const char *)image.constScanLine(y), image.width() * 4);
+        }
+    }
+
+    if (!file.commit())
+    {
+        qCDebug(LOG_BASIC) << "ImageResourcesSvg::saveAtlas() - can't write the cache:" << file.errorString();
     }
-    qCDebug(LOG_BASIC) << "ImageResourcesSvg::run() - all SVGs loaded";
 }
 
 bool ImageResourcesSvg::loadIconFromResource(const QString &name)
@@ -153,16 +360,12 @@ bool ImageResourcesSvg::loadIconFromResource(const QString &name)
 
 bool ImageResourcesSvg::loadFromResource(const QString &name)
 {
-    QSvgRenderer render(":/svg/" + name + ".svg");
-    if (!render.isValid())
+    const QImage image = renderSvg(name, G_SCALE * DpiScaleManager::instance().curDevicePixelRatio());
+    if (image.isNull())
     {
         return false;
     }
-    QPixmap pixmap(render.defaultSize() * G_SCALE * DpiScaleManager::instance().curDevicePixelRatio());
-    pixmap.fill(Qt::transparent);
-    QPainter painter(&pixmap);
-    render.render(&painter);
-
+    QPixmap pixmap = QPixmap::fromImage(image);
     pixmap.setDevicePixelRatio(DpiScaleManager::instance().curDevicePixelRatio());
     hashIndependent_[name] = QSharedPointer<IndependentPixmap>(new IndependentPixmap(pixmap));
     return true;
@@ -194,14 +397,7 @@ bool ImageResourcesSvg::loadFromResourceWithCustomSize(const QString &name, int
     }
     if (flags & IMAGE_FLAG_GRAYED) {
         auto image = pixmap.toImage();
-        for (int i = 0; i < image.height(); ++i) {
-            auto *scanline = reinterpret_cast<QRgb*>(image.scanLine(i));
-            for (int j = 0; j < image.width(); ++j) {
-                const auto gray = qGray(scanline[j]);
-                const auto alpha = qAlpha(scanline[j]);
-                scanline[j] = QColor(gray, gray, gray, alpha).lighter(200).rgba();
-            }
-        }
+        ImageKernels::grayscaleLighten(image);
         pixmap = QPixmap::fromImage(image);
     }
 
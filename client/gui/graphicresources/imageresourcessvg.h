@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QAtomicPointer>
 #include <QThread>
 #include <QPixmap>
 #include <QRecursiveMutex>
@@ -41,10 +42,38 @@ private:
 
     QHash<QString, QSharedPointer<IndependentPixmap> > iconHashes_;
     QHash<QString, QSharedPointer<IndependentPixmap> > hashIndependent_;
+    // all the SVGs at the current scale, published once by run() and read without the mutex until clearHash()
+    QAtomicPointer<const QHash<QString, QSharedPointer<IndependentPixmap> > > atlas_;
     std::atomic<bool> bNeedFinish_;
     bool bFininishedGracefully_;
     QRecursiveMutex mutex_;
 
+    // the pre-rasterized SVGs are cached on disk per app version, G_SCALE and device pixel ratio
+    static constexpr quint32 kAtlasMagic = 0x53564741;  // "SVGA"
+    static constexpr quint32 kAtlasFormatVersion = 1;
+
+    struct AtlasHeader
+    {
+        quint32 magic;
+        quint32 formatVersion;
+        qint32 pixelRatio;
+        quint32 count;
+        quint32 appVersionSize;
+        quint32 reserved;
+        double scale;
+    };
+    struct AtlasEntryHeader
+    {
+        quint32 nameSize;
+        quint32 width;
+        quint32 height;
+        quint32 reserved;
+    };
+
+    static QImage renderSvg(const QString &name, qreal scale);
+    static QString atlasFilePath(qreal scale, int pixelRatio);
+    static void loadAtlas(const QString &path, qreal scale, int pixelRatio, QHash<QString, QImage> &outImages);
+    static void saveAtlas(const QString &path, qreal scale, int pixelRatio, const QHash<QString, QImage> &images);
 
     bool loadIconFromResource(const QString &name);
     bool loadFromResource(const QString &name);
@@ -64,11 +64,11 @@ void LocalIPCServer::onServerCallbackAcceptFunction(IPC::Connection *connection)
 
 void LocalIPCServer::onConnectionCommandCallback(IPC::Command *command, IPC::Connection * /*connection*/)
 {
-    if (command->getStringId() ==IPC::CliCommands::ShowLocations::getCommandStringId())
+    if (command->getId() == IPC::CliCommands::ShowLocations::kCommandId)
     {
         emit showLocations();
     }
-    else if (command->getStringId() == IPC::CliCommands::Connect::getCommandStringId())
+    else if (command->getId() == IPC::CliCommands::Connect::kCommandId)
     {
         IPC::CliCommands::Connect *cmd = static_cast<IPC::CliCommands::Connect *>(command);
         QString locationStr = cmd->location_;
@@ -103,7 +103,7 @@ void LocalIPCServer::onConnectionCommandCallback(IPC::Command *command, IPC::Con
             emit connectToLocation(lid);
         }
     }
-    else if (command->getStringId() == IPC::CliCommands::Disconnect::getCommandStringId())
+    else if (command->getId() == IPC::CliCommands::Disconnect::kCommandId)
     {
         if (backend_->isDisconnected())
         {
@@ -115,7 +115,7 @@ void LocalIPCServer::onConnectionCommandCallback(IPC::Command *command, IPC::Con
             backend_->sendDisconnect();
         }
     }
-    else if (command->getStringId() == IPC::CliCommands::GetState::getCommandStringId())
+    else if (command->getId() == IPC::CliCommands::GetState::kCommandId)
     {
         IPC::CliCommands::State cmd;
         cmd.isLoggedIn_ = isLoggedIn_;
@@ -124,7 +124,7 @@ void LocalIPCServer::onConnectionCommandCallback(IPC::Command *command, IPC::Con
         cmd.location_ = backend_->currentLocation();
         sendCommand(cmd);
     }
-    else if (command->getStringId() == IPC::CliCommands::Firewall::getCommandStringId())
+    else if (command->getId() == IPC::CliCommands::Firewall::kCommandId)
     {
         IPC::CliCommands::Firewall *cmd = static_cast<IPC::CliCommands::Firewall *>(command);
         if (cmd->isEnable_)
@@ -163,7 +163,7 @@ void LocalIPCServer::onConnectionCommandCallback(IPC::Command *command, IPC::Con
             }
         }
     }
-    else if (command->getStringId() == IPC::CliCommands::Login::getCommandStringId())
+    else if (command->getId() == IPC::CliCommands::Login::kCommandId)
     {
         if (isLoggedIn_) {
             notifyCliLoginFinished();
@@ -176,7 +176,7 @@ void LocalIPCServer::onConnectionCommandCallback(IPC::Command *command, IPC::Con
             emit attemptLogin(cmd->username_, cmd->password_, cmd->code2fa_);
         }
     }
-    else if (command->getStringId() == IPC::CliCommands::SignOut::getCommandStringId())
+    else if (command->getId() == IPC::CliCommands::SignOut::kCommandId)
     {
         if (isLoggedIn_)
         {
@@ -475,6 +475,9 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
         mouseMoveEvent((QMouseEvent *)event);
     } else if (watched == mainWindowController_->getViewport() && event->type() == QEvent::MouseButtonRelease) {
         mouseReleaseEvent((QMouseEvent *)event);
+    } else if (watched == windowHandle() && event->type() == QEvent::Expose) {
+        // the exposed state is already updated when the event is delivered
+        MainWindowState::instance().setExposed(windowHandle()->isExposed());
     }
     return QWidget::eventFilter(watched, event);
 }
@@ -644,6 +647,11 @@ bool MainWindow::event(QEvent *event)
     }
 #endif
 
+    if (event->type() == QEvent::Show && windowHandle()) {
+        // the native window exists from now on; installing the filter again does not duplicate it
+        windowHandle()->installEventFilter(this);
+    }
+
     if (event->type() == QEvent::WindowActivate) {
         MainWindowState::instance().setActive(true);
         // qDebug() << "WindowActivate";
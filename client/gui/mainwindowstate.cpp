@@ -16,7 +16,21 @@ void MainWindowState::setActive(bool isActive)
     }
 }
 
-MainWindowState::MainWindowState() : isActive_(true)
+bool MainWindowState::isExposed() const
+{
+    return isExposed_;
+}
+
+void MainWindowState::setExposed(bool isExposed)
+{
+    if (isExposed_ != isExposed)
+    {
+        isExposed_ = isExposed;
+        emit isExposedChanged(isExposed_);
+    }
+}
+
+MainWindowState::MainWindowState() : isActive_(true), isExposed_(true)
 {
 
 }
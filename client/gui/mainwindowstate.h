@@ -2,7 +2,7 @@
 
 #include <QObject>
 
-// singleton, global main window state(minimized/active)
+// singleton, global main window state(minimized/active/exposed)
 class MainWindowState : public QObject
 {
     Q_OBJECT
@@ -17,12 +17,18 @@ public:
     bool isActive() const;
     void setActive(bool isActive);
 
+    // false when the window is not visible on the screen at all (minimized, hidden or occluded on the platforms reporting it)
+    bool isExposed() const;
+    void setExposed(bool isExposed);
+
 signals:
     bool isActiveChanged(bool isActive);
+    void isExposedChanged(bool isExposed);
 
 private:
     MainWindowState();
 
 private:
     bool isActive_;
+    bool isExposed_;
 };
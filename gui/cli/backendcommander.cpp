@@ -36,10 +36,10 @@ void BackendCommander::initAndSend(bool isGuiAlreadyRunning)
 
 void BackendCommander::onConnectionNewCommand(IPC::Command *command, IPC::Connection * /*connection*/)
 {
-    if (bCommandSent_ && command->getStringId() == IPC::CliCommands::LocationsShown::getCommandStringId()) {
+    if (bCommandSent_ && command->getId() == IPC::CliCommands::LocationsShown::kCommandId) {
         emit finished(0, tr("Viewing Locations..."));
     }
-    else if (bCommandSent_ && command->getStringId() == IPC::CliCommands::ConnectToLocationAnswer::getCommandStringId()) {
+    else if (bCommandSent_ && command->getId() == IPC::CliCommands::ConnectToLocationAnswer::kCommandId) {
         IPC::CliCommands::ConnectToLocationAnswer *cmd = static_cast<IPC::CliCommands::ConnectToLocationAnswer *>(command);
 
         if (cmd->isSuccess_) {
@@ -50,7 +50,7 @@ void BackendCommander::onConnectionNewCommand(IPC::Command *command, IPC::Connec
             emit finished(1, tr("Error: Could not find server matching: \"") + cliArgs_.location() + "\" or the location is disabled");
         }
     }
-    else if (bCommandSent_ && command->getStringId() == IPC::CliCommands::ConnectStateChanged::getCommandStringId()) {
+    else if (bCommandSent_ && command->getId() == IPC::CliCommands::ConnectStateChanged::kCommandId) {
         IPC::CliCommands::ConnectStateChanged *cmd = static_cast<IPC::CliCommands::ConnectStateChanged *>(command);
 
         if (cliArgs_.cliCommand() >= CLI_COMMAND_CONNECT && cliArgs_.cliCommand() <= CLI_COMMAND_DISCONNECT) {
@@ -73,10 +73,10 @@ void BackendCommander::onConnectionNewCommand(IPC::Command *command, IPC::Connec
             }
         }
     }
-    else if (bCommandSent_ && command->getStringId() == IPC::CliCommands::AlreadyDisconnected::getCommandStringId()) {
+    else if (bCommandSent_ && command->getId() == IPC::CliCommands::AlreadyDisconnected::kCommandId) {
         emit finished(0, tr("Already Disconnected"));
     }
-    else if (command->getStringId() == IPC::CliCommands::State::getCommandStringId()) {
+    else if (command->getId() == IPC::CliCommands::State::kCommandId) {
         if (cliArgs_.cliCommand() == CLI_COMMAND_STATUS) {
             onStatusResponse(command);
         }
@@ -84,7 +84,7 @@ void BackendCommander::onConnectionNewCommand(IPC::Command *command, IPC::Connec
             onLoginStateResponse(command);
         }
     }
-    else if (command->getStringId() == IPC::CliCommands::FirewallStateChanged::getCommandStringId()) {
+    else if (command->getId() == IPC::CliCommands::FirewallStateChanged::kCommandId) {
         IPC::CliCommands::FirewallStateChanged *cmd = static_cast<IPC::CliCommands::FirewallStateChanged *>(command);
         if (cmd->isFirewallEnabled_) {
             if (cmd->isFirewallAlwaysOn_) {
@@ -98,10 +98,10 @@ void BackendCommander::onConnectionNewCommand(IPC::Command *command, IPC::Connec
             emit finished(0, tr("Firewall is OFF"));
         }
     }
-    else if (bCommandSent_ && command->getStringId() == IPC::CliCommands::SignedOut::getCommandStringId()) {
+    else if (bCommandSent_ && command->getId() == IPC::CliCommands::SignedOut::kCommandId) {
         emit finished(0, tr("Signed out"));
     }
-    else if (bCommandSent_ && command->getStringId() == IPC::CliCommands::LoginResult::getCommandStringId()) {
+    else if (bCommandSent_ && command->getId() == IPC::CliCommands::LoginResult::kCommandId) {
         IPC::CliCommands::LoginResult *cmd = static_cast<IPC::CliCommands::LoginResult *>(command);
         if (cmd->isLoggedIn_) {
             emit finished(0, tr("login successful"));
@@ -19,6 +19,7 @@ Source0:	windscribe.tar
 
 Requires:	bash
 Requires:	iptables
+Requires:	ipset
 Requires:	glibc >= 2.28
 Requires:	libstdc++
 Requires:	glib2
@@ -3,8 +3,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../../../../backend/posix_common/helper_commands_serialize.h"
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 #include <sstream>
 #import "../Logger.h"
 
@@ -80,7 +80,7 @@ bool Helper_mac::setPaths(const std::wstring &archivePath, const std::wstring &i
     cmd.installPath = installPath;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
     CMD_ANSWER answerCmd = sendCmdToHelper(HELPER_CMD_INSTALLER_SET_PATH, stream.str());
     return answerCmd.executed == 1;
@@ -106,7 +106,7 @@ bool Helper_mac::removeOldInstall(const std::string &path)
     cmd.path = path;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_INSTALLER_REMOVE_OLD_INSTALL, stream.str());
@@ -119,7 +119,7 @@ bool Helper_mac::killWindscribeProcess()
     cmd.target = kTargetWindscribe;
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_TASK_KILL, stream.str());
@@ -132,7 +132,7 @@ bool Helper_mac::createCliSymlinkDir()
     cmd.uid = getuid();
 
     std::stringstream stream;
-    boost::archive::text_oarchive oa(stream, boost::archive::no_header);
+    boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
     oa << cmd;
 
     return runCommand(HELPER_CMD_INSTALLER_CREATE_CLI_SYMLINK_DIR, stream.str());
@@ -141,6 +141,7 @@ bool Helper_mac::createCliSymlinkDir()
 CMD_ANSWER Helper_mac::sendCmdToHelper(int cmdId, const std::string &data)
 {
     xpc_object_t message = xpc_dictionary_create(NULL, NULL, 0);
+    xpc_dictionary_set_int64(message, "version", HELPER_PROTOCOL_VERSION);
     xpc_dictionary_set_int64(message, "cmdId", cmdId);
     xpc_dictionary_set_data(message, "data", data.c_str(), data.size());
     xpc_object_t answer = xpc_connection_send_message_with_reply_sync(connection_, message);
@@ -154,10 +155,14 @@ CMD_ANSWER Helper_mac::sendCmdToHelper(int cmdId, const std::string &data)
         const void *buf = xpc_dictionary_get_data(answer, "data", &length);
         if (buf && length > 0) {
             CMD_ANSWER cmdAnswer;
-            std::string str((char *)buf, length);
-            std::istringstream stream(str);
-            boost::archive::text_iarchive ia(stream, boost::archive::no_header);
-            ia >> cmdAnswer;
+            HelperMemoryStreamBuf stream((const char *)buf, length);
+            try {
+                boost::archive::binary_iarchive ia(stream, boost::archive::no_header);
+                ia >> cmdAnswer;
+            } catch (const std::exception &e) {
+                [[Logger sharedLogger] logAndStdOut:[NSString stringWithFormat:@"Malformed answer from helper: %s", e.what()]];
+                return CMD_ANSWER();
+            }
             return cmdAnswer;
         } else {
             return CMD_ANSWER();
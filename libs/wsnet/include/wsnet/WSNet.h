@@ -30,6 +30,8 @@ public:
 
     virtual void setConnectivityState(bool isOnline) = 0;
     virtual void setIsConnectedToVpnState(bool isConnected) = 0;
+    // networkId identifies the current network (for example, the SSID), the DNS cache is cleared when it changes
+    virtual void setCurrentNetwork(const std::string &networkId) = 0;
 
     virtual std::shared_ptr<WSNetDnsResolver> dnsResolver() = 0;
     virtual std::shared_ptr<WSNetHttpNetworkManager> httpNetworkManager() = 0;
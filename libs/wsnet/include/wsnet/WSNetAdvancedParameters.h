@@ -23,6 +23,14 @@ public:
 
     virtual void setLogApiResponce(bool isEnabled) = 0;
     virtual bool isLogApiResponce() const = 0;
+
+    // return expired DNS cache entries immediately and refresh them in the background
+    virtual void setDnsStaleWhileRevalidate(bool isEnabled) = 0;
+    virtual bool isDnsStaleWhileRevalidate() const = 0;
+
+    // race several failovers with staggered starts instead of trying them one by one
+    virtual void setAPIFailoverRacing(bool isEnabled) = 0;
+    virtual bool isAPIFailoverRacing() const = 0;
 };
 
 } // namespace wsnet
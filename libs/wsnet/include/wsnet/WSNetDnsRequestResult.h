@@ -15,6 +15,8 @@ public:
     virtual std::uint32_t elapsedMs() = 0;
     virtual bool isError() = 0;
     virtual std::string errorString() = 0;
+    // the minimum TTL of the returned records in seconds, 0 if unknown (for example, resolved from the hosts file)
+    virtual std::uint32_t ttl() { return 0; }
 };
 
 } // namespace wsnet
@@ -62,6 +62,11 @@ public:
     // true by default
     virtual void setIsWhiteListIps(bool isWhiteListIps) = 0;
     virtual bool isWhiteListIps() const = 0;
+
+    // Allows reusing connections and TLS sessions of previous requests to the same hostname, SNI domain, ECH config and IPs
+    // false by default
+    virtual void setUseConnectionPool(bool isUseConnectionPool) = 0;
+    virtual bool isUseConnectionPool() const = 0;
 };
 
 } // namespace wsnet
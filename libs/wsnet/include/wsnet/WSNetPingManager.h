@@ -12,6 +12,9 @@ namespace wsnet {
 enum class PingType { kHttp = 0, kIcmp };
 
 typedef std::function<void(const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState)> WSNetPingCallback;
+// the results of pingBatch(), all vectors have the same size, an element per finished ping
+typedef std::function<void(const std::vector<std::string> &ips, const std::vector<bool> &isSuccess,
+                           const std::vector<std::int32_t> &timesMs, const std::vector<bool> &isFromDisconnectedVpnState)> WSNetPingBatchCallback;
 
 // Useful for testing and debugging purposes
 class WSNetPingManager : public scapix_object<WSNetPingManager>
@@ -24,6 +27,14 @@ public:
     // pingType: 0 - HTTP, 1 - ICMP
     virtual std::shared_ptr<WSNetCancelableCallback> ping(const std::string &ip, const std::string &hostname,
                                                           PingType pingType, WSNetPingCallback callback) = 0;
+
+    // Pings all the ips (hostnames - optional, empty or the same size as ips) with the same scheduling as ping().
+    // The results are coalesced and delivered every 50 ms or every 64 results, whichever comes first.
+    virtual std::shared_ptr<WSNetCancelableCallback> pingBatch(const std::vector<std::string> &ips, const std::vector<std::string> &hostnames,
+                                                               PingType pingType, WSNetPingBatchCallback callback) = 0;
+
+    // pings to these IPs are started before the others queued (for example, the selected or favourite locations)
+    virtual void setPriorityIps(const std::vector<std::string> &ips) = 0;
 };
 
 } // namespace wsnet
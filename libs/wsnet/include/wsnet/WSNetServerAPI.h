@@ -6,6 +6,7 @@
 #include <memory>
 #include "scapix_object.h"
 #include "WSNetCancelableCallback.h"
+#include "WSNetServerLocations.h"
 
 namespace wsnet {
 
@@ -15,6 +16,7 @@ enum class UpdateChannel { kRelease = 0, kBeta, kGuineaPig, kInternal };
 
 typedef std::function<void(std::uint32_t num, std::uint32_t count)> WSNetTryingBackupEndpointCallback;
 typedef std::function<void(ServerApiRetCode serverApiRetCode, const std::string &jsonData)> WSNetRequestFinishedCallback;
+typedef std::function<void(ServerApiRetCode serverApiRetCode, std::shared_ptr<WSNetServerLocations> serverLocations)> WSNetServerLocationsCallback;
 
 class WSNetServerAPI : public scapix_object<WSNetServerAPI>
 {
@@ -37,6 +39,12 @@ public:
     virtual std::shared_ptr<WSNetCancelableCallback> serverLocations(const std::string &language, const std::string &revision,
                                                                      bool isPro, const std::vector<std::string> &alcList,
                                                                      WSNetRequestFinishedCallback callback) = 0;
+    // Same request as serverLocations, but the serverlist is parsed into typed records while streaming, without building a JSON DOM.
+    // If the payload hash matches knownPayloadHash, the records are left empty and WSNetServerLocations::isUnchanged() returns true.
+    virtual std::shared_ptr<WSNetCancelableCallback> serverLocationsRecords(const std::string &language, const std::string &revision,
+                                                                            bool isPro, const std::vector<std::string> &alcList,
+                                                                            const std::string &knownPayloadHash,
+                                                                            WSNetServerLocationsCallback callback) = 0;
     virtual std::shared_ptr<WSNetCancelableCallback> serverCredentials(const std::string &authHash, bool isOpenVpnProtocol, WSNetRequestFinishedCallback callback) = 0;
     virtual std::shared_ptr<WSNetCancelableCallback> serverConfigs(const std::string &authHash, const std::string &ovpnVersion, WSNetRequestFinishedCallback callback) = 0;
     virtual std::shared_ptr<WSNetCancelableCallback> portMap(const std::string &authHash, std::uint32_t version, const std::vector<std::string> &forceProtocols, WSNetRequestFinishedCallback callback) = 0;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "scapix_object.h"
+
+namespace wsnet {
+
+class WSNetServerNode : public scapix_object<WSNetServerNode>
+{
+public:
+    virtual ~WSNetServerNode() {}
+
+    virtual std::string ip() const = 0;
+    virtual std::string ip2() const = 0;
+    virtual std::string ip3() const = 0;
+    virtual std::string hostname() const = 0;
+    virtual std::int32_t weight() const = 0;
+};
+
+class WSNetServerGroup : public scapix_object<WSNetServerGroup>
+{
+public:
+    virtual ~WSNetServerGroup() {}
+
+    virtual std::int32_t id() const = 0;
+    virtual std::string city() const = 0;
+    virtual std::string nick() const = 0;
+    virtual std::int32_t pro() const = 0;             // 0 - for free account, 1 - for pro account
+    virtual std::string pingIp() const = 0;
+    virtual std::string pingHost() const = 0;
+    virtual std::string wgPubKey() const = 0;
+    virtual std::string ovpnX509() const = 0;
+    virtual std::int32_t linkSpeed() const = 0;       // 100 if missing or invalid
+    virtual std::int32_t health() const = 0;          // 0-100, or -1 if missing or invalid
+    // the nodes with the force_disconnect flag are not included, see WSNetServerLocations::forceDisconnectNodes()
+    virtual std::vector<std::shared_ptr<WSNetServerNode>> nodes() const = 0;
+};
+
+class WSNetServerLocation : public scapix_object<WSNetServerLocation>
+{
+public:
+    virtual ~WSNetServerLocation() {}
+
+    virtual std::int32_t id() const = 0;
+    virtual std::string name() const = 0;
+    virtual std::string countryCode() const = 0;
+    virtual std::int32_t premiumOnly() const = 0;
+    virtual std::int32_t p2p() const = 0;
+    virtual std::string dnsHostName() const = 0;
+    virtual std::vector<std::shared_ptr<WSNetServerGroup>> groups() const = 0;
+};
+
+// The serverlist parsed into typed records, see WSNetServerAPI::serverLocationsRecords
+class WSNetServerLocations : public scapix_object<WSNetServerLocations>
+{
+public:
+    virtual ~WSNetServerLocations() {}
+
+    // SHA1 of the raw payload
+    virtual std::string payloadHash() const = 0;
+    // true if the payload hash is equal to the one passed to serverLocationsRecords(), the locations are not parsed in this case
+    virtual bool isUnchanged() const = 0;
+
+    virtual std::string countryOverride() const = 0;
+    // the locations with missing required fields are skipped
+    virtual std::vector<std::shared_ptr<WSNetServerLocation>> locations() const = 0;
+    // the hostnames of the nodes with the force_disconnect flag
+    virtual std::vector<std::string> forceDisconnectNodes() const = 0;
+};
+
+} // namespace wsnet
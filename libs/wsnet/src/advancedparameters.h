@@ -54,12 +54,36 @@ public:
         return isLogApiResponce_;
     }
 
+    void setDnsStaleWhileRevalidate(bool isEnabled) override
+    {
+        std::lock_guard locker(mutex_);
+        isDnsStaleWhileRevalidate_ = isEnabled;
+    }
+    bool isDnsStaleWhileRevalidate() const override
+    {
+        std::lock_guard locker(mutex_);
+        return isDnsStaleWhileRevalidate_;
+    }
+
+    void setAPIFailoverRacing(bool isEnabled) override
+    {
+        std::lock_guard locker(mutex_);
+        isAPIFailoverRacing_ = isEnabled;
+    }
+    bool isAPIFailoverRacing() const override
+    {
+        std::lock_guard locker(mutex_);
+        return isAPIFailoverRacing_;
+    }
+
 private:
     mutable std::mutex mutex_;
     bool isAPIExtraTLSPadding_ = false;
     bool isIgnoreCountryOverride_ = false;
     std::string countryOverrideValue_;
     bool isLogApiResponce_ = false;
+    bool isDnsStaleWhileRevalidate_ = false;
+    bool isAPIFailoverRacing_ = false;
 };
 
 } // namespace wsnet
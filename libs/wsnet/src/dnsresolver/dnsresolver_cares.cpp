@@ -174,7 +174,12 @@ void DnsResolver_cares::run()
             arg->this_ = this;
             arg->qi = qi;
             arg->qi.startTime = std::chrono::steady_clock::now();
-            ares_gethostbyname(channel, arg->qi.hostname.c_str(), AF_INET, caresCallback, arg);
+            // unlike ares_gethostbyname, ares_getaddrinfo returns the TTL of the records
+            struct ares_addrinfo_hints hints;
+            memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_INET;
+            hints.ai_flags = ARES_AI_NOSORT;    // keep the order of the DNS answer
+            ares_getaddrinfo(channel, arg->qi.hostname.c_str(), NULL, &hints, caresCallback, arg);
             localQueue.pop();
         }
 
@@ -196,7 +201,7 @@ void DnsResolver_cares::run()
     ares_destroy(channel);
 }
 
-void DnsResolver_cares::caresCallback(void *arg, int status, int timeouts, hostent *host)
+void DnsResolver_cares::caresCallback(void *arg, int status, int timeouts, struct ares_addrinfo *addrinfo)
 {
     ArgToCaresCallback *pars = (ArgToCaresCallback *)arg;
 
@@ -212,12 +217,21 @@ void DnsResolver_cares::caresCallback(void *arg, int status, int timeouts, hoste
 
     std::shared_ptr<DnsRequestResult> result = std::make_shared<DnsRequestResult>();
     if (status == ARES_SUCCESS) {
-        for (char **p = host->h_addr_list; *p; p++) {
+        bool isTtlSet = false;
+        for (struct ares_addrinfo_node *node = addrinfo->nodes; node; node = node->ai_next) {
+            if (node->ai_family != AF_INET)
+                continue;
             char addr_buf[46] = "??";
-            ares_inet_ntop(host->h_addrtype, *p, addr_buf, sizeof(addr_buf));
+            ares_inet_ntop(AF_INET, &((struct sockaddr_in *)node->ai_addr)->sin_addr, addr_buf, sizeof(addr_buf));
             result->ips_.push_back(addr_buf);
+            if (node->ai_ttl > 0 && (!isTtlSet || (std::uint32_t)node->ai_ttl < result->ttl_)) {
+                result->ttl_ = node->ai_ttl;
+                isTtlSet = true;
+            }
         }
-        result->isError_ = false;
+        result->isError_ = result->ips_.empty();
+        if (result->isError_)
+            result->errorString_ = ares_strerror(ARES_ENODATA);
     } else {
         result->errorString_ = ares_strerror(status);
         result->isError_ = true;
@@ -230,6 +244,8 @@ void DnsResolver_cares::caresCallback(void *arg, int status, int timeouts, hoste
         // do callback
         pars->qi.callback->call(pars->qi.userDataId, pars->qi.hostname, result);
     }
+    if (addrinfo)
+        ares_freeaddrinfo(addrinfo);
     delete pars;
 }
 
@@ -31,7 +31,7 @@ public:
 
 private:
     void run();
-    static void caresCallback(void *arg, int status, int timeouts, struct hostent *host);
+    static void caresCallback(void *arg, int status, int timeouts, struct ares_addrinfo *result);
 
     // 200 ms settled for faster switching to the next try (next server)
     // this does not mean that the current request will be limited to 200ms,
@@ -62,11 +62,13 @@ private:
         std::uint32_t elapsedMs() override { return elapsedMs_; }
         bool isError() override { return isError_; }
         std::string errorString() override { return errorString_; }
+        std::uint32_t ttl() override { return ttl_; }
 
         std::vector<std::string> ips_;
         unsigned int elapsedMs_;
         bool isError_;
         std::string errorString_;
+        std::uint32_t ttl_ = 0;
     };
     AresLibraryInit aresLibraryInit_;
     std::thread thread_;
@@ -0,0 +1,46 @@
+// Benchmark of the per-handshake certificate setup done in CurlNetworkManager::sslctx_function:
+// adding every bundled certificate to the store of a new SSL_CTX against attaching the store CertManager builds once.
+// Usage: wsnet_certmanager_bench [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <openssl/ssl.h>
+#include "certmanager.h"
+
+namespace {
+
+template<typename Func>
+void runBenchmark(const char *name, int iterations, Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        SSL_CTX *ctx = SSL_CTX_new(TLS_client_method());
+        func(ctx);
+        SSL_CTX_free(ctx);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    printf("%-30s %10.2f us/SSL_CTX\n", name, (double)elapsed / iterations);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    wsnet::CertManager certManager;
+    printf("%d certificates, %d iterations\n", certManager.count(), iterations);
+
+    // the cost of SSL_CTX_new/SSL_CTX_free alone, included in the other results
+    runBenchmark("SSL_CTX only", iterations, [](SSL_CTX *) {});
+    runBenchmark("add every certificate", iterations, [&certManager](SSL_CTX *ctx) {
+        X509_STORE *store = SSL_CTX_get_cert_store(ctx);
+        for (int i = 0; i < certManager.count(); ++i)
+            X509_STORE_add_cert(store, certManager.getCert(i));
+    });
+    runBenchmark("attach the shared store", iterations, [&certManager](SSL_CTX *ctx) {
+        certManager.attachToSslCtx(ctx);
+    });
+    return 0;
+}
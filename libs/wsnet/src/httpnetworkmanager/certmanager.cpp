@@ -22,10 +22,13 @@ CertManager::CertManager()
     parseCertsBundle(std::string(fdCert.begin(), fdCert.end()));
 
     spdlog::info("CertManager number of certificates : {}", certs_.size());
+    buildStore();
 }
 
 CertManager::~CertManager()
 {
+    if (store_)
+        X509_STORE_free(store_);
     cleanCerts();
 }
 
@@ -39,6 +42,29 @@ X509 *CertManager::getCert(int ind)
     return certs_[ind].cert;
 }
 
+bool CertManager::attachToSslCtx(SSL_CTX *ctx)
+{
+    if (!store_)
+        return false;
+    return SSL_CTX_set1_verify_cert_store(ctx, store_) == 1;
+}
+
+void CertManager::buildStore()
+{
+    store_ = X509_STORE_new();
+    if (!store_) {
+        spdlog::error("CertManager failed to create the certificate store");
+        return;
+    }
+    // the same defaults curl sets up on its own store when no CA file or path is given
+    if (X509_STORE_set_default_paths(store_) != 1)
+        spdlog::warn("CertManager failed to load the default CA locations");
+    X509_STORE_set_flags(store_, X509_V_FLAG_PARTIAL_CHAIN);
+
+    for (const auto &it : certs_)
+        X509_STORE_add_cert(store_, it.cert);
+}
+
 void CertManager::parseCertsBundle(const std::string &arr)
 {
     size_t curOffs = 0;
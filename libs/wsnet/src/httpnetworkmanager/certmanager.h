@@ -15,6 +15,10 @@ public:
     int count();
     X509 *getCert(int ind);
 
+    // Attaches the store built once at construction to the SSL_CTX as its verification store, only a reference is taken.
+    // The store holds our certificates along with the system default CA locations curl would have set up.
+    bool attachToSslCtx(SSL_CTX *ctx);
+
 private:
     struct CertDescr
     {
@@ -23,10 +27,12 @@ private:
     };
 
     std::vector<CertDescr> certs_;
+    X509_STORE *store_ = nullptr;
 
     void parseCertsBundle(const std::string &arr);
     CertDescr loadCert(const std::string_view &data);
     void cleanCerts();
+    void buildStore();
 
 
     std::string_view sub_string(std::string_view s, std::size_t p, std::size_t n = std::string_view::npos)
@@ -1,4 +1,5 @@
 #include "curlnetworkmanager.h"
+#include <algorithm>
 #include <spdlog/spdlog.h>
 #include "utils/utils.h"
 #include "settings.h"
@@ -14,15 +15,20 @@ namespace wsnet {
 
 CurlNetworkManager::CurlNetworkManager(CurlFinishedCallback finishedCallback, CurlProgressCallback progressCallback, CurlReadyDataCallback readyDataCallback) :
     finishedCallback_(finishedCallback), progressCallback_(progressCallback), readyDataCallback_(readyDataCallback),
-    finish_(false), multiHandle_(nullptr)
+    work_(boost::asio::make_work_guard(io_context_)), timer_(io_context_), multiHandle_(nullptr),
+    connectionPoolsTimer_(io_context_)
 {
 }
 
 CurlNetworkManager::~CurlNetworkManager()
 {
-    finish_ = true;
-    condition_.notify_all();
-    thread_.join();
+    if (thread_.joinable()) {
+        boost::asio::post(io_context_, [this] {
+            cleanup();
+        });
+        work_.reset();  // the thread finishes as soon as all handlers are done
+        thread_.join();
+    }
 
     if (isCurlGlobalInitialized_)
         curl_global_cleanup();
@@ -45,150 +51,228 @@ bool CurlNetworkManager::init()
         isCurlGlobalInitialized_ = true;
 
         multiHandle_ = curl_multi_init();
-        thread_ = std::thread(std::bind(&CurlNetworkManager::run, this));
+        if (curl_multi_setopt(multiHandle_, CURLMOPT_SOCKETFUNCTION, curlMultiSocketCallback) != CURLM_OK ||
+            curl_multi_setopt(multiHandle_, CURLMOPT_SOCKETDATA, this) != CURLM_OK ||
+            curl_multi_setopt(multiHandle_, CURLMOPT_TIMERFUNCTION, curlMultiTimerCallback) != CURLM_OK ||
+            curl_multi_setopt(multiHandle_, CURLMOPT_TIMERDATA, this) != CURLM_OK) {
+            spdlog::critical("curl_multi_setopt failed");
+            return false;
+        }
+        thread_ = std::thread([this](){ io_context_.run(); });
     }
     return true;
 }
 
-void CurlNetworkManager::executeRequest(std::uint64_t requestId, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips)
+void CurlNetworkManager::executeRequest(std::uint64_t requestId, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips, bool isStreamData)
+{
+    boost::asio::post(io_context_, [this, requestId, request, ips, isStreamData] {
+        executeRequestImpl(requestId, request, ips, isStreamData);
+    });
+}
+
+void CurlNetworkManager::cancelRequest(std::uint64_t requestId)
+{
+    boost::asio::post(io_context_, [this, requestId] {
+        cancelRequestImpl(requestId);
+    });
+}
+
+void CurlNetworkManager::setProxySettings(const std::string &address, const std::string &username, const std::string &password)
+{
+    boost::asio::post(io_context_, [this, address, username, password] {
+        proxySettings_.address = address;
+        proxySettings_.username = username;
+        proxySettings_.password = password;
+    });
+}
+
+void CurlNetworkManager::setWhitelistSocketsCallback(std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistSocketsCallback> > callback)
+{
+    std::lock_guard locker(mutexForWhiteListSockets_);
+    whitelistSocketsCallback_ = callback;
+}
+
+void CurlNetworkManager::executeRequestImpl(std::uint64_t requestId, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips, bool isStreamData)
 {
     RequestInfo *requestInfo = new RequestInfo();
     requestInfo->id = requestId;
     requestInfo->curlNetworkManager = this;
+    requestInfo->isStreamData = isStreamData;
     requestInfo->curlEasyHandle = curl_easy_init();
 
-    if (requestInfo->curlEasyHandle)  {
-        std::lock_guard locker(mutex_);
-        if (setupOptions(requestInfo, request, ips)) {
-            activeRequests_[requestId] = requestInfo;
-            condition_.notify_all();
-            curl_multi_wakeup(multiHandle_);
+    if (requestInfo->curlEasyHandle && setupOptions(requestInfo, request, ips)) {
+        activeRequests_[requestId] = requestInfo;
+        // curl will call curlMultiTimerCallback to start the transfer
+        if (curl_multi_add_handle(multiHandle_, requestInfo->curlEasyHandle) == CURLM_OK)
             return;
-        }
+        activeRequests_.erase(requestId);
     }
     // if we here then something failed
     assert(false);
+    delete requestInfo;
+    finishedCallback_(requestId, false, std::string());
 }
 
-void CurlNetworkManager::cancelRequest(std::uint64_t requestId)
+void CurlNetworkManager::cancelRequestImpl(std::uint64_t requestId)
 {
-    std::lock_guard locker(mutex_);
     auto it = activeRequests_.find(requestId);
-    if (it != activeRequests_.end())
-        it->second->isNeedRemoveFromMultiHandle = true;
+    if (it != activeRequests_.end()) {
+        curl_multi_remove_handle(multiHandle_, it->second->curlEasyHandle);
+        delete it->second;
+        activeRequests_.erase(it);
+        removeUnusedConnectionPools();
+    }
 }
 
-void CurlNetworkManager::setProxySettings(const std::string &address, const std::string &username, const std::string &password)
+void CurlNetworkManager::cleanup()
 {
-    std::lock_guard locker(mutex_);
-    proxySettings_.address = address;
-    proxySettings_.username = username;
-    proxySettings_.password = password;
+    for (auto it = activeRequests_.begin(); it != activeRequests_.end(); ++it) {
+        curl_multi_remove_handle(multiHandle_, it->second->curlEasyHandle);
+        delete it->second;
+    }
+    activeRequests_.clear();
+    removeAllConnectionPools();
+    // closes the remaining connections via curlCloseSocketCallback
+    curl_multi_cleanup(multiHandle_);
+    multiHandle_ = nullptr;
+    sockets_.clear();
+    timer_.cancel();
+    connectionPoolsTimer_.cancel();
 }
 
-void CurlNetworkManager::setWhitelistSocketsCallback(std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistSocketsCallback> > callback)
+void CurlNetworkManager::waitSocket(const std::shared_ptr<SocketInfo> &socketInfo, curl_socket_t s)
 {
-    std::lock_guard locker(mutexForWhiteListSockets_);
-    whitelistSocketsCallback_ = callback;
+    // the wait operations which are no longer needed are not canceled, their result is ignored in onSocketEvent
+    std::weak_ptr<SocketInfo> weakSocketInfo = socketInfo;
+    if ((socketInfo->what & CURL_POLL_IN) && !socketInfo->isWaitingRead) {
+        socketInfo->isWaitingRead = true;
+        socketInfo->asyncWait(true, [this, weakSocketInfo, s](const boost::system::error_code &ec) {
+            onSocketEvent(weakSocketInfo, s, CURL_CSELECT_IN, ec);
+        });
+    }
+    if ((socketInfo->what & CURL_POLL_OUT) && !socketInfo->isWaitingWrite) {
+        socketInfo->isWaitingWrite = true;
+        socketInfo->asyncWait(false, [this, weakSocketInfo, s](const boost::system::error_code &ec) {
+            onSocketEvent(weakSocketInfo, s, CURL_CSELECT_OUT, ec);
+        });
+    }
 }
 
-void CurlNetworkManager::run()
+void CurlNetworkManager::onSocketEvent(const std::weak_ptr<SocketInfo> &weakSocketInfo, curl_socket_t s, int action, const boost::system::error_code &ec)
 {
-    while (!finish_) {
+    // the socket has already been closed by curl
+    auto socketInfo = weakSocketInfo.lock();
+    if (!socketInfo)
+        return;
+
+    if (action == CURL_CSELECT_IN)
+        socketInfo->isWaitingRead = false;
+    else
+        socketInfo->isWaitingWrite = false;
+
+    if (ec == boost::asio::error::operation_aborted || !multiHandle_)
+        return;
+
+    // curl is no longer interested in this event
+    if (!(socketInfo->what & (action == CURL_CSELECT_IN ? CURL_POLL_IN : CURL_POLL_OUT)))
+        return;
+
+    int runningHandles;
+    curl_multi_socket_action(multiHandle_, s, ec ? CURL_CSELECT_ERR : action, &runningHandles);
+    checkFinishedRequests();
+
+    // rearm the wait if the socket has not been closed by curl in the meantime
+    auto it = sockets_.find(s);
+    if (it != sockets_.end() && it->second == socketInfo)
+        waitSocket(socketInfo, s);
+}
 
-        {
-            std::unique_lock<std::mutex> locker(mutex_);
-            while (activeRequests_.empty() && !finish_)
-                condition_.wait(locker);
-        }
+void CurlNetworkManager::onTimer(const boost::system::error_code &ec)
+{
+    // the timer could expire before the cleanup() call
+    if (ec || !multiHandle_)
+        return;
 
-        if (finish_)
-            break;
+    int runningHandles;
+    curl_multi_socket_action(multiHandle_, CURL_SOCKET_TIMEOUT, 0, &runningHandles);
+    checkFinishedRequests();
+}
 
-        {
-            std::lock_guard locker(mutex_);
-            // add curl handles for requests which have not been added
-            for (auto it = activeRequests_.begin(); it != activeRequests_.end(); ++it) {
-                if (!it->second->isAddedToMultiHandle) {
-                    curl_multi_add_handle(multiHandle_, it->second->curlEasyHandle);
-                    it->second->isAddedToMultiHandle = true;
-                }
-            }
+void CurlNetworkManager::onConnectionPoolsTimer(const boost::system::error_code &ec)
+{
+    if (ec || !multiHandle_)
+        return;
+    removeUnusedConnectionPools();
+}
 
-            // check for need to be deleted requests (for cases when the function abort() was called)
-            for (auto it = activeRequests_.begin(); it != activeRequests_.end(); /*++it*/) {  // should not increment it in the for loop
-                if (it->second->isNeedRemoveFromMultiHandle) {
-                    RequestInfo *ri = it->second;
-                    if (it->second->isAddedToMultiHandle)
-                        curl_multi_remove_handle(multiHandle_, ri->curlEasyHandle);
-                    it = activeRequests_.erase(it);
-                    delete ri;
-                } else {
-                    ++it;
-                }
+void CurlNetworkManager::checkFinishedRequests()
+{
+    struct CURLMsg *curlMsg = nullptr;
+    do {
+        int msgq = 0;
+        curlMsg = curl_multi_info_read(multiHandle_, &msgq);
+        if (curlMsg && (curlMsg->msg == CURLMSG_DONE)) {
+            CURL *curlEasyHandle = curlMsg->easy_handle;
+            std::uint64_t *pointerId;
+            curl_easy_getinfo(curlEasyHandle, CURLINFO_PRIVATE, &pointerId);
+            assert(pointerId != nullptr);
+
+            std::uint64_t id = *pointerId;
+            auto it = activeRequests_.find(id);
+            assert(it != activeRequests_.end());
+            assert(it->second->curlEasyHandle == curlEasyHandle);
+
+            if (curlMsg->data.result != CURLE_OK) {
+                spdlog::debug("Curl request error: {}", curl_easy_strerror(curlMsg->data.result));
             }
-        }
 
-        int still_running;
-        curl_multi_perform(multiHandle_, &still_running);
-        // check finished requests
-        struct CURLMsg *curlMsg = nullptr;
-        do {
-            int msgq = 0;
-            curlMsg = curl_multi_info_read(multiHandle_, &msgq);
-            if (curlMsg && (curlMsg->msg == CURLMSG_DONE)) {
-                CURL *curlEasyHandle = curlMsg->easy_handle;
-                std::uint64_t *pointerId;
-                curl_easy_getinfo(curlEasyHandle, CURLINFO_PRIVATE, &pointerId);
-                assert(pointerId != nullptr);
-
-                curl_off_t totalTime;
-                curl_easy_getinfo(curlEasyHandle, CURLINFO_TOTAL_TIME_T, &totalTime);
-
-                std::uint64_t id = *pointerId;
-                auto it = activeRequests_.find(id);
-                assert(it != activeRequests_.end());
-                assert(it->second->curlEasyHandle == curlEasyHandle);
-
-                if (curlMsg->data.result != CURLE_OK) {
-                    spdlog::debug("Curl request error: {}", curl_easy_strerror(curlMsg->data.result));
-                }
-
-                finishedCallback_(id, curlMsg->data.result == CURLE_OK);
-
-                //remove request from activeRequests
-                curl_multi_remove_handle(multiHandle_, curlEasyHandle);
-                delete it->second;
-                activeRequests_.erase(id);
-            }
-        } while(curlMsg);
+            finishedCallback_(id, curlMsg->data.result == CURLE_OK, std::move(it->second->data));
 
+            // the pool is idle since its last request finished
+            if (!it->second->connectionPoolKey.empty()) {
+                auto pool = connectionPools_.find(it->second->connectionPoolKey);
+                if (pool != connectionPools_.end())
+                    pool->second.lastUsed = std::chrono::steady_clock::now();
+            }
 
-        // wait for activity or timeout
-        int numfds;
-        curl_multi_poll(multiHandle_, NULL, 0, 1000, &numfds);
-    }
+            //remove request from activeRequests
+            curl_multi_remove_handle(multiHandle_, curlEasyHandle);
+            delete it->second;
+            activeRequests_.erase(it);
+        }
+    } while(curlMsg);
 
-    for (auto it = activeRequests_.begin(); it != activeRequests_.end(); ++it)
-        delete it->second;
-    activeRequests_.clear();
+    removeUnusedConnectionPools();
 }
 
 CURLcode CurlNetworkManager::sslctx_function(CURL *curl, void *sslctx, void *parm)
 {
-    X509_STORE *store = SSL_CTX_get_cert_store((SSL_CTX *)sslctx);
+    // the peer is verified against the shared store instead of the one curl built for this SSL_CTX
     CertManager *certManager = static_cast<CertManager *>(parm);
-    for (int i = 0; i < certManager->count(); ++i)
-        X509_STORE_add_cert(store, certManager->getCert(i));
-
-    return CURLE_OK;
+    return certManager->attachToSslCtx((SSL_CTX *)sslctx) ? CURLE_OK : CURLE_SSL_CERTPROBLEM;
 }
 
 size_t CurlNetworkManager::writeDataCallback(void *ptr, size_t size, size_t count, void *ri)
 {
     RequestInfo *requestInfo = static_cast<RequestInfo *>(ri);
-    std::string data((char *)ptr, (char *)ptr + size * count);
-    requestInfo->curlNetworkManager->readyDataCallback_(requestInfo->id, data);
+    // an exception must not cross the curl C code, returning a different size aborts the transfer instead
+    try {
+        if (requestInfo->isStreamData) {
+            std::string data((char *)ptr, (char *)ptr + size * count);
+            requestInfo->curlNetworkManager->readyDataCallback_(requestInfo->id, data);
+        } else {
+            // reserve the body at once if the server reported its size, the reported size is not trusted beyond kMaxReserveSize
+            if (requestInfo->data.empty()) {
+                curl_off_t contentLength;
+                if (curl_easy_getinfo(requestInfo->curlEasyHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength) == CURLE_OK && contentLength > 0)
+                    requestInfo->data.reserve((size_t)std::min<curl_off_t>(contentLength, kMaxReserveSize));
+            }
+            requestInfo->data.append((char *)ptr, size * count);
+        }
+    } catch (const std::exception &e) {
+        spdlog::error("Curl write data callback failed: {}", e.what());
+        return 0;
+    }
     return size*count;
 }
 
@@ -216,14 +300,42 @@ int CurlNetworkManager::curlSocketCallback(void *clientp, curl_socket_t curlfd,
     return CURL_SOCKOPT_OK;
 }
 
+curl_socket_t CurlNetworkManager::curlOpenSocketCallback(void *clientp, curlsocktype purpose, struct curl_sockaddr *address)
+{
+    CurlNetworkManager *this_ = (CurlNetworkManager *)clientp;
+    // only TCP connections are used
+    if (purpose != CURLSOCKTYPE_IPCXN || address->socktype != SOCK_STREAM)
+        return CURL_SOCKET_BAD;
+
+    auto socketInfo = std::make_shared<SocketInfo>(this_->io_context_);
+    boost::system::error_code ec;
+    socketInfo->socket.open(address->family == AF_INET6 ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4(), ec);
+    if (ec) {
+        spdlog::error("CurlNetworkManager failed to open socket: {}", ec.message());
+        return CURL_SOCKET_BAD;
+    }
+    curl_socket_t s = socketInfo->socket.native_handle();
+    this_->sockets_[s] = socketInfo;
+    return s;
+}
+
 int CurlNetworkManager::curlCloseSocketCallback(void *clientp, curl_socket_t curlfd)
 {
     CurlNetworkManager *this_ = (CurlNetworkManager *)clientp;
+    // the socket is closed when the SocketInfo is destroyed
+    auto it = this_->sockets_.find(curlfd);
+    if (it != this_->sockets_.end()) {
+        boost::system::error_code ec;
+        it->second->socket.close(ec);
+        this_->sockets_.erase(it);
+    } else {
 #ifdef _WIN32
-    closesocket(curlfd);
+        closesocket(curlfd);
 #else
-    close(curlfd);
+        close(curlfd);
 #endif
+    }
+
     std::lock_guard locker(this_->mutexForWhiteListSockets_);
     // whitelist the deleted socket descriptor
     if (this_->whitelistSockets_.find(curlfd) != this_->whitelistSockets_.end()) {
@@ -236,6 +348,84 @@ int CurlNetworkManager::curlCloseSocketCallback(void *clientp, curl_socket_t cur
     return CURL_SOCKOPT_OK;
 }
 
+int CurlNetworkManager::curlMultiSocketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp)
+{
+    CurlNetworkManager *this_ = (CurlNetworkManager *)userp;
+    auto it = this_->sockets_.find(s);
+    if (it == this_->sockets_.end()) {
+        if (what == CURL_POLL_REMOVE)
+            return 0;
+        // a descriptor curl has opened itself, not via curlOpenSocketCallback
+        auto socketInfo = std::make_shared<SocketInfo>(this_->io_context_);
+        if (!socketInfo->assignForeign(s)) {
+            spdlog::error("CurlNetworkManager failed to watch socket {}", (int)s);
+            return -1;
+        }
+        it = this_->sockets_.insert(std::make_pair(s, socketInfo)).first;
+    }
+
+    if (what == CURL_POLL_REMOVE && it->second->isForeign) {
+        // curl keeps the ownership, the pending waits complete with operation_aborted
+        this_->sockets_.erase(it);
+        return 0;
+    }
+
+    it->second->what = (what == CURL_POLL_REMOVE ? CURL_POLL_NONE : what);
+    this_->waitSocket(it->second, s);
+    return 0;
+}
+
+bool CurlNetworkManager::SocketInfo::assignForeign(curl_socket_t s)
+{
+    boost::system::error_code ec;
+#ifdef _WIN32
+    // curl emulates its socketpairs with loopback TCP sockets on Windows
+    socket.assign(boost::asio::ip::tcp::v4(), s, ec);
+#else
+    descriptor.assign(s, ec);
+#endif
+    isForeign = !ec;
+    return isForeign;
+}
+
+void CurlNetworkManager::SocketInfo::releaseForeign()
+{
+    if (!isForeign)
+        return;
+    isForeign = false;
+#ifdef _WIN32
+    boost::system::error_code ec;
+    socket.release(ec);
+#else
+    descriptor.release();
+#endif
+}
+
+int CurlNetworkManager::curlMultiTimerCallback(CURLM *multi, long timeoutMs, void *userp)
+{
+    CurlNetworkManager *this_ = (CurlNetworkManager *)userp;
+    // -1 means delete the timer, setting a new expiry time cancels the previous wait as well
+    if (timeoutMs < 0) {
+        this_->timer_.cancel();
+    } else {
+        this_->timer_.expires_after(std::chrono::milliseconds(timeoutMs));
+        this_->timer_.async_wait(std::bind(&CurlNetworkManager::onTimer, this_, std::placeholders::_1));
+    }
+    return 0;
+}
+
+void CurlNetworkManager::shareLockCallback(CURL *handle, curl_lock_data data, curl_lock_access access, void *clientp)
+{
+    CurlNetworkManager *this_ = (CurlNetworkManager *)clientp;
+    this_->shareMutexes_[data].lock();
+}
+
+void CurlNetworkManager::shareUnlockCallback(CURL *handle, curl_lock_data data, void *clientp)
+{
+    CurlNetworkManager *this_ = (CurlNetworkManager *)clientp;
+    this_->shareMutexes_[data].unlock();
+}
+
 bool CurlNetworkManager::setupOptions(RequestInfo *requestInfo, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips)
 {
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_WRITEFUNCTION, writeDataCallback) != CURLE_OK) return false;
@@ -243,6 +433,8 @@ bool CurlNetworkManager::setupOptions(RequestInfo *requestInfo, const std::share
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_ACCEPT_ENCODING, "") != CURLE_OK) return false;
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_URL, request->url().c_str()) != CURLE_OK) return false;
 
+    if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_OPENSOCKETFUNCTION, curlOpenSocketCallback) != CURLE_OK) return false;
+    if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_OPENSOCKETDATA, this) != CURLE_OK) return false;
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_SOCKOPTFUNCTION, curlSocketCallback) != CURLE_OK) return false;
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_SOCKOPTDATA, this) != CURLE_OK) return false;
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_CLOSESOCKETFUNCTION, curlCloseSocketCallback) != CURLE_OK) return false;
@@ -250,7 +442,7 @@ bool CurlNetworkManager::setupOptions(RequestInfo *requestInfo, const std::share
 
     spdlog::debug("New curl request : {}", request->url().c_str());
 
-    if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_FRESH_CONNECT, 1) != CURLE_OK) return false;
+    if (!setupConnectionPool(requestInfo, request, ips)) return false;
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_CONNECTTIMEOUT_MS , request->timeoutMs()) != CURLE_OK) return false;
 
     if (curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_XFERINFOFUNCTION, progressCallback) != CURLE_OK) return false;
@@ -365,5 +557,91 @@ bool CurlNetworkManager::setupProxy(RequestInfo *requestInfo)
     return true;
 }
 
+bool CurlNetworkManager::setupConnectionPool(RequestInfo *requestInfo, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips)
+{
+    // If the IPs are removed from the firewall exceptions after the request, an idle connection to them would be unusable.
+    // Reused connections keep their sockets in whitelistSockets_ until they are closed, so the whitelist sockets callback stays valid.
+    if (!request->isUseConnectionPool() || request->isRemoveFromWhitelistIpsAfterFinish())
+        return curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_FRESH_CONNECT, 1) == CURLE_OK;
+
+    std::string key = request->hostname() + ":" + std::to_string(request->port()) + "|" + request->sniDomain() + "|" +
+                      request->echConfig() + "|" + utils::join(ips, ",");
+
+    auto it = connectionPools_.find(key);
+    if (it == connectionPools_.end()) {
+        CURLSH *shareHandle = curl_share_init();
+        if (shareHandle == NULL) return false;
+        if (curl_share_setopt(shareHandle, CURLSHOPT_LOCKFUNC, shareLockCallback) != CURLSHE_OK ||
+            curl_share_setopt(shareHandle, CURLSHOPT_UNLOCKFUNC, shareUnlockCallback) != CURLSHE_OK ||
+            curl_share_setopt(shareHandle, CURLSHOPT_USERDATA, this) != CURLSHE_OK ||
+            curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT) != CURLSHE_OK ||
+            curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK) {
+            curl_share_cleanup(shareHandle);
+            return false;
+        }
+        it = connectionPools_.insert(std::make_pair(key, ConnectionPool { shareHandle })).first;
+    }
+    it->second.lastUsed = std::chrono::steady_clock::now();
+    requestInfo->connectionPoolKey = key;
+    return curl_easy_setopt(requestInfo->curlEasyHandle, CURLOPT_SHARE, it->second.shareHandle) == CURLE_OK;
+}
+
+bool CurlNetworkManager::isConnectionPoolInUse(const std::string &key) const
+{
+    for (const auto &request : activeRequests_) {
+        if (request.second->connectionPoolKey == key)
+            return true;
+    }
+    return false;
+}
+
+void CurlNetworkManager::removeUnusedConnectionPools()
+{
+    // close the pools idle for too long, closes their idle connections as well
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = connectionPools_.begin(); it != connectionPools_.end(); ) {
+        if (now - it->second.lastUsed >= kConnectionPoolIdleTimeout && !isConnectionPoolInUse(it->first)) {
+            curl_share_cleanup(it->second.shareHandle);
+            it = connectionPools_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    while (connectionPools_.size() > kMaxConnectionPools) {
+        // find the least recently used pool that has no active requests
+        auto lru = connectionPools_.end();
+        for (auto it = connectionPools_.begin(); it != connectionPools_.end(); ++it) {
+            if (!isConnectionPoolInUse(it->first) && (lru == connectionPools_.end() || it->second.lastUsed < lru->second.lastUsed))
+                lru = it;
+        }
+        if (lru == connectionPools_.end())
+            break;
+
+        curl_share_cleanup(lru->second.shareHandle);
+        connectionPools_.erase(lru);
+    }
+
+    // wake up when the oldest idle pool expires, the pools in use are checked again when their requests finish
+    auto oldest = connectionPools_.end();
+    for (auto it = connectionPools_.begin(); it != connectionPools_.end(); ++it) {
+        if (!isConnectionPoolInUse(it->first) && (oldest == connectionPools_.end() || it->second.lastUsed < oldest->second.lastUsed))
+            oldest = it;
+    }
+    if (oldest == connectionPools_.end()) {
+        connectionPoolsTimer_.cancel();
+    } else {
+        connectionPoolsTimer_.expires_at(oldest->second.lastUsed + kConnectionPoolIdleTimeout);
+        connectionPoolsTimer_.async_wait(std::bind(&CurlNetworkManager::onConnectionPoolsTimer, this, std::placeholders::_1));
+    }
+}
+
+void CurlNetworkManager::removeAllConnectionPools()
+{
+    for (auto &it : connectionPools_)
+        curl_share_cleanup(it.second.shareHandle);
+    connectionPools_.clear();
+}
+
 } // namespace wsnet
 
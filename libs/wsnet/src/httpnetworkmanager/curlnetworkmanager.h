@@ -3,9 +3,9 @@
 #include <curl/curl.h>
 #include <thread>
 #include <mutex>
-#include <atomic>
+#include <chrono>
 #include <map>
-#include <condition_variable>
+#include <boost/asio.hpp>
 #include "WSNetHttpRequest.h"
 #include "WSNetHttpNetworkManager.h"
 #include "certmanager.h"
@@ -13,11 +13,14 @@
 
 namespace wsnet {
 
-typedef std::function<void(std::uint64_t requestId, bool bSuccess)> CurlFinishedCallback;
+// data contains the response body, it's empty for requests with isStreamData, which receive it via the CurlReadyDataCallback
+typedef std::function<void(std::uint64_t requestId, bool bSuccess, std::string &&data)> CurlFinishedCallback;
 typedef std::function<void(std::uint64_t requestId, std::uint64_t bytesReceived, std::uint64_t bytesTotal)> CurlProgressCallback;
 typedef std::function<void(std::uint64_t requestId, const std::string &data)> CurlReadyDataCallback;
 
 // Implementing queries with curl library.
+// The curl multi handle is driven by socket and timer callbacks on its own io_context running in a separate thread.
+// The public functions can be called from any thread, they post the work to that io_context.
 class CurlNetworkManager
 {
 public:
@@ -27,16 +30,15 @@ public:
     bool init();
 
     // the calling party must take care that the requestId's are unique
-    void executeRequest(std::uint64_t requestId, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips);
+    // if isStreamData is false then the response body is accumulated on the curl thread and passed to the CurlFinishedCallback
+    // otherwise each received chunk is passed to the CurlReadyDataCallback
+    void executeRequest(std::uint64_t requestId, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips, bool isStreamData);
     void cancelRequest(std::uint64_t requestId);
 
     void setProxySettings(const std::string &address, const std::string &username, const std::string &password);
 
     void setWhitelistSocketsCallback(std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistSocketsCallback> > callback);
 
-private:
-    void run();
-
 private:
     bool isCurlGlobalInitialized_ = false;
     CurlFinishedCallback finishedCallback_;
@@ -45,10 +47,11 @@ private:
 
     CertManager certManager_;
 
-    std::mutex mutex_;
-    std::condition_variable condition_;
+    // all the members below (except for the whitelist sockets) are accessed only from the io_context_ thread
+    boost::asio::io_context io_context_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
+    boost::asio::steady_timer timer_;
     std::thread thread_;
-    std::atomic<bool> finish_;
 
     struct ProxySettings {
         std::string address;
@@ -62,8 +65,9 @@ private:
         CurlNetworkManager *curlNetworkManager;
         CURL *curlEasyHandle = nullptr;
         std::vector<struct curl_slist *> curlLists;
-        bool isAddedToMultiHandle = false;
-        bool isNeedRemoveFromMultiHandle = false;
+        std::string connectionPoolKey;      // empty if the request doesn't use the connection pool
+        bool isStreamData = false;
+        std::string data;                   // response body for requests without isStreamData
 
         // free all curl handles and data
         ~RequestInfo() {
@@ -79,9 +83,64 @@ private:
         }
     };
 
+    // the maximum response body size reserved up front from the Content-Length, larger bodies grow as they are received
+    static constexpr curl_off_t kMaxReserveSize = 4 * 1024 * 1024;
+
     CURLM *multiHandle_;
     std::map<std::uint64_t, RequestInfo *> activeRequests_;
 
+    // Sockets are created by us (see curlOpenSocketCallback) in order to wait for them on the io_context.
+    // The descriptors curl opens itself (e.g. the wakeup pipe of the threaded resolver) are watched as well,
+    // but they are only borrowed: released without closing when curl stops watching them.
+    struct SocketInfo {
+        explicit SocketInfo(boost::asio::io_context &io_context) : socket(io_context)
+#ifndef _WIN32
+            , descriptor(io_context)
+#endif
+        {}
+        ~SocketInfo() { releaseForeign(); }
+
+        boost::asio::ip::tcp::socket socket;
+#ifndef _WIN32
+        boost::asio::posix::stream_descriptor descriptor;   // used instead of the socket for the foreign descriptors
+#endif
+        bool isForeign = false;
+        int what = CURL_POLL_NONE;      // the events curl is interested in
+        bool isWaitingRead = false;
+        bool isWaitingWrite = false;
+
+        bool assignForeign(curl_socket_t s);
+        void releaseForeign();
+        template<typename Handler>
+        void asyncWait(bool isRead, Handler &&handler)
+        {
+#ifndef _WIN32
+            if (isForeign) {
+                descriptor.async_wait(isRead ? boost::asio::posix::descriptor_base::wait_read : boost::asio::posix::descriptor_base::wait_write,
+                                      std::forward<Handler>(handler));
+                return;
+            }
+#endif
+            socket.async_wait(isRead ? boost::asio::socket_base::wait_read : boost::asio::socket_base::wait_write, std::forward<Handler>(handler));
+        }
+    };
+    std::map<curl_socket_t, std::shared_ptr<SocketInfo> > sockets_;
+
+    // Shared connection and TLS session caches for requests with the isUseConnectionPool option.
+    // The pools are keyed by hostname, SNI domain, ECH config and resolved IPs,
+    // so a connection is never reused for a request to a different endpoint.
+    // The DNS cache is not shared, the pooled requests pin their addresses with CURLOPT_RESOLVE.
+    struct ConnectionPool {
+        CURLSH *shareHandle = nullptr;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+    static constexpr int kMaxConnectionPools = 16;
+    // the idle pools are closed after this time, along with their connections and TLS sessions
+    static constexpr std::chrono::seconds kConnectionPoolIdleTimeout{60};
+    std::map<std::string, ConnectionPool> connectionPools_;
+    boost::asio::steady_timer connectionPoolsTimer_;
+    std::mutex shareMutexes_[CURL_LOCK_DATA_LAST];    // curl requires the lock functions, although the handles are only used on one thread
+
     std::mutex mutexForWhiteListSockets_; // this socket protects whitelistSocketsCallback_ variable
     std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistSocketsCallback> > whitelistSocketsCallback_;
     std::set<int> whitelistSockets_;
@@ -90,13 +149,31 @@ private:
     static size_t writeDataCallback(void *ptr, size_t size, size_t count, void *ri);
     static int progressCallback(void *ri,   curl_off_t dltotal,   curl_off_t dlnow,   curl_off_t ultotal,   curl_off_t ulnow);
     static int curlSocketCallback(void *clientp, curl_socket_t curlfd, curlsocktype purpose);
+    static curl_socket_t curlOpenSocketCallback(void *clientp, curlsocktype purpose, struct curl_sockaddr *address);
     static int curlCloseSocketCallback(void *clientp, curl_socket_t curlfd);
+    static int curlMultiSocketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp);
+    static int curlMultiTimerCallback(CURLM *multi, long timeoutMs, void *userp);
+    static void shareLockCallback(CURL *handle, curl_lock_data data, curl_lock_access access, void *clientp);
+    static void shareUnlockCallback(CURL *handle, curl_lock_data data, void *clientp);
+
+    void executeRequestImpl(std::uint64_t requestId, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips, bool isStreamData);
+    void cancelRequestImpl(std::uint64_t requestId);
+    void cleanup();
 
+    void waitSocket(const std::shared_ptr<SocketInfo> &socketInfo, curl_socket_t s);
+    void onSocketEvent(const std::weak_ptr<SocketInfo> &socketInfo, curl_socket_t s, int action, const boost::system::error_code &ec);
+    void onTimer(const boost::system::error_code &ec);
+    void onConnectionPoolsTimer(const boost::system::error_code &ec);
+    void checkFinishedRequests();
 
     bool setupOptions(RequestInfo *requestInfo, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips);
     bool setupResolveHosts(RequestInfo *requestInfo, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips);
     bool setupSslVerification(RequestInfo *requestInfo, const std::shared_ptr<WSNetHttpRequest> &request);
     bool setupProxy(RequestInfo *requestInfo);
+    bool setupConnectionPool(RequestInfo *requestInfo, const std::shared_ptr<WSNetHttpRequest> &request, const std::vector<std::string> &ips);
+    bool isConnectionPoolInUse(const std::string &key) const;
+    void removeUnusedConnectionPools();
+    void removeAllConnectionPools();
 };
 
 } // namespace wsnet
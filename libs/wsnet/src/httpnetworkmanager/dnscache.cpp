@@ -1,10 +1,11 @@
 #include "dnscache.h"
 #include <assert.h>
+#include <algorithm>
 
 namespace wsnet {
 
-DnsCache::DnsCache(WSNetDnsResolver *dnsResolver, DnsCacheCallback callback) :
-    dnsResolver_(dnsResolver), callback_(callback)
+DnsCache::DnsCache(WSNetDnsResolver *dnsResolver, WSNetAdvancedParameters *advancedParameters, DnsCacheCallback callback) :
+    dnsResolver_(dnsResolver), advancedParameters_(advancedParameters), callback_(callback)
 {
 }
 
@@ -12,43 +13,84 @@ DnsCache::~DnsCache()
 {
     std::lock_guard locker(mutex_);
     for (auto &it : activeRequests_) {
-        it.second->cancel();
+        it.second.asyncRequest->cancel();
     }
 }
 
 DnsCacheResult DnsCache::resolve(std::uint64_t id, const std::string &hostname, bool bypassCache)
 {
     std::lock_guard locker(mutex_);
-    assert(activeRequests_.find(id) == activeRequests_.end());
 
+    bool isRefreshInBackground = false;
     if (!bypassCache) {
         auto it = cache_.find(hostname);
         if (it != cache_.end()) {
-            return DnsCacheResult { id, true, it->second, true };
+            auto now = std::chrono::steady_clock::now();
+            if (now < it->second.expireTime) {
+                return DnsCacheResult { id, it->second.bSuccess, it->second.ips, true };
+            } else if (it->second.bSuccess && advancedParameters_->isDnsStaleWhileRevalidate() &&
+                       now < it->second.expireTime + std::chrono::seconds(kMaxStaleSec)) {
+                isRefreshInBackground = true;
+            } else {
+                cache_.erase(it);
+            }
         }
     }
-    auto asyncRequest = dnsResolver_->lookup(hostname, id, std::bind(&DnsCache::onDnsResolved, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    activeRequests_[id] = asyncRequest;
+
+    // join the DNS request for this hostname if it is already in progress
+    auto it = activeRequests_.find(hostname);
+    if (it == activeRequests_.end()) {
+        auto asyncRequest = dnsResolver_->lookup(hostname, 0, std::bind(&DnsCache::onDnsResolved, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        it = activeRequests_.insert(std::make_pair(hostname, ActiveRequest { asyncRequest })).first;
+    }
+
+    if (isRefreshInBackground) {
+        auto &entry = cache_[hostname];
+        return DnsCacheResult { id, true, entry.ips, true };
+    }
+
+    it->second.ids.push_back(id);
     return DnsCacheResult { id, false, std::vector<std::string>(), false };
 }
 
-void DnsCache::onDnsResolved(std::uint64_t id, const std::string &hostname, std::shared_ptr<WSNetDnsRequestResult> result)
+void DnsCache::clear()
 {
     std::lock_guard locker(mutex_);
-    auto it = activeRequests_.find(id);
-    assert(it != activeRequests_.end());
+    cache_.clear();
+    // the requests in progress may have been sent to the previous network, their answers are returned but not cached
+    for (auto &it : activeRequests_)
+        it.second.isCacheable = false;
+}
 
-    if (!result->isError()) {
-        cache_[hostname] = result->ips();
-        callback_(DnsCacheResult { id, true, result->ips(), false } );
+void DnsCache::onDnsResolved(std::uint64_t /*id*/, const std::string &hostname, std::shared_ptr<WSNetDnsRequestResult> result)
+{
+    std::lock_guard locker(mutex_);
+    auto it = activeRequests_.find(hostname);
+    assert(it != activeRequests_.end());
 
+    auto now = std::chrono::steady_clock::now();
+    bool bSuccess = !result->isError();
+    if (!it->second.isCacheable) {
+        // nothing to cache
+    } else if (bSuccess) {
+        std::uint32_t ttl = result->ttl() > 0 ? std::clamp(result->ttl(), kMinTtlSec, kMaxTtlSec) : kDefaultTtlSec;
+        cache_[hostname] = CacheEntry { true, result->ips(), now + std::chrono::seconds(ttl) };
     } else {
-        cache_.erase(hostname);
-        callback_(DnsCacheResult { id, false, std::vector<std::string>(), false } );
+        // in the stale-while-revalidate mode, keep serving the previous answer if the refresh fails
+        auto entry = cache_.find(hostname);
+        bool isKeepStale = entry != cache_.end() && entry->second.bSuccess && advancedParameters_->isDnsStaleWhileRevalidate();
+        if (!isKeepStale)
+            cache_[hostname] = CacheEntry { false, std::vector<std::string>(), now + std::chrono::seconds(kNegativeTtlSec) };
+    }
+
+    for (auto id : it->second.ids) {
+        if (bSuccess)
+            callback_(DnsCacheResult { id, true, result->ips(), false } );
+        else
+            callback_(DnsCacheResult { id, false, std::vector<std::string>(), false } );
     }
 
     activeRequests_.erase(it);
 }
 
 } // namespace wsnet
-
@@ -2,7 +2,9 @@
 #include <string>
 #include <map>
 #include <mutex>
+#include <chrono>
 #include "WSNetDnsResolver.h"
+#include "WSNetAdvancedParameters.h"
 
 namespace wsnet {
 
@@ -16,21 +18,49 @@ struct DnsCacheResult
 
 typedef std::function<void(const DnsCacheResult &result)> DnsCacheCallback;
 
-// TODO: add TTL support, remove from cache + whitelist ips handler
+// DNS cache which takes into account the TTL of the records.
+// Failed lookups are cached for a short time (negative caching).
+// Concurrent lookups for the same hostname share one DNS request.
+// If the stale-while-revalidate mode is enabled in the advanced parameters, then an expired answer is returned immediately
+// and refreshed in the background.
 class DnsCache final
 {
 public:
-    explicit DnsCache(WSNetDnsResolver *dnsResolver, DnsCacheCallback callback);
+    explicit DnsCache(WSNetDnsResolver *dnsResolver, WSNetAdvancedParameters *advancedParameters, DnsCacheCallback callback);
     ~DnsCache();
 
     DnsCacheResult resolve(std::uint64_t id, const std::string &hostname, bool bypassCache = false);
+    // drops all the answers, for example when the network changes
+    void clear();
 
 private:
+    static constexpr std::uint32_t kMinTtlSec = 30;             // do not send a DNS request for the same hostname more often
+    static constexpr std::uint32_t kMaxTtlSec = 3600;
+    static constexpr std::uint32_t kDefaultTtlSec = 300;        // if the TTL is unknown
+    static constexpr std::uint32_t kNegativeTtlSec = 5;
+    static constexpr std::uint32_t kMaxStaleSec = 24 * 3600;    // how long an expired answer can be returned in the stale-while-revalidate mode
+
     WSNetDnsResolver *dnsResolver_;
+    WSNetAdvancedParameters *advancedParameters_;
     DnsCacheCallback callback_;
     std::mutex mutex_;
-    std::map<std::string, std::vector<std::string> > cache_;
-    std::map<std::uint64_t, std::shared_ptr<WSNetCancelableCallback> > activeRequests_;
+
+    struct CacheEntry
+    {
+        bool bSuccess;
+        std::vector<std::string> ips;
+        std::chrono::steady_clock::time_point expireTime;
+    };
+    std::map<std::string, CacheEntry> cache_;
+
+    // active DNS requests by hostname, with the identifiers of all the resolve() calls waiting for them
+    struct ActiveRequest
+    {
+        std::shared_ptr<WSNetCancelableCallback> asyncRequest;
+        std::vector<std::uint64_t> ids;
+        bool isCacheable = true;    // false if the cache was cleared while the request was in progress
+    };
+    std::map<std::string, ActiveRequest> activeRequests_;
 
     void onDnsResolved(std::uint64_t id, const std::string &hostname, std::shared_ptr<WSNetDnsRequestResult> result);
 };
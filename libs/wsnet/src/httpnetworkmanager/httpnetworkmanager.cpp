@@ -4,8 +4,8 @@
 
 namespace wsnet {
 
-HttpNetworkManager::HttpNetworkManager(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver) :
-    io_context_(io_context), impl_(io_context, dnsResolver)
+HttpNetworkManager::HttpNetworkManager(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver, WSNetAdvancedParameters *advancedParameters) :
+    io_context_(io_context), impl_(io_context, dnsResolver, advancedParameters)
 {
 }
 
@@ -51,6 +51,13 @@ void HttpNetworkManager::setProxySettings(const std::string &address, const std:
     });
 }
 
+void HttpNetworkManager::clearDnsCache()
+{
+    boost::asio::post(io_context_, [this] {
+        impl_.clearDnsCache();
+    });
+}
+
 std::shared_ptr<WSNetCancelableCallback> HttpNetworkManager::setWhitelistIpsCallback(WSNetHttpNetworkManagerWhitelistIpsCallback whitelistIpsCallback)
 {
     if (whitelistIpsCallback) {
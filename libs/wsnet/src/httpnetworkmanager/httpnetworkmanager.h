@@ -1,6 +1,7 @@
 #pragma once
 
 #include "WSNetHttpNetworkManager.h"
+#include "WSNetAdvancedParameters.h"
 #include <boost/asio.hpp>
 #include "httpnetworkmanager_impl.h"
 
@@ -10,7 +11,7 @@ namespace wsnet {
 class HttpNetworkManager : public WSNetHttpNetworkManager
 {
 public:
-    HttpNetworkManager(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver);
+    HttpNetworkManager(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver, WSNetAdvancedParameters *advancedParameters);
 
     bool init();
 
@@ -38,6 +39,9 @@ public:
     std::shared_ptr<WSNetCancelableCallback> setWhitelistIpsCallback(WSNetHttpNetworkManagerWhitelistIpsCallback whitelistIpsCallback) override;
     std::shared_ptr<WSNetCancelableCallback> setWhitelistSocketsCallback(WSNetHttpNetworkManagerWhitelistSocketsCallback whitelistSocketsCallback) override;
 
+    // not a part of the public interface, called by WSNet when the network changes
+    void clearDnsCache();
+
 private:
     boost::asio::io_context &io_context_;
     HttpNetworkManager_impl impl_;
@@ -4,10 +4,10 @@
 
 namespace wsnet {
 
-HttpNetworkManager_impl::HttpNetworkManager_impl(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver) :
+HttpNetworkManager_impl::HttpNetworkManager_impl(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver, WSNetAdvancedParameters *advancedParameters) :
     io_context_(io_context),
-    dnsCache_(dnsResolver, std::bind(&HttpNetworkManager_impl::onDnsResolvedCallback, this, std::placeholders::_1)),
-    curlNetworkManager_(std::bind(&HttpNetworkManager_impl::onCurlFinishedCallback, this, std::placeholders::_1, std::placeholders::_2),
+    dnsCache_(dnsResolver, advancedParameters, std::bind(&HttpNetworkManager_impl::onDnsResolvedCallback, this, std::placeholders::_1)),
+    curlNetworkManager_(std::bind(&HttpNetworkManager_impl::onCurlFinishedCallback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
                         std::bind(&HttpNetworkManager_impl::onCurlProgressCallback, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
                         std::bind(&HttpNetworkManager_impl::onCurlReadyDataCallback, this, std::placeholders::_1, std::placeholders::_2))
 {
@@ -55,6 +55,11 @@ void HttpNetworkManager_impl::setProxySettings(const std::string &address, const
     curlNetworkManager_.setProxySettings(address, username, password);
 }
 
+void HttpNetworkManager_impl::clearDnsCache()
+{
+    dnsCache_.clear();
+}
+
 void HttpNetworkManager_impl::setWhitelistIpsCallback(std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistIpsCallback>> callback)
 {
     whitelistIpsCallback_ = callback;
@@ -94,13 +99,14 @@ void HttpNetworkManager_impl::onDnsResolvedImpl(const DnsCacheResult &result)
     if (request->second.request->isWhiteListIps())
         whitelistIps(result.ips);
 
-    curlNetworkManager_.executeRequest(request->first, request->second.request, result.ips);
+    // only the consumers of the ready data callback need the response body chunk by chunk
+    curlNetworkManager_.executeRequest(request->first, request->second.request, result.ips, !request->second.callbacks->isDataReadyNull());
 }
 
-void HttpNetworkManager_impl::onCurlFinishedCallback(std::uint64_t requestId, bool bSuccess)
+void HttpNetworkManager_impl::onCurlFinishedCallback(std::uint64_t requestId, bool bSuccess, std::string &&data)
 {
-    boost::asio::post(io_context_, [this, requestId, bSuccess] {
-        onCurlFinishedCallbackImpl(requestId, bSuccess);
+    boost::asio::post(io_context_, [this, requestId, bSuccess, data = std::move(data)] {
+        onCurlFinishedCallbackImpl(requestId, bSuccess, data);
     });
 }
 
@@ -118,13 +124,13 @@ void HttpNetworkManager_impl::onCurlReadyDataCallback(std::uint64_t requestId, c
     });
 }
 
-void HttpNetworkManager_impl::onCurlFinishedCallbackImpl(std::uint64_t requestId, bool bSuccess)
+void HttpNetworkManager_impl::onCurlFinishedCallbackImpl(std::uint64_t requestId, bool bSuccess, const std::string &data)
 {
     auto request = requestsMap_.find(requestId);
     if (request != requestsMap_.end()) {
         NetworkError networkError = (bSuccess ? NetworkError::kSuccess : NetworkError::kCurlError);
         RequestData &rd = request->second;
-        rd.callbacks->callFinished(rd.userDataId, utils::since(rd.startTime).count(), networkError, rd.data);
+        rd.callbacks->callFinished(rd.userDataId, utils::since(rd.startTime).count(), networkError, data);
         if (rd.request->isRemoveFromWhitelistIpsAfterFinish())
             removeWhitelistIps(rd.ips);
         requestsMap_.erase(requestId);
@@ -152,14 +158,7 @@ void HttpNetworkManager_impl::onCurlReadyDataCallbackImpl(std::uint64_t requestI
         if (rd.callbacks->isCanceled()) {
             cancelAndRemoveRequest(request);
         } else {
-            if (!rd.callbacks->isDataReadyNull()) {
-                // call callback
-                rd.callbacks->callDataReady(rd.userDataId, data);
-            } else {
-                // append data to internal data buffer
-                request->second.data.reserve( request->second.data.size() + data.size() );
-                request->second.data.insert( request->second.data.end(), data.begin(), data.end() );
-            }
+            rd.callbacks->callDataReady(rd.userDataId, data);
         }
     }
 }
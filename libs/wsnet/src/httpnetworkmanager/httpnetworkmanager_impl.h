@@ -4,6 +4,7 @@
 #include <mutex>
 #include <boost/asio.hpp>
 #include "WSNetDnsResolver.h"
+#include "WSNetAdvancedParameters.h"
 #include "curlnetworkmanager.h"
 #include "dnscache.h"
 #include "utils/cancelablecallback.h"
@@ -15,7 +16,7 @@ using HttpNetworkManagerCallbacks = CancelableCallback3<WSNetHttpNetworkManagerF
 class HttpNetworkManager_impl
 {
 public:
-    HttpNetworkManager_impl(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver);
+    HttpNetworkManager_impl(boost::asio::io_context &io_context, WSNetDnsResolver *dnsResolver, WSNetAdvancedParameters *advancedParameters);
     virtual ~HttpNetworkManager_impl();
 
     bool init();
@@ -29,6 +30,8 @@ public:
     void setWhitelistIpsCallback(std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistIpsCallback> > callback);
     void setWhitelistSocketsCallback(std::shared_ptr<CancelableCallback<WSNetHttpNetworkManagerWhitelistSocketsCallback> > callback);
 
+    void clearDnsCache();
+
 private:
     boost::asio::io_context &io_context_;
     DnsCache dnsCache_;
@@ -44,7 +47,6 @@ private:
         std::shared_ptr<HttpNetworkManagerCallbacks> callbacks;
         std::chrono::steady_clock::time_point startTime;
         std::vector<std::string> ips;
-        std::string data;
     };
 
     std::map<std::uint64_t, RequestData> requestsMap_;
@@ -55,11 +57,11 @@ private:
     void onDnsResolvedCallback(const DnsCacheResult &result);
     void onDnsResolvedImpl(const DnsCacheResult &result);
 
-    void onCurlFinishedCallback(std::uint64_t requestId, bool bSuccess);
+    void onCurlFinishedCallback(std::uint64_t requestId, bool bSuccess, std::string &&data);
     void onCurlProgressCallback(std::uint64_t requestId, std::uint64_t bytesReceived, std::uint64_t bytesTotal);
     void onCurlReadyDataCallback(std::uint64_t requestId, const std::string &data);
 
-    void onCurlFinishedCallbackImpl(std::uint64_t requestId, bool bSuccess);
+    void onCurlFinishedCallbackImpl(std::uint64_t requestId, bool bSuccess, const std::string &data);
     void onCurlProgressCallbackImpl(std::uint64_t requestId, std::uint64_t bytesReceived, std::uint64_t bytesTotal);
     void onCurlReadyDataCallbackImpl(std::uint64_t requestId, const std::string &data);
 
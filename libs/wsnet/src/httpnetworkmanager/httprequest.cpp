@@ -18,6 +18,7 @@ struct HttpRequest::Impl
     bool isExtraTLSPadding = false;
     std::string overrideIp;
     bool isWhiteListIps = true;
+    bool isUseConnectionPool = false;
     skyr::url skyrUrl;
 };
 
@@ -167,5 +168,15 @@ bool HttpRequest::isWhiteListIps() const
     return pImpl_->isWhiteListIps;
 }
 
+void HttpRequest::setUseConnectionPool(bool isUseConnectionPool)
+{
+    pImpl_->isUseConnectionPool = isUseConnectionPool;
+}
+
+bool HttpRequest::isUseConnectionPool() const
+{
+    return pImpl_->isUseConnectionPool;
+}
+
 } // namespace wsnet
 
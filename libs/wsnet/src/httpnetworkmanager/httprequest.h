@@ -58,6 +58,10 @@ public:
     void setIsWhiteListIps(bool isWhiteListIps) override;
     bool isWhiteListIps() const override;
 
+    // false by default
+    void setUseConnectionPool(bool isUseConnectionPool) override;
+    bool isUseConnectionPool() const override;
+
 private:
     // internal implementation class (to hide include skyr/url.hpp from this header, there were compilation errors in Windows)
     struct Impl;
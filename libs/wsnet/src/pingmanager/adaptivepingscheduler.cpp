@@ -0,0 +1,92 @@
+#include "adaptivepingscheduler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace wsnet {
+
+AdaptivePingScheduler::AdaptivePingScheduler(const Params &params) :
+    params_(params),
+    window_(params.initialWindow),
+    tokens_(params.burst),
+    lastRefill_(std::chrono::steady_clock::now())
+{
+    assert(params_.minWindow > 0 && params_.minWindow <= params_.initialWindow && params_.initialWindow <= params_.maxWindow);
+    assert(params_.pingsPerSec > 0 && params_.burst > 0);
+}
+
+void AdaptivePingScheduler::push(std::uint64_t id, bool isPriority)
+{
+    if (isPriority)
+        priorityQueue_.push_back(id);
+    else
+        queue_.push_back(id);
+}
+
+bool AdaptivePingScheduler::pop(std::uint64_t &id, std::chrono::milliseconds &wait)
+{
+    wait = std::chrono::milliseconds(0);
+    if ((priorityQueue_.empty() && queue_.empty()) || inFlight_ >= window_)
+        return false;
+
+    refillTokens();
+    if (tokens_ < 1.0) {
+        wait = std::chrono::milliseconds((int)std::ceil((1.0 - tokens_) * 1000.0 / params_.pingsPerSec));
+        return false;
+    }
+    tokens_ -= 1.0;
+
+    auto &queue = priorityQueue_.empty() ? queue_ : priorityQueue_;
+    id = queue.front();
+    queue.pop_front();
+    inFlight_++;
+    return true;
+}
+
+void AdaptivePingScheduler::onPingFinished(const std::string &ip, bool isSuccess, std::int32_t timeMs)
+{
+    inFlight_--;
+    assert(inFlight_ >= 0);
+
+    samples_++;
+    if (!isSuccess) {
+        losses_++;
+    } else {
+        auto it = baselines_.find(ip);
+        if (it != baselines_.end()) {
+            double inflation = std::max(0, timeMs - it->second);
+            inflationMs_ += (inflation - inflationMs_) / 8;
+            it->second = std::min(it->second, timeMs);
+        } else if (baselines_.size() < kMaxBaselines) {
+            baselines_[ip] = timeMs;
+        }
+    }
+
+    if (samples_ >= window_)
+        adjustWindow();
+}
+
+void AdaptivePingScheduler::refillTokens()
+{
+    auto now = std::chrono::steady_clock::now();
+    double elapsedSec = std::chrono::duration<double>(now - lastRefill_).count();
+    tokens_ = std::min((double)params_.burst, tokens_ + elapsedSec * params_.pingsPerSec);
+    lastRefill_ = now;
+}
+
+void AdaptivePingScheduler::adjustWindow()
+{
+    double lossRate = (double)losses_ / samples_;
+    minLossRate_ = std::min(minLossRate_, lossRate);
+
+    bool isLossIncreased = lossRate > kLossThreshold && lossRate > minLossRate_ + kLossIncreaseThreshold;
+    if (isLossIncreased || inflationMs_ > kMaxInflationMs)
+        window_ = std::max(params_.minWindow, window_ / 2);
+    else
+        window_ = std::min(params_.maxWindow, window_ + std::max(1, window_ / 4));
+
+    samples_ = 0;
+    losses_ = 0;
+}
+
+} // namespace wsnet
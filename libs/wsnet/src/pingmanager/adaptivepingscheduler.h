@@ -0,0 +1,57 @@
+#pragma once
+#include <deque>
+#include <map>
+#include "ipingscheduler.h"
+
+namespace wsnet {
+
+// Concurrency window which grows while the pings are fine and shrinks on increasing loss or RTT inflation,
+// plus token bucket pacing of the ping starts.
+// The RTT inflation is measured against the lowest RTT seen for the same IP, since the RTTs of different servers are not comparable.
+// Not thread safe
+class AdaptivePingScheduler : public IPingScheduler
+{
+public:
+    struct Params
+    {
+        int initialWindow;
+        int minWindow;
+        int maxWindow;
+        double pingsPerSec;     // token bucket rate
+        int burst;              // token bucket size
+    };
+
+    explicit AdaptivePingScheduler(const Params &params);
+
+    void push(std::uint64_t id, bool isPriority) override;
+    bool pop(std::uint64_t &id, std::chrono::milliseconds &wait) override;
+    void onPingFinished(const std::string &ip, bool isSuccess, std::int32_t timeMs) override;
+
+private:
+    static constexpr double kLossThreshold = 0.2;           // shrink the window if the loss rate of the window is higher than
+    static constexpr double kLossIncreaseThreshold = 0.1;   // ... and higher than the lowest loss rate seen by this value (servers that are always down)
+    static constexpr double kMaxInflationMs = 30.0;         // shrink the window if the smoothed RTT inflation is higher
+    static constexpr size_t kMaxBaselines = 4096;
+
+    const Params params_;
+    std::deque<std::uint64_t> priorityQueue_;
+    std::deque<std::uint64_t> queue_;
+
+    int window_;
+    int inFlight_ = 0;
+
+    double tokens_;
+    std::chrono::steady_clock::time_point lastRefill_;
+
+    // statistics for the current window
+    int samples_ = 0;
+    int losses_ = 0;
+    double minLossRate_ = 1.0;
+    double inflationMs_ = 0.0;      // EWMA
+    std::map<std::string, std::int32_t> baselines_;     // lowest RTT by IP
+
+    void refillTokens();
+    void adjustWindow();
+};
+
+} // namespace wsnet
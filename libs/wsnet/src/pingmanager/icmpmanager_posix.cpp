@@ -0,0 +1,255 @@
+#include "icmpmanager_posix.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstring>
+#include <random>
+#include <spdlog/spdlog.h>
+
+namespace wsnet {
+
+namespace {
+constexpr std::uint8_t kIcmpEchoReply = 0;
+constexpr std::uint8_t kIcmpEchoRequest = 8;
+constexpr size_t kIcmpHeaderSize = 8;
+}
+
+IcmpManager_posix::IcmpManager_posix(boost::asio::io_context &io_context) :
+    io_context_(io_context)
+{
+    std::random_device rd;
+    identifier_ = (std::uint16_t)rd();
+}
+
+IcmpManager_posix::~IcmpManager_posix()
+{
+    std::lock_guard locker(mutex_);
+    pendingPings_.clear();
+    socket_.reset();
+}
+
+bool IcmpManager_posix::init()
+{
+    // Unprivileged ICMP sockets are supported on macOS/iOS, Android and on Linux if allowed by net.ipv4.ping_group_range
+    int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+    if (fd < 0) {
+        fd = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+        if (fd < 0) {
+            spdlog::info("IcmpManager_posix cannot open an ICMP socket, errno: {}", errno);
+            return false;
+        }
+        isRawSocket_ = true;
+    }
+
+    int on = 1;
+    isTimestampEnabled_ = setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on)) == 0;
+
+    try {
+        socket_ = std::make_unique<boost::asio::posix::stream_descriptor>(io_context_, fd);
+        socket_->non_blocking(true);
+    } catch (...) {
+        spdlog::error("IcmpManager_posix cannot assign the ICMP socket");
+        socket_.reset();
+        close(fd);
+        return false;
+    }
+
+    spdlog::info("IcmpManager_posix initialized, {} socket", isRawSocket_ ? "raw" : "datagram");
+    return true;
+}
+
+bool IcmpManager_posix::ping(const std::string &ip, int timeoutMs, IcmpManagerCallback callback)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1)
+        return false;
+
+    std::lock_guard locker(mutex_);
+    if (!socket_)
+        return false;
+
+    std::uint16_t sequence = curSequence_++;
+    // the sequence number is still in use (possible only with more than 65535 pings in flight)
+    if (pendingPings_.find(sequence) != pendingPings_.end())
+        return false;
+
+    unsigned char packet[kIcmpHeaderSize + kPayloadSize];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = kIcmpEchoRequest;
+    packet[1] = 0;  // code
+    packet[4] = identifier_ >> 8;
+    packet[5] = identifier_ & 0xFF;
+    packet[6] = sequence >> 8;
+    packet[7] = sequence & 0xFF;
+    for (int i = 0; i < kPayloadSize; ++i)
+        packet[kIcmpHeaderSize + i] = (unsigned char)i;
+    std::uint16_t sum = checksum(packet, sizeof(packet));
+    memcpy(packet + 2, &sum, sizeof(sum));
+
+    PendingPing pendingPing;
+    pendingPing.address = addr.sin_addr.s_addr;
+    pendingPing.sendTime = std::chrono::system_clock::now();
+    pendingPing.sendTimeSteady = std::chrono::steady_clock::now();
+    pendingPing.callback = callback;
+
+    if (sendto(socket_->native_handle(), packet, sizeof(packet), 0, (struct sockaddr *)&addr, sizeof(addr)) != (ssize_t)sizeof(packet)) {
+        spdlog::debug("IcmpManager_posix sendto failed for {}, errno: {}", ip, errno);
+        return false;
+    }
+
+    pendingPing.timer = std::make_unique<boost::asio::steady_timer>(io_context_);
+    pendingPing.timer->expires_after(std::chrono::milliseconds(timeoutMs));
+    pendingPing.timer->async_wait(std::bind(&IcmpManager_posix::onTimeout, this, sequence, std::placeholders::_1));
+    pendingPings_[sequence] = std::move(pendingPing);
+
+    if (!isWaiting_)
+        waitForReply();
+    return true;
+}
+
+void IcmpManager_posix::waitForReply()
+{
+    // wait only while there are pings in flight, so as not to keep the io_context busy
+    isWaiting_ = true;
+    socket_->async_wait(boost::asio::posix::stream_descriptor::wait_read, std::bind(&IcmpManager_posix::onReadable, this, std::placeholders::_1));
+}
+
+void IcmpManager_posix::onReadable(const boost::system::error_code &ec)
+{
+    std::vector<std::pair<IcmpManagerCallback, std::int32_t>> finished;
+    {
+        std::lock_guard locker(mutex_);
+        isWaiting_ = false;
+        if (!socket_)
+            return;
+
+        if (!ec) {
+            // read all the available replies
+            while (true) {
+                unsigned char buf[1024];
+                union {
+                    char buf[CMSG_SPACE(sizeof(struct timeval))];
+                    struct cmsghdr align;
+                } control;
+                struct sockaddr_in from;
+                struct iovec iov = { buf, sizeof(buf) };
+                struct msghdr msg;
+                memset(&msg, 0, sizeof(msg));
+                msg.msg_name = &from;
+                msg.msg_namelen = sizeof(from);
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+                msg.msg_control = control.buf;
+                msg.msg_controllen = sizeof(control.buf);
+
+                ssize_t size = recvmsg(socket_->native_handle(), &msg, 0);
+                if (size <= 0)
+                    break;
+
+                const struct timeval *timestamp = nullptr;
+                if (isTimestampEnabled_) {
+                    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP) {
+                            timestamp = (const struct timeval *)CMSG_DATA(cmsg);
+                            break;
+                        }
+                    }
+                }
+
+                std::int32_t timeMs;
+                auto it = processReply(buf, size, from.sin_addr.s_addr, timestamp, timeMs);
+                if (it != pendingPings_.end()) {
+                    finished.push_back(std::make_pair(it->second.callback, timeMs));
+                    pendingPings_.erase(it);
+                }
+            }
+        }
+
+        if (!pendingPings_.empty())
+            waitForReply();
+    }
+
+    for (const auto &it : finished)
+        it.first(true, it.second);
+}
+
+std::map<std::uint16_t, IcmpManager_posix::PendingPing>::iterator IcmpManager_posix::processReply(const unsigned char *data, size_t size,
+                                                                                                   std::uint32_t fromAddress, const struct timeval *timestamp,
+                                                                                                   std::int32_t &outTimeMs)
+{
+    // raw sockets (and datagram sockets on macOS) return the packet with the IP header
+    if (size > 0 && (data[0] & 0xF0) == 0x40) {
+        size_t ipHeaderSize = (data[0] & 0x0F) * 4;
+        if (size < ipHeaderSize)
+            return pendingPings_.end();
+        data += ipHeaderSize;
+        size -= ipHeaderSize;
+    }
+
+    if (size < kIcmpHeaderSize || data[0] != kIcmpEchoReply)
+        return pendingPings_.end();
+
+    // the identifier of datagram sockets is replaced by the kernel on Linux, but such sockets receive only their own replies
+    std::uint16_t identifier = (data[4] << 8) | data[5];
+    if (isRawSocket_ && identifier != identifier_)
+        return pendingPings_.end();
+
+    std::uint16_t sequence = (data[6] << 8) | data[7];
+    auto it = pendingPings_.find(sequence);
+    if (it == pendingPings_.end() || it->second.address != fromAddress)
+        return pendingPings_.end();
+
+    long long timeUs = -1;
+    if (timestamp) {
+        auto recvTime = std::chrono::system_clock::time_point(std::chrono::seconds(timestamp->tv_sec) + std::chrono::microseconds(timestamp->tv_usec));
+        timeUs = std::chrono::duration_cast<std::chrono::microseconds>(recvTime - it->second.sendTime).count();
+    }
+    // no kernel timestamp or the system clock has been changed
+    if (timeUs < 0)
+        timeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - it->second.sendTimeSteady).count();
+
+    outTimeMs = (std::int32_t)(timeUs / 1000);
+    it->second.timer->cancel();
+    return it;
+}
+
+void IcmpManager_posix::onTimeout(std::uint16_t sequence, const boost::system::error_code &ec)
+{
+    if (ec)
+        return;
+
+    IcmpManagerCallback callback;
+    {
+        std::lock_guard locker(mutex_);
+        auto it = pendingPings_.find(sequence);
+        if (it == pendingPings_.end())
+            return;
+        callback = it->second.callback;
+        pendingPings_.erase(it);
+        // stop waiting for the socket if there are no pings in flight
+        if (pendingPings_.empty() && isWaiting_)
+            socket_->cancel();
+    }
+    callback(false, 0);
+}
+
+std::uint16_t IcmpManager_posix::checksum(const unsigned char *data, size_t size)
+{
+    std::uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < size; i += 2) {
+        std::uint16_t word;
+        memcpy(&word, data + i, sizeof(word));
+        sum += word;
+    }
+    if (size & 1)
+        sum += data[size - 1];
+    while (sum >> 16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    return (std::uint16_t)~sum;
+}
+
+} // namespace wsnet
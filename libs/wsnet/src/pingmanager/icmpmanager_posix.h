@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <boost/asio.hpp>
+
+struct timeval;
+
+namespace wsnet {
+
+typedef std::function<void(bool isSuccess, std::int32_t timeMs)> IcmpManagerCallback;
+
+// In-process ICMP pinger for posix systems, replaces spawning the ping utility for each host.
+// Uses a single unprivileged ICMP datagram socket (or a raw socket if the datagram one is not permitted) for all pings,
+// the replies are matched to the requests by the sequence number and the source address.
+// The RTT is calculated from the kernel receive timestamp (SO_TIMESTAMP) where it is available.
+// Thread safe
+class IcmpManager_posix
+{
+public:
+    explicit IcmpManager_posix(boost::asio::io_context &io_context);
+    ~IcmpManager_posix();
+
+    // returns false if neither an unprivileged nor a raw ICMP socket can be opened
+    bool init();
+
+    // IPv4 addresses only
+    // the callback is called from the io_context thread
+    bool ping(const std::string &ip, int timeoutMs, IcmpManagerCallback callback);
+
+private:
+    static constexpr int kPayloadSize = 16;
+
+    boost::asio::io_context &io_context_;
+    std::unique_ptr<boost::asio::posix::stream_descriptor> socket_;
+    bool isRawSocket_ = false;
+    bool isTimestampEnabled_ = false;
+    std::uint16_t identifier_;
+    std::uint16_t curSequence_ = 0;
+    bool isWaiting_ = false;
+
+    struct PendingPing
+    {
+        std::uint32_t address;      // network byte order
+        std::chrono::system_clock::time_point sendTime;     // same clock as SO_TIMESTAMP
+        std::chrono::steady_clock::time_point sendTimeSteady;
+        std::unique_ptr<boost::asio::steady_timer> timer;
+        IcmpManagerCallback callback;
+    };
+
+    std::mutex mutex_;
+    std::map<std::uint16_t, PendingPing> pendingPings_;     // by sequence number
+
+    void waitForReply();
+    void onReadable(const boost::system::error_code &ec);
+    std::map<std::uint16_t, PendingPing>::iterator processReply(const unsigned char *data, size_t size, std::uint32_t fromAddress,
+                                                               const struct timeval *timestamp, std::int32_t &outTimeMs);
+    void onTimeout(std::uint16_t sequence, const boost::system::error_code &ec);
+    static std::uint16_t checksum(const unsigned char *data, size_t size);
+};
+
+} // namespace wsnet
@@ -43,6 +43,9 @@ public:
     }
 
     bool isParallelPing() const { return isParallelPing_; }
+    const std::string &ip() const { return ip_; }
+    bool isSuccess() const { return isSuccess_; }
+    std::int32_t timeMs() const { return timeMs_; }
 
 protected:
     std::uint64_t id_;
@@ -0,0 +1,25 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace wsnet {
+
+// Decides the order and the moment to start the queued pings of one type
+class IPingScheduler
+{
+public:
+    virtual ~IPingScheduler() {}
+
+    // priority pings (e.g. the selected or favourite locations) are started before the others
+    virtual void push(std::uint64_t id, bool isPriority) = 0;
+
+    // Returns true and the id of the ping to start now.
+    // Returns false if the queue is empty or the ping is not allowed yet, in the last case wait is set to the time after which to try again.
+    virtual bool pop(std::uint64_t &id, std::chrono::milliseconds &wait) = 0;
+
+    // Must be called for each ping returned by pop()
+    virtual void onPingFinished(const std::string &ip, bool isSuccess, std::int32_t timeMs) = 0;
+};
+
+} // namespace wsnet
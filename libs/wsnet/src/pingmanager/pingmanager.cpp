@@ -1,5 +1,6 @@
 #include "pingmanager.h"
 #include <spdlog/spdlog.h>
+#include "adaptivepingscheduler.h"
 #include "pingmethod_http.h"
 
 #ifdef _WIN32
@@ -12,23 +13,40 @@ namespace wsnet {
 
 PingManager::PingManager(boost::asio::io_context &io_context, WSNetHttpNetworkManager *httpNetworkManager) :
     io_context_(io_context),
-    httpNetworkManager_(httpNetworkManager)
+    httpNetworkManager_(httpNetworkManager),
+    pacingTimer_(io_context)
 {
+    // HTTP pings compete with each other for the uplink and skew the results if started all at once
+    schedulers_[PingType::kHttp] = std::make_unique<AdaptivePingScheduler>(AdaptivePingScheduler::Params { 8, 2, 32, 40.0, 8 });
 
-#ifndef _WIN32
-    processManager_ = std::make_unique<ProcessManager>(io_context);
+#ifdef _WIN32
+    schedulers_[PingType::kIcmp] = std::make_unique<AdaptivePingScheduler>(AdaptivePingScheduler::Params { 10, 2, 10, 50.0, 10 });
+#else
+    // the ping utility is the fallback if an ICMP socket cannot be used, a process per ping is expensive
+    processManager_ = std::make_unique<ProcessManager>(io_context, kMaxPingProcesses);
+    icmpManager_ = std::make_unique<IcmpManager_posix>(io_context);
+    if (icmpManager_->init()) {
+        // a native ICMP ping in flight costs only a map entry and a timer
+        schedulers_[PingType::kIcmp] = std::make_unique<AdaptivePingScheduler>(AdaptivePingScheduler::Params { 32, 4, 100, 200.0, 32 });
+    } else {
+        icmpManager_.reset();
+        schedulers_[PingType::kIcmp] = std::make_unique<AdaptivePingScheduler>(AdaptivePingScheduler::Params { 10, 2, 10, 20.0, 10 });
+    }
 #endif
 }
 
 PingManager::~PingManager()
 {
     std::lock_guard locker(mutex_);
+    pacingTimer_.cancel();
 #ifdef _WIN32
     eventCallbackManager_.stop();
 #else
+    icmpManager_.reset();
     processManager_.reset();
 #endif
     map_.clear();
+    batches_.clear();
 }
 
 std::shared_ptr<WSNetCancelableCallback> PingManager::ping(const std::string &ip, const std::string &hostname, PingType pingType, WSNetPingCallback callback)
@@ -37,23 +55,42 @@ std::shared_ptr<WSNetCancelableCallback> PingManager::ping(const std::string &ip
     std::lock_guard locker(mutex_);
 
     auto callbackFunc = std::make_shared<CancelableCallback<WSNetPingCallback>>(callback);
-    auto ping = createPingMethod(curPingId_, ip, hostname, pingType, callbackFunc);
-    map_[curPingId_] = std::unique_ptr<IPingMethod>(ping);
+    addPing(ip, hostname, pingType, callbackFunc);
+    processNextPingsInQueue();
+    return callbackFunc;
+}
 
-    //TODO: add a delay between pings
-    // We do HTTPS-requests right away
-    if (pingType == PingType::kHttp) {
-        ping->ping(!isConnectedToVpn_);
-    }
-    // while tcp and icmp are in parallel in queue
-    else {
-        queue_.push(curPingId_);
-        processNextPingsInQueue();
-    }
-    curPingId_++;
+std::shared_ptr<WSNetCancelableCallback> PingManager::pingBatch(const std::vector<std::string> &ips, const std::vector<std::string> &hostnames,
+                                                                PingType pingType, WSNetPingBatchCallback callback)
+{
+    assert(hostnames.empty() || hostnames.size() == ips.size());
+    std::lock_guard locker(mutex_);
+
+    auto callbackFunc = std::make_shared<CancelableCallback<WSNetPingBatchCallback>>(callback);
+    if (ips.empty())
+        return callbackFunc;
+
+    std::uint64_t batchId = curBatchId_++;
+    auto batch = std::make_unique<Batch>(io_context_);
+    batch->callback = callbackFunc;
+    batch->remaining = ips.size();
+    batches_[batchId] = std::move(batch);
+
+    // a single callback for all pings of the batch
+    using namespace std::placeholders;
+    auto pingCallback = std::make_shared<CancelableCallback<WSNetPingCallback>>(std::bind(&PingManager::onBatchPingFinished, this, batchId, _1, _2, _3, _4));
+    for (size_t i = 0; i < ips.size(); ++i)
+        addPing(ips[i], hostnames.empty() ? std::string() : hostnames[i], pingType, pingCallback);
+    processNextPingsInQueue();
     return callbackFunc;
 }
 
+void PingManager::setPriorityIps(const std::vector<std::string> &ips)
+{
+    std::lock_guard locker(mutex_);
+    priorityIps_ = std::set<std::string>(ips.begin(), ips.end());
+}
+
 void PingManager::setIsConnectedToVpnState(bool isConnected)
 {
     std::lock_guard locker(mutex_);
@@ -68,12 +105,9 @@ void PingManager::onPingMethodFinished(std::uint64_t id)
         auto it = map_.find(id);
         assert(it != map_.end());
 
-        if (it->second->isParallelPing()) {
-            curParallelPings_--;
-            assert(curParallelPings_ >= 0);
-        }
-
-        it->second->callCallback();
+        auto &pingMethod = it->second.pingMethod;
+        schedulers_[it->second.pingType]->onPingFinished(pingMethod->ip(), pingMethod->isSuccess(), pingMethod->timeMs());
+        pingMethod->callCallback();
         map_.erase(it);
         processNextPingsInQueue();
     });
@@ -88,7 +122,7 @@ IPingMethod *PingManager::createPingMethod(std::uint64_t id, const std::string &
 #ifdef _WIN32
         return new PingMethodIcmp_win(eventCallbackManager_, id, ip, hostname, true, callback, std::bind(&PingManager::onPingMethodFinished, this, std::placeholders::_1));
 #else
-        return new PingMethodIcmp_posix(id, ip, hostname, true, callback, std::bind(&PingManager::onPingMethodFinished, this, std::placeholders::_1), processManager_.get());
+        return new PingMethodIcmp_posix(id, ip, hostname, true, callback, std::bind(&PingManager::onPingMethodFinished, this, std::placeholders::_1), icmpManager_.get(), processManager_.get());
 #endif
     } else {
         assert(false);
@@ -96,14 +130,86 @@ IPingMethod *PingManager::createPingMethod(std::uint64_t id, const std::string &
     return 0;
 }
 
+void PingManager::addPing(const std::string &ip, const std::string &hostname, PingType pingType, PingFinishedCallback callback)
+{
+    auto ping = createPingMethod(curPingId_, ip, hostname, pingType, callback);
+    map_[curPingId_] = PingInfo { std::unique_ptr<IPingMethod>(ping), pingType };
+    schedulers_[pingType]->push(curPingId_, priorityIps_.find(ip) != priorityIps_.end());
+    curPingId_++;
+}
+
+// called under the mutex from onPingMethodFinished()
+void PingManager::onBatchPingFinished(std::uint64_t batchId, const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState)
+{
+    auto it = batches_.find(batchId);
+    assert(it != batches_.end());
+    Batch &batch = *it->second;
+    batch.ips.push_back(ip);
+    batch.isSuccess.push_back(isSuccess);
+    batch.timesMs.push_back(timeMs);
+    batch.isFromDisconnectedVpnState.push_back(isFromDisconnectedVpnState);
+    batch.remaining--;
+
+    if (batch.remaining == 0 || batch.ips.size() >= kMaxBatchSize) {
+        flushBatch(batchId);
+    } else if (!batch.isTimerActive) {
+        batch.isTimerActive = true;
+        batch.timer.expires_after(std::chrono::milliseconds(kBatchIntervalMs));
+        batch.timer.async_wait([this, batchId](const boost::system::error_code &ec) {
+            if (ec)
+                return;
+            std::lock_guard locker(mutex_);
+            flushBatch(batchId);
+        });
+    }
+}
+
+void PingManager::flushBatch(std::uint64_t batchId)
+{
+    auto it = batches_.find(batchId);
+    if (it == batches_.end())
+        return;
+
+    Batch &batch = *it->second;
+    if (batch.isTimerActive) {
+        batch.timer.cancel();
+        batch.isTimerActive = false;
+    }
+    if (!batch.ips.empty()) {
+        batch.callback->call(batch.ips, batch.isSuccess, batch.timesMs, batch.isFromDisconnectedVpnState);
+        batch.ips.clear();
+        batch.isSuccess.clear();
+        batch.timesMs.clear();
+        batch.isFromDisconnectedVpnState.clear();
+    }
+    if (batch.remaining == 0)
+        batches_.erase(it);
+}
+
 void PingManager::processNextPingsInQueue()
 {
-    while (curParallelPings_ < MAX_PARALLEL_PINGS && !queue_.empty()) {
-        auto id = queue_.front();
-        curParallelPings_++;
-        auto &ping = map_[id];
-        ping->ping(!isConnectedToVpn_);
-        queue_.pop();
+    std::chrono::milliseconds minWait(0);
+    for (auto &scheduler : schedulers_) {
+        std::uint64_t id;
+        std::chrono::milliseconds wait;
+        while (scheduler.second->pop(id, wait)) {
+            map_[id].pingMethod->ping(!isConnectedToVpn_);
+        }
+        if (wait.count() > 0 && (minWait.count() == 0 || wait < minWait))
+            minWait = wait;
+    }
+
+    // the pacing does not allow starting more pings right now
+    if (minWait.count() > 0 && !isPacingTimerActive_) {
+        isPacingTimerActive_ = true;
+        pacingTimer_.expires_after(minWait);
+        pacingTimer_.async_wait([this](const boost::system::error_code &ec) {
+            if (ec)
+                return;
+            std::lock_guard locker(mutex_);
+            isPacingTimerActive_ = false;
+            processNextPingsInQueue();
+        });
     }
 }
 
@@ -1,15 +1,17 @@
 #pragma once
 
-#include <queue>
 #include <map>
+#include <set>
 #include <boost/asio.hpp>
 #include "WSNetPingManager.h"
 #include "WSNetHttpNetworkManager.h"
 #include "ipingmethod.h"
+#include "ipingscheduler.h"
 
 #ifdef _WIN32
     #include "eventcallbackmanager_win.h"
 #else
+    #include "icmpmanager_posix.h"
     #include "processmanager.h"
 #endif
 
@@ -24,10 +26,18 @@ public:
 
     std::shared_ptr<WSNetCancelableCallback> ping(const std::string &ip, const std::string &hostname,
                                                   PingType pingType, WSNetPingCallback callback) override;
+    std::shared_ptr<WSNetCancelableCallback> pingBatch(const std::vector<std::string> &ips, const std::vector<std::string> &hostnames,
+                                                       PingType pingType, WSNetPingBatchCallback callback) override;
+    void setPriorityIps(const std::vector<std::string> &ips) override;
 
     void setIsConnectedToVpnState(bool isConnected);
 
 private:
+    static constexpr int kBatchIntervalMs = 50;
+    static constexpr size_t kMaxBatchSize = 64;
+    // the baseline ICMP concurrency, the ping utility processes are limited to it whatever the ICMP window is
+    static constexpr size_t kMaxPingProcesses = 10;
+
     boost::asio::io_context &io_context_;
     WSNetHttpNetworkManager *httpNetworkManager_;
 
@@ -36,21 +46,48 @@ private:
     EventCallbackManager_win eventCallbackManager_;
 #else
     // Required for ICMP pings for posix systems
+    // the native ICMP pinger is used if available, otherwise the ping utility
+    std::unique_ptr<IcmpManager_posix> icmpManager_;
     std::unique_ptr<ProcessManager> processManager_;
 #endif
     bool isConnectedToVpn_ = false;
     std::mutex mutex_;
     std::uint64_t curPingId_ = 0;
-    std::queue<std::uint64_t> queue_;
-    std::map<std::uint64_t, std::unique_ptr<IPingMethod> > map_;
+    struct PingInfo
+    {
+        std::unique_ptr<IPingMethod> pingMethod;
+        PingType pingType;
+    };
+    std::map<std::uint64_t, PingInfo> map_;
 
-    static constexpr int MAX_PARALLEL_PINGS = 10;
-    int curParallelPings_ = 0;
+    // separate concurrency window and pacing for each ping type
+    std::map<PingType, std::unique_ptr<IPingScheduler>> schedulers_;
+    std::set<std::string> priorityIps_;
+    boost::asio::steady_timer pacingTimer_;
+    bool isPacingTimerActive_ = false;
 
+    // the results of a pingBatch() not yet delivered
+    struct Batch
+    {
+        explicit Batch(boost::asio::io_context &io_context) : timer(io_context) {}
+        std::shared_ptr<CancelableCallback<WSNetPingBatchCallback>> callback;
+        size_t remaining = 0;
+        std::vector<std::string> ips;
+        std::vector<bool> isSuccess;
+        std::vector<std::int32_t> timesMs;
+        std::vector<bool> isFromDisconnectedVpnState;
+        boost::asio::steady_timer timer;
+        bool isTimerActive = false;
+    };
+    std::uint64_t curBatchId_ = 0;
+    std::map<std::uint64_t, std::unique_ptr<Batch>> batches_;
 
     void onPingMethodFinished(std::uint64_t id);
     IPingMethod *createPingMethod(std::uint64_t id, const std::string &ip, const std::string &hostname, PingType pingType, PingFinishedCallback callback);
     void processNextPingsInQueue();
+    void addPing(const std::string &ip, const std::string &hostname, PingType pingType, PingFinishedCallback callback);
+    void onBatchPingFinished(std::uint64_t batchId, const std::string &ip, bool isSuccess, std::int32_t timeMs, bool isFromDisconnectedVpnState);
+    void flushBatch(std::uint64_t batchId);
 };
 
 } // namespace wsnet
@@ -5,8 +5,10 @@
 namespace wsnet {
 
 PingMethodIcmp_posix::PingMethodIcmp_posix(std::uint64_t id, const std::string &ip, const std::string &hostname, bool isParallelPing,
-        PingFinishedCallback callback, PingMethodFinishedCallback pingMethodFinishedCallback, ProcessManager *processManager) :
+        PingFinishedCallback callback, PingMethodFinishedCallback pingMethodFinishedCallback,
+        IcmpManager_posix *icmpManager, ProcessManager *processManager) :
     IPingMethod(id, ip, hostname, isParallelPing, callback, pingMethodFinishedCallback),
+    icmpManager_(icmpManager),
     processManager_(processManager)
 {
 }
@@ -26,13 +28,25 @@ void PingMethodIcmp_posix::ping(bool isFromDisconnectedVpnState)
     using namespace std::placeholders;
     isFromDisconnectedVpnState_ = isFromDisconnectedVpnState;
 
-    if (!processManager_->execute("ping", {"-c", "1", "-W", "2000", ip_}, std::bind(&PingMethodIcmp_posix::onProcessFinished, this, _1, _2))) {
+    if (icmpManager_ && icmpManager_->ping(ip_, kTimeoutMs, std::bind(&PingMethodIcmp_posix::onIcmpFinished, this, _1, _2)))
+        return;
+
+    // fallback to the ping utility
+    if (!processManager_->execute("ping", {"-c", "1", "-W", std::to_string(kTimeoutMs), ip_}, std::bind(&PingMethodIcmp_posix::onProcessFinished, this, _1, _2))) {
         spdlog::error("PingMethodIcmp_posix::ping cannot execute ping command");
         callFinished();
         return;
     }
 }
 
+void PingMethodIcmp_posix::onIcmpFinished(bool isSuccess, std::int32_t timeMs)
+{
+    isSuccess_ = isSuccess;
+    if (isSuccess)
+        timeMs_ = timeMs;
+    callFinished();
+}
+
 void PingMethodIcmp_posix::onProcessFinished(int exitCode, const std::string &output)
 {
     if (exitCode == 0) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ipingmethod.h"
+#include "icmpmanager_posix.h"
 #include "processmanager.h"
 
 namespace wsnet {
@@ -9,14 +10,19 @@ class PingMethodIcmp_posix : public IPingMethod
 {
 public:
     PingMethodIcmp_posix(std::uint64_t id, const std::string &ip, const std::string &hostname, bool isParallelPing,
-                    PingFinishedCallback callback, PingMethodFinishedCallback pingMethodFinishedCallback, ProcessManager *processManager);
+                    PingFinishedCallback callback, PingMethodFinishedCallback pingMethodFinishedCallback,
+                    IcmpManager_posix *icmpManager, ProcessManager *processManager);
 
     virtual ~PingMethodIcmp_posix();
     void ping(bool isFromDisconnectedVpnState) override;
 
 private:
+    static constexpr int kTimeoutMs = 2000;
+
+    IcmpManager_posix *icmpManager_;       // null if the native ICMP sockets are not available
     ProcessManager *processManager_;
 
+    void onIcmpFinished(bool isSuccess, std::int32_t timeMs);
     void onProcessFinished(int exitCode, const std::string &output);
     int extractTimeMs(const std::string &str);
 };
@@ -3,14 +3,16 @@
 
 namespace wsnet {
 
-ProcessManager::ProcessManager(boost::asio::io_context &io_context) :
-    io_context_(io_context)
+ProcessManager::ProcessManager(boost::asio::io_context &io_context, size_t maxProcesses) :
+    io_context_(io_context),
+    maxProcesses_(maxProcesses)
 {
 }
 
 ProcessManager::~ProcessManager()
 {
     std::lock_guard locker(mutex_);
+    queue_.clear();
     for (auto &it : processes_) {
         it.second->process.terminate();
     }
@@ -20,6 +22,15 @@ bool ProcessManager::execute(const std::string &cmd, const std::vector<std::stri
 {
     std::lock_guard locker(mutex_);
 
+    if (maxProcesses_ != 0 && processes_.size() >= maxProcesses_) {
+        queue_.push_back(QueuedProcess { cmd, args, callback });
+        return true;
+    }
+    return startProcess(cmd, args, callback);
+}
+
+bool ProcessManager::startProcess(const std::string &cmd, const std::vector<std::string> &args, ProcessManagerCallback callback)
+{
     try {
         auto childProcess = std::make_unique<ChildProcess>();
         childProcess->callback = callback;
@@ -40,6 +51,9 @@ bool ProcessManager::execute(const std::string &cmd, const std::vector<std::stri
                     data = os.str();
                     callback = it->second->callback;
                     processes_.erase(it);
+                    // boost::process does not allow to start a child from the exit handler, the queued ones are started later
+                    if (!queue_.empty())
+                        boost::asio::post(io_context_, std::bind(&ProcessManager::startQueuedProcesses, this));
                 }
                 // call callback
                 callback(exit, data);
@@ -55,4 +69,20 @@ bool ProcessManager::execute(const std::string &cmd, const std::vector<std::stri
     return true;
 }
 
+void ProcessManager::startQueuedProcesses()
+{
+    std::vector<ProcessManagerCallback> failedCallbacks;
+    {
+        std::lock_guard locker(mutex_);
+        while (!queue_.empty() && processes_.size() < maxProcesses_) {
+            QueuedProcess queued = std::move(queue_.front());
+            queue_.pop_front();
+            if (!startProcess(queued.cmd, queued.args, queued.callback))
+                failedCallbacks.push_back(queued.callback);
+        }
+    }
+    for (const auto &callback : failedCallbacks)
+        callback(-1, std::string());
+}
+
 } // namespace wsnet
@@ -1,4 +1,5 @@
 #pragma once
+#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
@@ -13,17 +14,20 @@ namespace wsnet {
 typedef std::function<void(int exitCode, const std::string &output)> ProcessManagerCallback;
 
 // Simple process manager. Allows you to start a process and set a callback function that is called after the process is finished.
+// If maxProcesses is not 0, at most maxProcesses processes run at once and the rest wait in a queue.
+// A queued process that cannot be started finishes with the exit code -1.
 // Thread safe
 class ProcessManager
 {
 public:
-    ProcessManager(boost::asio::io_context &io_context);
+    ProcessManager(boost::asio::io_context &io_context, size_t maxProcesses = 0);
     ~ProcessManager();
 
     bool execute(const std::string &cmd, const std::vector<std::string> &args, ProcessManagerCallback callback);
 
 private:
     boost::asio::io_context &io_context_;
+    const size_t maxProcesses_;
 
     struct ChildProcess
     {
@@ -35,6 +39,18 @@ private:
     std::mutex mutex_;
     uint64_t curId_ = 0;
     std::unordered_map<uint64_t, std::unique_ptr<ChildProcess>> processes_;
+
+    struct QueuedProcess
+    {
+        std::string cmd;
+        std::vector<std::string> args;
+        ProcessManagerCallback callback;
+    };
+    std::deque<QueuedProcess> queue_;
+
+    // the mutex_ must be locked
+    bool startProcess(const std::string &cmd, const std::vector<std::string> &args, ProcessManagerCallback callback);
+    void startQueuedProcesses();
 };
 
 } // namespace wsnet
@@ -0,0 +1,108 @@
+#include "failoverracer.h"
+#include <spdlog/spdlog.h>
+#include "requestsfactory.h"
+#include "utils/utils.h"
+
+namespace wsnet {
+
+FailoverRacer::FailoverRacer(boost::asio::io_context &io_context, WSNetHttpNetworkManager *httpNetworkManager, std::vector<std::unique_ptr<BaseFailover>> failovers,
+                             bool bIgnoreSslErrors, bool isConnectedVpnState, WSNetAdvancedParameters *advancedParameters,
+                             FailedFailovers &failedFailovers, FailoverStats &failoverStats,
+                             FailoverRacerStartedCallback startedCallback, FailoverRacerCallback callback) :
+    httpNetworkManager_(httpNetworkManager),
+    advancedParameters_(advancedParameters),
+    failedFailovers_(failedFailovers),
+    failoverStats_(failoverStats),
+    startedCallback_(startedCallback),
+    callback_(callback),
+    bIgnoreSslErrors_(bIgnoreSslErrors),
+    isConnectedVpnState_(isConnectedVpnState),
+    failovers_(std::move(failovers)),
+    staggerTimer_(io_context)
+{
+    assert(!failovers_.empty());
+}
+
+FailoverRacer::~FailoverRacer()
+{
+    staggerTimer_.cancel();
+    // the destructors of RequestExecuterViaFailover cancel the running requests
+    racers_.clear();
+}
+
+void FailoverRacer::start()
+{
+    // always start asynchronously, so the callback is never called from here
+    scheduleNext(0);
+}
+
+void FailoverRacer::setIsConnectedToVpnState(bool isConnected)
+{
+    for (auto &it : racers_)
+        it.second.executor->setIsConnectedToVpnState(isConnected);
+}
+
+void FailoverRacer::startNext()
+{
+    assert(nextInd_ < failovers_.size());
+    size_t ind = nextInd_++;
+    std::unique_ptr<BaseFailover> failover = std::move(failovers_[ind]);
+    std::string failoverUid = failover->uniqueId();
+    spdlog::info("Racing: {}", failover->name());
+    startedCallback_(ind, failover->name());
+
+    // the probe result is not used, only the success of the request matters
+    auto probeCallback = std::make_shared<CancelableCallback<WSNetRequestFinishedCallback>>([](ServerApiRetCode, const std::string &) {});
+    std::unique_ptr<BaseRequest> probeRequest(requests_factory::myIP(probeCallback));
+
+    using namespace std::placeholders;
+    auto executor = new RequestExecuterViaFailover(httpNetworkManager_, std::move(probeRequest), std::move(failover),
+                                                   bIgnoreSslErrors_, isConnectedVpnState_, advancedParameters_, failedFailovers_,
+                                                   std::bind(&FailoverRacer::onExecuterFinished, this, ind, _1, _2, _3));
+    racers_[ind] = Racer { std::unique_ptr<RequestExecuterViaFailover>(executor), failoverUid, std::chrono::steady_clock::now() };
+
+    if (nextInd_ < failovers_.size() && racers_.size() < kMaxParallel)
+        scheduleNext(kStaggerDelayMs);
+
+    // must be the last, the callback may be called synchronously and destroy this object
+    executor->start();
+}
+
+void FailoverRacer::scheduleNext(int delayMs)
+{
+    staggerTimer_.expires_after(std::chrono::milliseconds(delayMs));
+    staggerTimer_.async_wait([this](const boost::system::error_code &ec) {
+        if (!ec)
+            startNext();
+    });
+}
+
+void FailoverRacer::onExecuterFinished(size_t ind, RequestExecuterRetCode retCode, std::unique_ptr<BaseRequest> /*request*/, FailoverData failoverData)
+{
+    auto it = racers_.find(ind);
+    assert(it != racers_.end());
+    std::unique_ptr<RequestExecuterViaFailover> finishedExecutor = std::move(it->second.executor);
+    std::string failoverUid = it->second.failoverUid;
+    auto elapsedMs = utils::since(it->second.startTime).count();
+    racers_.erase(it);
+
+    if (retCode == RequestExecuterRetCode::kSuccess) {
+        failoverStats_.addSuccess(failoverUid, (std::uint32_t)elapsedMs);
+        staggerTimer_.cancel();
+        racers_.clear();
+        callback_(FailoverRacerRetCode::kSuccess, failoverUid, failoverData);
+    } else if (retCode == RequestExecuterRetCode::kConnectStateChanged) {
+        staggerTimer_.cancel();
+        racers_.clear();
+        callback_(FailoverRacerRetCode::kConnectStateChanged, std::string(), FailoverData(""));
+    } else {
+        failoverStats_.addFailure(failoverUid);
+        // do not wait for the stagger delay if a failover has failed
+        if (nextInd_ < failovers_.size())
+            scheduleNext(0);
+        else if (racers_.empty())
+            callback_(FailoverRacerRetCode::kFailed, std::string(), FailoverData(""));
+    }
+}
+
+} // namespace wsnet
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <map>
+#include <boost/asio.hpp>
+#include "WSNetHttpNetworkManager.h"
+#include "WSNetAdvancedParameters.h"
+#include "failover/basefailover.h"
+#include "failedfailovers.h"
+#include "failoverstats.h"
+#include "requestexecuterviafailover.h"
+
+namespace wsnet {
+
+// Helper class used by ServerAPI in the failover racing mode ("happy eyeballs").
+// Probes the failovers with a lightweight idempotent request, up to kMaxParallel at once and with staggered starts.
+// The next failover is also started as soon as a running one fails. The first successful failover wins, the others are canceled.
+
+enum class FailoverRacerRetCode { kSuccess, kFailed, kConnectStateChanged };
+
+typedef std::function<void(FailoverRacerRetCode retCode, const std::string &failoverUid, FailoverData failoverData)> FailoverRacerCallback;
+typedef std::function<void(int ind, const std::string &failoverName)> FailoverRacerStartedCallback;
+
+// Not thread safe
+class FailoverRacer
+{
+public:
+    explicit FailoverRacer(boost::asio::io_context &io_context, WSNetHttpNetworkManager *httpNetworkManager, std::vector<std::unique_ptr<BaseFailover>> failovers,
+                           bool bIgnoreSslErrors, bool isConnectedVpnState, WSNetAdvancedParameters *advancedParameters,
+                           FailedFailovers &failedFailovers, FailoverStats &failoverStats,
+                           FailoverRacerStartedCallback startedCallback, FailoverRacerCallback callback);
+    virtual ~FailoverRacer();
+
+    void start();
+    void setIsConnectedToVpnState(bool isConnected);
+
+private:
+    static constexpr int kMaxParallel = 3;
+    static constexpr int kStaggerDelayMs = 1500;
+
+    WSNetHttpNetworkManager *httpNetworkManager_;
+    WSNetAdvancedParameters *advancedParameters_;
+    FailedFailovers &failedFailovers_;
+    FailoverStats &failoverStats_;
+    FailoverRacerStartedCallback startedCallback_;
+    FailoverRacerCallback callback_;
+    bool bIgnoreSslErrors_;
+    bool isConnectedVpnState_;
+
+    std::vector<std::unique_ptr<BaseFailover>> failovers_;
+    size_t nextInd_ = 0;
+    boost::asio::steady_timer staggerTimer_;
+
+    struct Racer
+    {
+        std::unique_ptr<RequestExecuterViaFailover> executor;
+        std::string failoverUid;
+        std::chrono::steady_clock::time_point startTime;
+    };
+    std::map<size_t, Racer> racers_;     // by index in failovers_
+
+    void startNext();
+    void scheduleNext(int delayMs);
+    void onExecuterFinished(size_t ind, RequestExecuterRetCode retCode, std::unique_ptr<BaseRequest> request, FailoverData failoverData);
+};
+
+} // namespace wsnet
@@ -0,0 +1,55 @@
+#pragma once
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+#include "failover/basefailover.h"
+
+namespace wsnet {
+
+// Helper class used by ServerAPI and FailoverRacer to remember how failovers performed in this session
+// Used to reorder the failovers for the next race: the fastest successful first, then the untried ones, then the failed ones.
+class FailoverStats
+{
+public:
+    void addSuccess(const std::string &failoverUid, std::uint32_t elapsedMs)
+    {
+        auto &stat = stats_[failoverUid];
+        stat.avgMs = stat.isSucceeded ? stat.avgMs + (elapsedMs - stat.avgMs) / 4 : elapsedMs;
+        stat.isSucceeded = true;
+        stat.isLastFailed = false;
+    }
+    void addFailure(const std::string &failoverUid)
+    {
+        stats_[failoverUid].isLastFailed = true;
+    }
+
+    void sort(std::vector<std::unique_ptr<BaseFailover>> &failovers) const
+    {
+        std::stable_sort(failovers.begin(), failovers.end(), [this](const auto &a, const auto &b) {
+            return rank(a->uniqueId()) < rank(b->uniqueId());
+        });
+    }
+
+private:
+    struct Stat
+    {
+        double avgMs = 0;
+        bool isSucceeded = false;
+        bool isLastFailed = false;
+    };
+    std::map<std::string, Stat> stats_;
+
+    double rank(const std::string &failoverUid) const
+    {
+        constexpr double kUntried = 1e9;
+        auto it = stats_.find(failoverUid);
+        if (it == stats_.end())
+            return kUntried;
+        if (it->second.isLastFailed)
+            return kUntried * 2;
+        return it->second.avgMs;
+    }
+};
+
+} // namespace wsnet
@@ -36,7 +36,8 @@ BaseRequest *requests_factory::deleteSession(const std::string &authHash, Reques
 }
 
 BaseRequest *requests_factory::serverLocations(ServerAPISettings &settings, const std::string &language, const std::string &revision, bool isPro, const std::vector<std::string> &alcList,
-                                               ConnectState &connectState, WSNetAdvancedParameters *advancedParameters, RequestFinishedCallback callback)
+                                               ConnectState &connectState, WSNetAdvancedParameters *advancedParameters,
+                                               std::shared_ptr<ServerLocations> records, const std::string &knownPayloadHash, RequestFinishedCallback callback)
 {
     std::map<std::string, std::string> extraParams;
     // generate alc parameter
@@ -46,7 +47,7 @@ BaseRequest *requests_factory::serverLocations(ServerAPISettings &settings, cons
 
     std::string strIsPro = isPro ? "1" : "0";
     return new ServerLocationsRequest(RequestPriority::kNormal, "/serverlist/mob-v2/" + strIsPro + "/" + revision, extraParams, settings,
-                                      connectState, advancedParameters, callback);
+                                      connectState, advancedParameters, records, knownPayloadHash, callback);
 }
 
 BaseRequest *requests_factory::myIP(RequestFinishedCallback callback)
@@ -3,6 +3,7 @@
 #include "serverapi_settings.h"
 #include "connectstate.h"
 #include "WSNetAdvancedParameters.h"
+#include "serverlocations.h"
 
 namespace wsnet {
 
@@ -14,6 +15,7 @@ namespace requests_factory
     BaseRequest *deleteSession(const std::string &authHash, RequestFinishedCallback callback);
     BaseRequest *serverLocations(ServerAPISettings &settings, const std::string &language, const std::string &revision,
                                  bool isPro, const std::vector<std::string> &alcList, ConnectState &connectState, WSNetAdvancedParameters *advancedParameters,
+                                 std::shared_ptr<ServerLocations> records, const std::string &knownPayloadHash,
                                  RequestFinishedCallback callback);
     BaseRequest *serverCredentials(const std::string &authHash, bool isOpenVpnProtocol, RequestFinishedCallback callback);
     BaseRequest *serverConfigs(const std::string &authHash, const std::string &ovpnVersion, RequestFinishedCallback callback);
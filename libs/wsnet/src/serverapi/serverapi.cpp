@@ -12,7 +12,7 @@ ServerAPI::ServerAPI(boost::asio::io_context &io_context, WSNetHttpNetworkManage
     advancedParameters_(advancedParameters),
     connectState_(connectState)
 {
-    impl_ = std::make_unique<ServerAPI_impl>(httpNetworkManager, failoverContainer, settings_, advancedParameters, connectState);
+    impl_ = std::make_unique<ServerAPI_impl>(io_context, httpNetworkManager, failoverContainer, settings_, advancedParameters, connectState);
     subscriberId_ = connectState_.subscribeConnectedToVpnState(std::bind(&ServerAPI::onVPNConnectStateChanged, this, std::placeholders::_1));
 }
 
@@ -82,7 +82,22 @@ std::shared_ptr<WSNetCancelableCallback> ServerAPI::serverLocations(const std::s
 {
     auto cancelableCallback = std::make_shared<CancelableCallback<WSNetRequestFinishedCallback>>(callback);
     BaseRequest *request = requests_factory::serverLocations(settings_, language, revision, isPro, alcList,
-                                                             connectState_, advancedParameters_, cancelableCallback);
+                                                             connectState_, advancedParameters_, nullptr, std::string(), cancelableCallback);
+    boost::asio::post(io_context_, [this, request] { impl_->executeRequest(std::unique_ptr<BaseRequest>(request)); });
+    return cancelableCallback;
+}
+
+std::shared_ptr<WSNetCancelableCallback> ServerAPI::serverLocationsRecords(const std::string &language, const std::string &revision, bool isPro, const std::vector<std::string> &alcList,
+                                                                          const std::string &knownPayloadHash, WSNetServerLocationsCallback callback)
+{
+    // the request fills the records, the callback hands them over instead of the json
+    auto records = std::make_shared<ServerLocations>();
+    auto cancelableCallback = std::make_shared<CancelableCallback<WSNetRequestFinishedCallback>>(
+        [callback, records](ServerApiRetCode serverApiRetCode, const std::string &) {
+            callback(serverApiRetCode, records);
+        });
+    BaseRequest *request = requests_factory::serverLocations(settings_, language, revision, isPro, alcList,
+                                                             connectState_, advancedParameters_, records, knownPayloadHash, cancelableCallback);
     boost::asio::post(io_context_, [this, request] { impl_->executeRequest(std::unique_ptr<BaseRequest>(request)); });
     return cancelableCallback;
 }
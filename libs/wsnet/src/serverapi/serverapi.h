@@ -32,6 +32,10 @@ public:
     std::shared_ptr<WSNetCancelableCallback> serverLocations(const std::string &language, const std::string &revision,
                                                                      bool isPro, const std::vector<std::string> &alcList,
                                                                      WSNetRequestFinishedCallback callback) override;
+    std::shared_ptr<WSNetCancelableCallback> serverLocationsRecords(const std::string &language, const std::string &revision,
+                                                                    bool isPro, const std::vector<std::string> &alcList,
+                                                                    const std::string &knownPayloadHash,
+                                                                    WSNetServerLocationsCallback callback) override;
     std::shared_ptr<WSNetCancelableCallback> serverCredentials(const std::string &authHash, bool isOpenVpnProtocol, WSNetRequestFinishedCallback callback) override;
     std::shared_ptr<WSNetCancelableCallback> serverConfigs(const std::string &authHash, const std::string &ovpnVersion, WSNetRequestFinishedCallback callback) override;
 
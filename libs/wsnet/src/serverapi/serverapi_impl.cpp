@@ -5,8 +5,9 @@
 
 namespace wsnet {
 
-ServerAPI_impl::ServerAPI_impl(WSNetHttpNetworkManager *httpNetworkManager, IFailoverContainer *failoverContainer, ServerAPISettings &settings,
-                               WSNetAdvancedParameters *advancedParameters, ConnectState &connectState) :
+ServerAPI_impl::ServerAPI_impl(boost::asio::io_context &io_context, WSNetHttpNetworkManager *httpNetworkManager, IFailoverContainer *failoverContainer,
+                               ServerAPISettings &settings, WSNetAdvancedParameters *advancedParameters, ConnectState &connectState) :
+    io_context_(io_context),
     httpNetworkManager_(httpNetworkManager),
     advancedParameters_(advancedParameters),
     connectState_(connectState),
@@ -77,6 +78,8 @@ void ServerAPI_impl::setIsConnectedToVpnState(bool isConnected)
     isConnectedToVpn_ = isConnected;
     if (requestExecutorViaFailover_)
         requestExecutorViaFailover_->setIsConnectedToVpnState(isConnected);
+    if (failoverRacer_)
+        failoverRacer_->setIsConnectedToVpnState(isConnected);
 }
 
 void ServerAPI_impl::setTryingBackupEndpointCallback(std::shared_ptr<CancelableCallback<WSNetTryingBackupEndpointCallback> > tryingBackupEndpointCallback)
@@ -108,7 +111,7 @@ void ServerAPI_impl::executeRequest(std::unique_ptr<BaseRequest> request)
     }
 
     // if failover already in progress then move the request to queue
-    if (requestExecutorViaFailover_) {
+    if (requestExecutorViaFailover_ || failoverRacer_) {
         // take into account priority
         // in particular, wgConfigsInit, wgConfigsConnect and pingTest should have a higher priority in the queue to avoid potential connection delays
         if (request->priority() == RequestPriority::kHigh)
@@ -138,7 +141,11 @@ void ServerAPI_impl::executeRequest(std::unique_ptr<BaseRequest> request)
             }
         }
 
-        if (bUseFailover) {
+        // the failover from the settings most likely works, so try it alone first
+        if (bUseFailover && failoverState_ == FailoverState::kUnknown && advancedParameters_->isAPIFailoverRacing() && failoverContainer_->count() > 1) {
+            queueRequests_.push_back(std::move(request));
+            startFailoverRacing();
+        } else if (bUseFailover) {
             auto curFailover = failoverContainer_->failoverById(curFailoverUid_);
             spdlog::info("Trying: {}", curFailover->name());
 
@@ -199,6 +206,45 @@ void ServerAPI_impl::setErrorCodeAndEmitRequestFinished(BaseRequest *request, Se
     request->callCallback();
 }
 
+void ServerAPI_impl::startFailoverRacing()
+{
+    assert(failoverRacer_ == nullptr);
+    std::vector<std::unique_ptr<BaseFailover>> failovers;
+    for (auto failover = failoverContainer_->first(); failover; failover = failoverContainer_->next(failovers.back()->uniqueId()))
+        failovers.push_back(std::move(failover));
+    // the fastest failovers of the previous races first
+    failoverStats_.sort(failovers);
+
+    using namespace std::placeholders;
+    int count = (int)failovers.size();
+    failoverRacer_.reset(new FailoverRacer(io_context_, httpNetworkManager_, std::move(failovers), bIgnoreSslErrors_, isConnectedToVpn_, advancedParameters_,
+                                           failedFailovers_, failoverStats_,
+                                           [this, count](int ind, const std::string &) {
+                                               if (ind > 0 && tryingBackupEndpointCallback_)
+                                                   tryingBackupEndpointCallback_->call(ind, count - 1);
+                                           },
+                                           std::bind(&ServerAPI_impl::onFailoverRacerFinished, this, _1, _2, _3)));
+    failoverRacer_->start();
+}
+
+void ServerAPI_impl::onFailoverRacerFinished(FailoverRacerRetCode retCode, const std::string &failoverUid, FailoverData failoverData)
+{
+    std::unique_ptr<FailoverRacer> failoverRacerCopy = std::move(failoverRacer_);
+    failoverRacer_.reset();
+
+    if (retCode == FailoverRacerRetCode::kSuccess) {
+        curFailoverUid_ = failoverUid;
+        failoverContainer_->failoverById(failoverUid, &curFailoverInd_);
+        failoverState_ = FailoverState::kReady;
+        failoverData_ = failoverData;
+        settings_.setFailovedId(curFailoverUid_);
+    } else if (retCode == FailoverRacerRetCode::kFailed) {
+        failoverState_ = FailoverState::kFailed;
+    }
+    // in the kConnectStateChanged case the queued requests are repeated in the new state
+    executeWaitingInQueueRequests();
+}
+
 void ServerAPI_impl::onRequestExecuterViaFailoverFinished(RequestExecuterRetCode retCode, std::unique_ptr<BaseRequest> request, FailoverData failoverData)
 {
     assert(failoverState_ == FailoverState::kUnknown || failoverState_ == FailoverState::kFromSettingsUnknown);
@@ -17,13 +17,15 @@
 #include "serverapi_settings.h"
 #include "connectstate.h"
 #include "failedfailovers.h"
+#include "failoverracer.h"
+#include "failoverstats.h"
 
 namespace wsnet {
 
 class ServerAPI_impl
 {
 public:
-    explicit ServerAPI_impl(WSNetHttpNetworkManager *httpNetworkManager, IFailoverContainer *failoverContainer,
+    explicit ServerAPI_impl(boost::asio::io_context &io_context, WSNetHttpNetworkManager *httpNetworkManager, IFailoverContainer *failoverContainer,
                             ServerAPISettings &settings, WSNetAdvancedParameters *advancedParameters, ConnectState &connectState);
     virtual ~ServerAPI_impl();
 
@@ -36,6 +38,7 @@ public:
     void executeRequest(std::unique_ptr<BaseRequest> request);
 
 private:
+    boost::asio::io_context &io_context_;
     WSNetHttpNetworkManager *httpNetworkManager_;
     WSNetAdvancedParameters *advancedParameters_;
     ConnectState &connectState_;
@@ -72,6 +75,9 @@ private:
     std::optional<FailoverData> failoverData_;      // valid only in kReady/kFromSettingsReady states
     bool isFailoverFailedLogAlreadyDone_ = false;   // log "failover failed: API not ready" only once to avoid spam
     FailedFailovers failedFailovers_;
+    // the failover racing mode, see WSNetAdvancedParameters::setAPIFailoverRacing
+    std::unique_ptr<FailoverRacer> failoverRacer_;
+    FailoverStats failoverStats_;
 
     void executeRequest(std::uint64_t requestId);
     void executeRequestImpl(std::unique_ptr<BaseRequest> request, const FailoverData &failoverData);
@@ -79,6 +85,8 @@ private:
     std::string hostnameForConnectedState() const;
     void setErrorCodeAndEmitRequestFinished(BaseRequest *request, ServerApiRetCode retCode);
 
+    void startFailoverRacing();
+    void onFailoverRacerFinished(FailoverRacerRetCode retCode, const std::string &failoverUid, FailoverData failoverData);
     void onRequestExecuterViaFailoverFinished(RequestExecuterRetCode retCode, std::unique_ptr<BaseRequest> request, FailoverData failoverData);
 
     void onHttpNetworkRequestFinished(std::uint64_t requestId, std::uint32_t elapsedMs, NetworkError errCode, const std::string &data);
@@ -38,6 +38,9 @@ std::shared_ptr<WSNetHttpRequest> serverapi_utils::createHttpRequestWithFailover
     if (!failoverData.sniDomain().empty())
         httpRequest->setSniDomain(failoverData.sniDomain());
 
+    // API requests are often executed in bursts to the same host, so reuse connections and TLS sessions between them
+    httpRequest->setUseConnectionPool(true);
+
     return httpRequest;
 }
 
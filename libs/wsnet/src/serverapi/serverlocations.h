@@ -0,0 +1,112 @@
+#pragma once
+
+#include "WSNetServerLocations.h"
+
+namespace wsnet {
+
+// The records are filled by ServerLocationsParser
+class ServerNode : public WSNetServerNode
+{
+public:
+    std::string ip() const override { return ip_; }
+    std::string ip2() const override { return ip2_; }
+    std::string ip3() const override { return ip3_; }
+    std::string hostname() const override { return hostname_; }
+    std::int32_t weight() const override { return weight_; }
+
+private:
+    friend class ServerLocationsParser;
+    std::string ip_;
+    std::string ip2_;
+    std::string ip3_;
+    std::string hostname_;
+    std::int32_t weight_ = 0;
+    std::int32_t forceDisconnect_ = 0;
+};
+
+class ServerGroup : public WSNetServerGroup
+{
+public:
+    std::int32_t id() const override { return id_; }
+    std::string city() const override { return city_; }
+    std::string nick() const override { return nick_; }
+    std::int32_t pro() const override { return pro_; }
+    std::string pingIp() const override { return pingIp_; }
+    std::string pingHost() const override { return pingHost_; }
+    std::string wgPubKey() const override { return wgPubKey_; }
+    std::string ovpnX509() const override { return ovpnX509_; }
+    std::int32_t linkSpeed() const override { return linkSpeed_; }
+    std::int32_t health() const override { return health_; }
+    std::vector<std::shared_ptr<WSNetServerNode>> nodes() const override { return nodes_; }
+
+private:
+    friend class ServerLocationsParser;
+    std::int32_t id_ = 0;
+    std::string city_;
+    std::string nick_;
+    std::int32_t pro_ = 0;
+    std::string pingIp_;
+    std::string pingHost_;
+    std::string wgPubKey_;
+    std::string ovpnX509_;
+    std::int32_t linkSpeed_ = 100;
+    std::int32_t health_ = -1;
+    std::vector<std::shared_ptr<WSNetServerNode>> nodes_;
+};
+
+class ServerLocation : public WSNetServerLocation
+{
+public:
+    std::int32_t id() const override { return id_; }
+    std::string name() const override { return name_; }
+    std::string countryCode() const override { return countryCode_; }
+    std::int32_t premiumOnly() const override { return premiumOnly_; }
+    std::int32_t p2p() const override { return p2p_; }
+    std::string dnsHostName() const override { return dnsHostName_; }
+    std::vector<std::shared_ptr<WSNetServerGroup>> groups() const override { return groups_; }
+
+private:
+    friend class ServerLocationsParser;
+    std::int32_t id_ = 0;
+    std::string name_;
+    std::string countryCode_;
+    std::int32_t premiumOnly_ = 0;
+    std::int32_t p2p_ = 0;
+    std::string dnsHostName_;
+    std::vector<std::shared_ptr<WSNetServerGroup>> groups_;
+};
+
+class ServerLocations : public WSNetServerLocations
+{
+public:
+    std::string payloadHash() const override { return payloadHash_; }
+    bool isUnchanged() const override { return isUnchanged_; }
+    std::string countryOverride() const override { return countryOverride_; }
+    std::vector<std::shared_ptr<WSNetServerLocation>> locations() const override { return locations_; }
+    std::vector<std::string> forceDisconnectNodes() const override { return forceDisconnectNodes_; }
+
+    void setPayloadHash(const std::string &payloadHash, bool isUnchanged)
+    {
+        payloadHash_ = payloadHash;
+        isUnchanged_ = isUnchanged;
+    }
+
+    void clear()
+    {
+        payloadHash_.clear();
+        isUnchanged_ = false;
+        countryOverride_.clear();
+        locations_.clear();
+        forceDisconnectNodes_.clear();
+    }
+
+private:
+    friend class ServerLocationsParser;
+    std::string payloadHash_;
+    bool isUnchanged_ = false;
+    std::string countryOverride_;
+    std::vector<std::shared_ptr<WSNetServerLocation>> locations_;
+    std::vector<std::string> forceDisconnectNodes_;
+};
+
+} // namespace wsnet
@@ -0,0 +1,156 @@
+// Benchmark of the serverlist parsing: the streaming ServerLocationsParser against a rapidjson DOM parse of the same payload.
+// Usage: wsnet_serverlocations_bench [serverlist.json] [iterations]
+// Without a file, a synthetic serverlist of the production size is generated.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <rapidjson/document.h>
+#include "serverlocations_parser.h"
+
+namespace {
+
+// track the heap usage to report the peak memory of each parse
+std::size_t g_curBytes = 0;
+std::size_t g_peakBytes = 0;
+std::size_t g_allocations = 0;
+
+// routes the rapidjson DOM allocations through the tracked operator new
+class TrackingAllocator
+{
+public:
+    static const bool kNeedFree = true;
+    void *Malloc(size_t size) { return size ? ::operator new(size) : nullptr; }
+    void *Realloc(void *originalPtr, size_t originalSize, size_t newSize)
+    {
+        void *p = Malloc(newSize);
+        if (originalPtr) {
+            std::memcpy(p, originalPtr, std::min(originalSize, newSize));
+            Free(originalPtr);
+        }
+        return p;
+    }
+    static void Free(void *ptr) { ::operator delete(ptr); }
+    bool operator==(const TrackingAllocator &) const { return true; }
+    bool operator!=(const TrackingAllocator &) const { return false; }
+};
+
+void resetHeapStats()
+{
+    g_peakBytes = g_curBytes;
+    g_allocations = 0;
+}
+
+std::string generateServerList(int locationsCount, int groupsCount, int nodesCount)
+{
+    std::ostringstream ss;
+    ss << "{\"info\":{\"revision\":1,\"country_override\":\"CA\"},\"data\":[";
+    for (int l = 0; l < locationsCount; ++l) {
+        ss << (l ? "," : "") << "{\"id\":" << l << ",\"name\":\"Location " << l << "\",\"country_code\":\"C" << l % 10
+           << "\",\"status\":1,\"premium_only\":" << l % 2 << ",\"short_name\":\"L" << l << "\",\"p2p\":1,\"tz\":\"America/Toronto\""
+           << ",\"tz_offset\":\"-5,EST\",\"loc_type\":\"normal\",\"dns_hostname\":\"dns" << l << ".example.com\",\"groups\":[";
+        for (int g = 0; g < groupsCount; ++g) {
+            ss << (g ? "," : "") << "{\"id\":" << l * 100 + g << ",\"city\":\"City " << g << "\",\"nick\":\"Nick " << g
+               << "\",\"pro\":" << g % 2 << ",\"gps\":\"43.65,-79.38\",\"tz\":\"America/Toronto\",\"wg_pubkey\":\"Y2VydGlmaWNhdGVwdWJsaWNrZXlmb3J3aXJlZ3VhcmQ=\""
+               << ",\"wg_endpoint\":\"wg" << g << ".example.com\",\"ovpn_x509\":\"ovpn" << g << ".example.com\",\"ping_ip\":\"10.0." << l % 256 << "." << g
+               << "\",\"ping_host\":\"https://ping" << g << ".example.com:6363/latency\",\"link_speed\":\"10000\",\"health\":" << (l + g) % 100 << ",\"nodes\":[";
+            for (int n = 0; n < nodesCount; ++n) {
+                ss << (n ? "," : "") << "{\"ip\":\"10.1." << g << "." << n << "\",\"ip2\":\"10.2." << g << "." << n << "\",\"ip3\":\"10.3." << g << "." << n
+                   << "\",\"hostname\":\"node" << l << "-" << g << "-" << n << ".example.com\",\"weight\":1,\"health\":" << n * 7 % 100 << "}";
+            }
+            ss << "]}";
+        }
+        ss << "]}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+template<typename Func>
+void runBenchmark(const char *name, int iterations, Func func)
+{
+    std::size_t peak = 0, allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::size_t base = g_curBytes;
+        resetHeapStats();
+        func();
+        peak = std::max(peak, g_peakBytes - base);
+        allocations = g_allocations;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    printf("%-30s %10.2f ms/parse  peak heap %8zu KB  %8zu allocations\n", name, elapsed / 1000.0 / iterations, peak / 1024, allocations);
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    std::size_t *p = (std::size_t *)std::malloc(size + sizeof(std::max_align_t));
+    if (!p)
+        throw std::bad_alloc();
+    *p = size;
+    g_curBytes += size;
+    g_peakBytes = std::max(g_peakBytes, g_curBytes);
+    g_allocations++;
+    return (char *)p + sizeof(std::max_align_t);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    std::size_t *p = (std::size_t *)((char *)ptr - sizeof(std::max_align_t));
+    g_curBytes -= *p;
+    std::free(p);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string json;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            printf("Failed to open %s\n", argv[1]);
+            return 1;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        json = buffer.str();
+    } else {
+        json = generateServerList(150, 8, 6);
+    }
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    wsnet::ServerLocations check;
+    if (!wsnet::ServerLocationsParser(&check).parse(json)) {
+        printf("Incorrect serverlist json\n");
+        return 1;
+    }
+    printf("Payload %zu KB, %zu locations, %d iterations\n", json.size() / 1024, check.locations().size(), iterations);
+
+    // the DOM parse is what the serverlist used to go through, before the client parsed it again with QJsonDocument
+    runBenchmark("rapidjson DOM", iterations, [&json] {
+        rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<TrackingAllocator>, TrackingAllocator> doc;
+        doc.Parse(json.c_str());
+    });
+    runBenchmark("SAX records", iterations, [&json] {
+        wsnet::ServerLocations locations;
+        wsnet::ServerLocationsParser(&locations).parse(json);
+    });
+    runBenchmark("SAX validate only", iterations, [&json] {
+        wsnet::ServerLocationsParser(nullptr).parse(json);
+    });
+    return 0;
+}
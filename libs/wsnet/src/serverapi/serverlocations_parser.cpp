@@ -0,0 +1,345 @@
+#include "serverlocations_parser.h"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace wsnet {
+
+namespace {
+
+constexpr std::uint32_t bit(int field) { return 1u << field; }
+
+// same semantic as QJsonValue::toString()
+std::string toString(const std::string_view *str)
+{
+    return str ? std::string(*str) : std::string();
+}
+
+// same semantic as QJsonValue::toInt(), the number must be integral and fit into int32
+std::int32_t toInt(const double *number, std::int32_t defaultValue = 0)
+{
+    if (number && std::trunc(*number) == *number &&
+        *number >= std::numeric_limits<std::int32_t>::min() && *number <= std::numeric_limits<std::int32_t>::max()) {
+        return (std::int32_t)*number;
+    }
+    return defaultValue;
+}
+
+// same semantic as QString::toInt()
+bool stringToInt(std::string_view str, std::int32_t &out)
+{
+    while (!str.empty() && std::isspace((unsigned char)str.front()))
+        str.remove_prefix(1);
+    while (!str.empty() && std::isspace((unsigned char)str.back()))
+        str.remove_suffix(1);
+    if (!str.empty() && str.front() == '+')
+        str.remove_prefix(1);
+    if (str.empty())
+        return false;
+    auto res = std::from_chars(str.data(), str.data() + str.size(), out);
+    return res.ec == std::errc() && res.ptr == str.data() + str.size();
+}
+
+} // namespace
+
+ServerLocationsParser::ServerLocationsParser(ServerLocations *locations) : locations_(locations)
+{
+    stack_.reserve(8);
+}
+
+bool ServerLocationsParser::parse(const std::string &json)
+{
+    rapidjson::Reader reader;
+    rapidjson::StringStream ss(json.c_str());
+    return !reader.Parse(ss, *this).IsError() && isRootObject_;
+}
+
+ServerLocationsParser::Field ServerLocationsParser::fieldForKey(std::string_view key) const
+{
+    switch (context()) {
+    case Context::kRoot:
+        if (key == "errorCode") return kErrorCode;
+        if (key == "data") return kData;
+        if (key == "info") return kInfo;
+        break;
+    case Context::kInfo:
+        if (key == "country_override") return kCountryOverride;
+        break;
+    case Context::kLocation:
+        if (key == "id") return kId;
+        if (key == "name") return kName;
+        if (key == "country_code") return kCountryCode;
+        if (key == "premium_only") return kPremiumOnly;
+        if (key == "p2p") return kP2p;
+        if (key == "dns_hostname") return kDnsHostname;
+        if (key == "groups") return kGroups;
+        break;
+    case Context::kGroup:
+        if (key == "id") return kId;
+        if (key == "city") return kCity;
+        if (key == "nick") return kNick;
+        if (key == "pro") return kPro;
+        if (key == "ping_ip") return kPingIp;
+        if (key == "ping_host") return kPingHost;
+        if (key == "wg_pubkey") return kWgPubKey;
+        if (key == "ovpn_x509") return kOvpnX509;
+        if (key == "link_speed") return kLinkSpeed;
+        if (key == "health") return kHealth;
+        if (key == "nodes") return kNodes;
+        break;
+    case Context::kNode:
+        if (key == "ip") return kIp;
+        if (key == "ip2") return kIp2;
+        if (key == "ip3") return kIp3;
+        if (key == "hostname") return kHostname;
+        if (key == "weight") return kWeight;
+        if (key == "force_disconnect") return kForceDisconnect;
+        break;
+    default:
+        break;
+    }
+    return kNone;
+}
+
+bool ServerLocationsParser::Key(const char *str, rapidjson::SizeType length, bool)
+{
+    field_ = fieldForKey(std::string_view(str, length));
+    switch (context()) {
+    case Context::kRoot:
+        if (field_ == kErrorCode)
+            hasErrorCode_ = true;
+        else if (field_ == kData)
+            hasData_ = true;
+        break;
+    case Context::kLocation:
+        locationKeys_ |= bit(field_);
+        break;
+    case Context::kGroup:
+        groupKeys_ |= bit(field_);
+        break;
+    case Context::kNode:
+        nodeKeys_ |= bit(field_);
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+bool ServerLocationsParser::String(const char *str, rapidjson::SizeType length, bool)
+{
+    std::string_view s(str, length);
+    return onValue(&s, nullptr);
+}
+
+bool ServerLocationsParser::onValue(const std::string_view *str, const double *number)
+{
+    switch (context()) {
+    case Context::kInfo:
+        if (field_ == kCountryOverride && str) {
+            hasCountryOverride_ = true;
+            countryOverride_ = *str;
+        }
+        break;
+    case Context::kGroups:
+    case Context::kNodes:
+        onInvalidElement();
+        break;
+    case Context::kLocation:
+        switch (field_) {
+        case kId: location_->id_ = toInt(number); break;
+        case kName: location_->name_ = toString(str); break;
+        case kCountryCode: location_->countryCode_ = toString(str); break;
+        case kPremiumOnly: location_->premiumOnly_ = toInt(number); break;
+        case kP2p: location_->p2p_ = toInt(number); break;
+        case kDnsHostname: location_->dnsHostName_ = toString(str); break;
+        default: break;
+        }
+        break;
+    case Context::kGroup:
+        switch (field_) {
+        case kId: group_->id_ = toInt(number); break;
+        case kCity: group_->city_ = toString(str); break;
+        case kNick: group_->nick_ = toString(str); break;
+        case kPro: group_->pro_ = toInt(number); break;
+        case kPingIp: group_->pingIp_ = toString(str); break;
+        case kPingHost: group_->pingHost_ = toString(str); break;
+        case kWgPubKey: group_->wgPubKey_ = toString(str); break;
+        case kOvpnX509: group_->ovpnX509_ = toString(str); break;
+        case kLinkSpeed:
+            if (!str || !stringToInt(*str, group_->linkSpeed_))
+                group_->linkSpeed_ = 100;
+            break;
+        case kHealth:
+            // -1 indicates to the UI logic that the load value is invalid/missing
+            group_->health_ = toInt(number, -1);
+            if (group_->health_ < 0 || group_->health_ > 100)
+                group_->health_ = -1;
+            break;
+        default: break;
+        }
+        break;
+    case Context::kNode:
+        switch (field_) {
+        case kIp: node_->ip_ = toString(str); break;
+        case kIp2: node_->ip2_ = toString(str); break;
+        case kIp3: node_->ip3_ = toString(str); break;
+        case kHostname: node_->hostname_ = toString(str); break;
+        case kWeight: node_->weight_ = toInt(number); break;
+        case kForceDisconnect: node_->forceDisconnect_ = toInt(number); break;
+        default: break;
+        }
+        break;
+    default:
+        break;
+    }
+    field_ = kNone;
+    return true;
+}
+
+// a non-object element in the groups or nodes array is an invalid group or node
+void ServerLocationsParser::onInvalidElement()
+{
+    if (context() == Context::kGroups)
+        isLocationInvalid_ = true;
+    else if (context() == Context::kNodes)
+        isGroupInvalid_ = true;
+}
+
+bool ServerLocationsParser::StartObject()
+{
+    Context next = Context::kSkip;
+    if (stack_.empty()) {
+        isRootObject_ = true;
+        next = Context::kRoot;
+    } else {
+        switch (context()) {
+        case Context::kRoot:
+            if (field_ == kInfo) {
+                hasInfo_ = true;
+                next = Context::kInfo;
+            }
+            break;
+        case Context::kData:
+            location_ = std::make_shared<ServerLocation>();
+            locationKeys_ = 0;
+            isLocationInvalid_ = false;
+            locationForceDisconnectNodes_.clear();
+            next = Context::kLocation;
+            break;
+        case Context::kGroups:
+            // the groups after an invalid one are not parsed
+            if (!isLocationInvalid_) {
+                group_ = std::make_shared<ServerGroup>();
+                groupKeys_ = 0;
+                isGroupInvalid_ = false;
+                groupForceDisconnectNodes_.clear();
+                next = Context::kGroup;
+            }
+            break;
+        case Context::kNodes:
+            if (!isGroupInvalid_) {
+                node_ = std::make_shared<ServerNode>();
+                nodeKeys_ = 0;
+                next = Context::kNode;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    stack_.push_back(next);
+    field_ = kNone;
+    return true;
+}
+
+bool ServerLocationsParser::StartArray()
+{
+    Context next = Context::kSkip;
+    switch (context()) {
+    case Context::kRoot:
+        if (field_ == kData && locations_)
+            next = Context::kData;
+        break;
+    case Context::kGroups:
+    case Context::kNodes:
+        onInvalidElement();
+        break;
+    case Context::kLocation:
+        if (field_ == kGroups)
+            next = Context::kGroups;
+        break;
+    case Context::kGroup:
+        if (field_ == kNodes)
+            next = Context::kNodes;
+        break;
+    default:
+        break;
+    }
+    stack_.push_back(next);
+    field_ = kNone;
+    return true;
+}
+
+bool ServerLocationsParser::EndObject(rapidjson::SizeType)
+{
+    static constexpr std::uint32_t kLocationRequiredKeys = bit(kId) | bit(kName) | bit(kCountryCode) | bit(kPremiumOnly) | bit(kP2p) | bit(kGroups);
+    static constexpr std::uint32_t kGroupRequiredKeys = bit(kId) | bit(kCity) | bit(kNick) | bit(kPro) | bit(kPingIp) | bit(kWgPubKey);
+    static constexpr std::uint32_t kNodeRequiredKeys = bit(kIp) | bit(kIp2) | bit(kIp3) | bit(kHostname) | bit(kWeight);
+
+    Context cur = context();
+    stack_.pop_back();
+    switch (cur) {
+    case Context::kNode:
+        if ((nodeKeys_ & kNodeRequiredKeys) != kNodeRequiredKeys) {
+            isGroupInvalid_ = true;
+        } else if (node_->forceDisconnect_ == 1) {
+            // not add node with flag force_disconnect, but add it to another list
+            groupForceDisconnectNodes_.push_back(node_->hostname_);
+        } else {
+            group_->nodes_.push_back(std::move(node_));
+        }
+        node_.reset();
+        break;
+    case Context::kGroup:
+        if ((groupKeys_ & kGroupRequiredKeys) != kGroupRequiredKeys) {
+            isLocationInvalid_ = true;
+        } else {
+            locationForceDisconnectNodes_.insert(locationForceDisconnectNodes_.end(), groupForceDisconnectNodes_.begin(), groupForceDisconnectNodes_.end());
+            if (isGroupInvalid_)
+                isLocationInvalid_ = true;
+            else
+                location_->groups_.push_back(std::move(group_));
+        }
+        group_.reset();
+        break;
+    case Context::kLocation:
+        if ((locationKeys_ & kLocationRequiredKeys) == kLocationRequiredKeys) {
+            auto &forceDisconnectNodes = locations_->forceDisconnectNodes_;
+            forceDisconnectNodes.insert(forceDisconnectNodes.end(), locationForceDisconnectNodes_.begin(), locationForceDisconnectNodes_.end());
+            if (!isLocationInvalid_)
+                locations_->locations_.push_back(std::move(location_));
+        }
+        location_.reset();
+        break;
+    case Context::kRoot:
+        if (locations_) {
+            locations_->countryOverride_ = countryOverride_;
+        }
+        break;
+    default:
+        break;
+    }
+    field_ = kNone;
+    return true;
+}
+
+bool ServerLocationsParser::EndArray(rapidjson::SizeType)
+{
+    stack_.pop_back();
+    field_ = kNone;
+    return true;
+}
+
+} // namespace wsnet
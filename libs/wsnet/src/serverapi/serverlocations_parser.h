@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <rapidjson/reader.h>
+#include "serverlocations.h"
+
+namespace wsnet {
+
+// SAX handler for the serverlist, the payload is large so we do not build a DOM for it.
+// Builds the location/group/node records while streaming, following the same validation rules the client used for the DOM:
+// a location, group or node with missing required keys is invalid, an invalid node invalidates its group and an invalid group its location.
+// If locations is null, only the top-level fields and info.country_override are collected and the data array is skipped.
+class ServerLocationsParser : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ServerLocationsParser>
+{
+public:
+    explicit ServerLocationsParser(ServerLocations *locations);
+
+    // returns false if the payload is not a valid json object
+    bool parse(const std::string &json);
+
+    bool hasErrorCode() const { return hasErrorCode_; }
+    bool hasData() const { return hasData_; }
+    bool hasInfo() const { return hasInfo_; }
+    bool hasCountryOverride() const { return hasCountryOverride_; }
+    std::string countryOverride() const { return countryOverride_; }
+
+    // rapidjson SAX interface
+    bool Null() { return onValue(nullptr, nullptr); }
+    bool Bool(bool) { return onValue(nullptr, nullptr); }
+    bool Int(int i) { return onNumber(i); }
+    bool Uint(unsigned u) { return onNumber(u); }
+    bool Int64(int64_t i) { return onNumber((double)i); }
+    bool Uint64(uint64_t u) { return onNumber((double)u); }
+    bool Double(double d) { return onNumber(d); }
+    bool String(const char *str, rapidjson::SizeType length, bool);
+    bool StartObject();
+    bool Key(const char *str, rapidjson::SizeType length, bool);
+    bool EndObject(rapidjson::SizeType);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType);
+
+private:
+    enum class Context { kRoot, kInfo, kData, kLocation, kGroups, kGroup, kNodes, kNode, kSkip };
+    enum Field { kNone, kErrorCode, kData, kInfo, kCountryOverride,
+                 kId, kName, kCountryCode, kPremiumOnly, kP2p, kDnsHostname, kGroups,
+                 kCity, kNick, kPro, kPingIp, kPingHost, kWgPubKey, kOvpnX509, kLinkSpeed, kHealth, kNodes,
+                 kIp, kIp2, kIp3, kHostname, kWeight, kForceDisconnect };
+
+    ServerLocations *locations_;
+    std::vector<Context> stack_;
+    Field field_ = kNone;
+
+    bool isRootObject_ = false;
+    bool hasErrorCode_ = false;
+    bool hasData_ = false;
+    bool hasInfo_ = false;
+    bool hasCountryOverride_ = false;
+    std::string countryOverride_;
+
+    // the records under construction, the key masks track the required keys seen so far
+    std::shared_ptr<ServerLocation> location_;
+    std::shared_ptr<ServerGroup> group_;
+    std::shared_ptr<ServerNode> node_;
+    std::uint32_t locationKeys_ = 0;
+    std::uint32_t groupKeys_ = 0;
+    std::uint32_t nodeKeys_ = 0;
+    // once a group (node) is invalid, the rest of the location (group) is ignored
+    bool isLocationInvalid_ = false;
+    bool isGroupInvalid_ = false;
+    // the force disconnect hostnames are accepted only if the enclosing group and location have their required keys
+    std::vector<std::string> locationForceDisconnectNodes_;
+    std::vector<std::string> groupForceDisconnectNodes_;
+
+    Context context() const { return stack_.empty() ? Context::kSkip : stack_.back(); }
+    Field fieldForKey(std::string_view key) const;
+    bool onNumber(double number) { return onValue(nullptr, &number); }
+    bool onValue(const std::string_view *str, const double *number);
+    void onInvalidElement();
+};
+
+} // namespace wsnet
@@ -1,17 +1,21 @@
 #include "serverlocations_request.h"
 #include <skyr/url.hpp>
 #include <spdlog/spdlog.h>
-#include <rapidjson/document.h>
+#include "serverlocations_parser.h"
+#include "utils/crypto_utils.h"
 
 namespace wsnet {
 
 ServerLocationsRequest::ServerLocationsRequest(RequestPriority priority, const std::string &name,
         std::map<std::string, std::string> extraParams, ServerAPISettings &settings,
-        ConnectState &connectState, WSNetAdvancedParameters *advancedParameters, RequestFinishedCallback callback) :
+        ConnectState &connectState, WSNetAdvancedParameters *advancedParameters,
+        std::shared_ptr<ServerLocations> records, const std::string &knownPayloadHash, RequestFinishedCallback callback) :
     BaseRequest(HttpMethod::kGet, SubdomainType::kAssets, priority, name, extraParams, callback),
     settings_(settings),
     connectState_(connectState),
-    advancedParameters_(advancedParameters)
+    advancedParameters_(advancedParameters),
+    records_(records),
+    knownPayloadHash_(knownPayloadHash)
 {
 }
 
@@ -52,39 +56,42 @@ std::string ServerLocationsRequest::url(const std::string &domain) const
 void ServerLocationsRequest::handle(const std::string &arr)
 {
     if (arr.empty()) {
-        setRetCode(ServerApiRetCode::kIncorrectJson);
+        setIncorrectJson();
         return;
     }
 
     if (!isIgnoreJsonParse_) {
-        using namespace rapidjson;
-        Document doc;
-        doc.Parse(arr.c_str());
-        if (doc.HasParseError() || !doc.IsObject()) {
-            setRetCode(ServerApiRetCode::kIncorrectJson);
+        // an unchanged payload is still validated for the country override logic, but the records are not built
+        bool isUnchanged = false;
+        if (records_) {
+            records_->clear();
+            std::string payloadHash = crypto_utils::sha1(arr);
+            isUnchanged = !knownPayloadHash_.empty() && payloadHash == knownPayloadHash_;
+            records_->setPayloadHash(payloadHash, isUnchanged);
+        }
+
+        ServerLocationsParser handler(isUnchanged ? nullptr : records_.get());
+        if (!handler.parse(arr)) {
+            setIncorrectJson();
             return;
         }
-        auto jsonObject = doc.GetObject();
         // all responses must contain errorCode or/and data fields
-        if (!jsonObject.HasMember("errorCode") && !jsonObject.HasMember("data")) {
-            setRetCode(ServerApiRetCode::kIncorrectJson);
+        if (!handler.hasErrorCode() && !handler.hasData()) {
+            setIncorrectJson();
             return;
         }
 
         // manage the country override flag according to the documentation
         // https://gitlab.int.windscribe.com/ws/client/desktop/client-desktop-public/-/issues/354
-        if (!jsonObject.HasMember("info")) {
-            setRetCode(ServerApiRetCode::kIncorrectJson);
+        if (!handler.hasInfo()) {
+            setIncorrectJson();
             return;
         }
 
-        auto jsonInfo = jsonObject["info"].GetObject();
-
-        if (jsonInfo.HasMember("country_override")) {
+        if (handler.hasCountryOverride()) {
             if (isFromDisconnectedVPNState_ && (!connectState_.isVPNConnected())) {
-                auto countryOverride = jsonInfo["country_override"].GetString();
-                settings_.setCountryOverride(countryOverride);
-                spdlog::info("API request ServerLocations saved countryOverride = {}", countryOverride);
+                settings_.setCountryOverride(handler.countryOverride());
+                spdlog::info("API request ServerLocations saved countryOverride = {}", handler.countryOverride());
             }
         } else {
             if (isFromDisconnectedVPNState_ && (!connectState_.isVPNConnected())) {
@@ -93,10 +100,17 @@ void ServerLocationsRequest::handle(const std::string &arr)
             }
         }
     }
-    json_ = arr;
+    // the records are handed over instead of the json, no need to keep a copy of the payload
+    if (!records_)
+        json_ = arr;
 }
 
-
+void ServerLocationsRequest::setIncorrectJson()
+{
+    if (records_)
+        records_->clear();
+    setRetCode(ServerApiRetCode::kIncorrectJson);
+}
 
 } // namespace wsnet
 
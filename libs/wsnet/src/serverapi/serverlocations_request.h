@@ -5,6 +5,7 @@
 #include "baserequest.h"
 #include "serverapi_settings.h"
 #include "connectstate.h"
+#include "serverlocations.h"
 
 namespace wsnet {
 
@@ -16,7 +17,8 @@ class ServerLocationsRequest : public BaseRequest
 public:
     explicit ServerLocationsRequest(RequestPriority priority, const std::string &name,
                                     std::map<std::string, std::string> extraParams, ServerAPISettings &settings,
-                                    ConnectState &connectState, WSNetAdvancedParameters *advancedParameters, RequestFinishedCallback callback);
+                                    ConnectState &connectState, WSNetAdvancedParameters *advancedParameters,
+                                    std::shared_ptr<ServerLocations> records, const std::string &knownPayloadHash, RequestFinishedCallback callback);
     virtual ~ServerLocationsRequest() {};
 
     std::string url(const std::string &domain) const override;
@@ -28,6 +30,11 @@ private:
     mutable bool isFromDisconnectedVPNState_;
     ConnectState &connectState_;
     WSNetAdvancedParameters *advancedParameters_;
+    // if set, the payload is parsed into these records instead of being returned as json
+    std::shared_ptr<ServerLocations> records_;
+    std::string knownPayloadHash_;
+
+    void setIncorrectJson();
 };
 
 } // namespace wsnet
@@ -46,7 +46,8 @@ public:
             return false;
         }
 
-        httpNetworkManager_ = std::make_shared<HttpNetworkManager>(io_context_, dnsResolver_.get());
+        advancedParameters_ = std::make_shared<AdvancedParameters>();
+        httpNetworkManager_ = std::make_shared<HttpNetworkManager>(io_context_, dnsResolver_.get(), advancedParameters_.get());
         if (!httpNetworkManager_->init()) {
             spdlog::critical("Failed to initialize HttpNetworkManager");
             return false;
@@ -60,7 +61,6 @@ public:
         spdlog::info("App version: {}", appVersion);
 
         failoverContainer_ = std::make_unique<FailoverContainer>(httpNetworkManager_.get());
-        advancedParameters_ = std::make_shared<AdvancedParameters>();
         serverAPI_ = std::make_shared<ServerAPI>(io_context_, httpNetworkManager_.get(), failoverContainer_.get(), serverApiSettings, advancedParameters_.get(), connectState_);
         emergencyConnect_ = std::make_shared<EmergencyConnect>(io_context_, failoverContainer_.get(), dnsResolver_.get());
         pingManager_ = std::make_shared<PingManager>(io_context_, httpNetworkManager_.get());
@@ -75,8 +75,19 @@ public:
     }
     void setIsConnectedToVpnState(bool isConnected) override
     {
+        // the DNS servers change with the VPN tunnel
+        if (isConnected != connectState_.isVPNConnected() && httpNetworkManager_)
+            httpNetworkManager_->clearDnsCache();
         connectState_.setIsConnectedToVpnState(isConnected);
     }
+    void setCurrentNetwork(const std::string &networkId) override
+    {
+        std::lock_guard locker(currentNetworkMutex_);
+        // the cached DNS answers belong to the previous network
+        if (networkId != currentNetworkId_ && httpNetworkManager_)
+            httpNetworkManager_->clearDnsCache();
+        currentNetworkId_ = networkId;
+    }
 
     std::shared_ptr<WSNetDnsResolver> dnsResolver() override { return dnsResolver_; }
     std::shared_ptr<WSNetHttpNetworkManager> httpNetworkManager() override { return httpNetworkManager_; }
@@ -92,6 +103,8 @@ private:
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
 
     ConnectState connectState_;
+    std::mutex currentNetworkMutex_;
+    std::string currentNetworkId_;
     std::shared_ptr<DnsResolver_cares> dnsResolver_;
     std::shared_ptr<HttpNetworkManager> httpNetworkManager_;
     std::unique_ptr<FailoverContainer> failoverContainer_;